@@ -1687,6 +1687,10 @@ DeselectedEditorPanel::DeselectedEditorPanel(EditorControls &a_panel):
 		std::cout << "\nRecalculateLocalBounds: " << MV::Scene::Node::recalculateLocalBoundsCalls;
 		std::cout << "\nRecalculateChildBounds: " << MV::Scene::Node::recalculateChildBoundsCalls;
 		std::cout << "\nRecalculateMatrixBounds: " << MV::Scene::Node::recalculateMatrixCalls;
+		std::cout << "\nCulledNodeDraws: " << MV::Scene::Node::culledNodeDraws;
+		for (auto&& pool : MV::poolStatistics()) {
+			std::cout << "\nPool [" << pool.name << "] live: " << pool.live << " peak: " << pool.peak << " allocations: " << pool.allocations << " recycled: " << pool.recycled;
+		}
 		std::cout << "\n____\n";
 	});
 }
@@ -35,11 +35,13 @@ void GameInstance::rawScaleAroundScreenPoint(float a_scale, const MV::Point<int>
 	MV::info("CurrentScale: ", worldScene->scale());
 }
 
-GameInstance::GameInstance(const std::shared_ptr<MV::Scene::Node> &a_root, GameData& a_gameData, MV::TapDevice& a_mouse, float a_timeStep) :
+GameInstance::GameInstance(const std::shared_ptr<MV::Scene::Node> &a_root, GameData& a_gameData, MV::TapDevice& a_mouse, float a_timeStep, const SimulationSettings& a_simulation) :
 	worldScene(a_root->make("Scenes/map.scene", services())->depth(0)->cameraId(GameCameraId)),
 	ourMouse(a_mouse),
 	gameData(a_gameData),
-	timeStep(a_timeStep),
+	timeStep(a_simulation.deterministic ? DeterministicTimeStep : a_timeStep),
+	simulation(a_simulation),
+	simulationRandom(a_simulation.seed),
 	scriptEngine(a_gameData.managers().services) {
 }
 
@@ -51,6 +53,19 @@ void GameInstance::initialize(const std::shared_ptr<InGamePlayer> &a_leftPlayer,
 	worldScene->silence().forget()->pause();
 
 	pathMap = worldScene->get("PathMap")->component<MV::Scene::PathMap>();
+	if (deterministic()) {
+		//time sliced searches finish on different steps per machine, so search synchronously instead.
+		pathMap->pathCacheSize(PathCacheSize);
+		pathMap->grid()->fixedPoint(PathFixedPointSteps);
+	} else {
+		pathMap->pathBudget(PathSearchBudget)->pathCacheSize(PathCacheSize);
+	}
+	if (!pathScenarioFile.empty()) {
+		//before the teams initialize so the replay sees buildings placed at the start too.
+		pathScenarioRecorder = std::make_unique<MV::PathScenarioRecorder>(pathMap->grid(), "Scenes/map.scene", timeStep);
+	}
+	//creatures and effects are independent subtrees, their skeletons pose on the pool while the simulation stays serial.
+	gameObjectContainer()->updateWorkers(&gameData.managers().pool);
 
 	right->enemyWellPosition = path()->gridFromLocal(path()->owner()->localFromWorld(scene()->get(sideToString(LEFT) + "Goal")->worldFromLocal(MV::Point<>())));
 	left->enemyWellPosition = path()->gridFromLocal(path()->owner()->localFromWorld(scene()->get(sideToString(RIGHT) + "Goal")->worldFromLocal(MV::Point<>())));
@@ -80,14 +95,24 @@ void GameInstance::initialize(const std::shared_ptr<InGamePlayer> &a_leftPlayer,
 		return true;
 	}).recent()->interval(timeStep, 1);
 #else
-	worldTimestep.then("update", [&](MV::Task& /*a_self*/, double a_dt) {
-		fixedUpdate(a_dt);
-		return true;
-	});
+	if (deterministic()) {
+		worldTimestep.then("update", [&](MV::Task& /*a_self*/, double a_dt) {
+			fixedUpdate(a_dt);
+			return true;
+		}).recent()->interval(timeStep, 1);
+	} else {
+		worldTimestep.then("update", [&](MV::Task& /*a_self*/, double a_dt) {
+			fixedUpdate(a_dt);
+			return true;
+		});
+	}
 #endif
 }
 
 GameInstance::~GameInstance() {
+	if (pathScenarioRecorder && !pathScenarioRecorder->save(pathScenarioFile)) {
+		MV::error("Failed to write path scenario [", pathScenarioFile, "]");
+	}
 	worldScene->removeFromParent();
 }
 
@@ -106,6 +131,9 @@ void GameInstance::beginMapDrag() {
 void GameInstance::fixedUpdate(double a_dt) {
 	worldScene->update(static_cast<float>(a_dt), true);
 	fixedUpdateImplementation(a_dt);
+	if (pathScenarioRecorder) {
+		pathScenarioRecorder->step();
+	}
 }
 
 bool GameInstance::update(double a_dt) {
@@ -172,8 +200,8 @@ bool GameInstance::requestCamera() {
 	return false;
 }
 
-ClientGameInstance::ClientGameInstance(Game& a_game) :
-	GameInstance(a_game.root(), a_game.data(), a_game.mouse(), 1.0f / 60.0f),
+ClientGameInstance::ClientGameInstance(Game& a_game, const SimulationSettings& a_simulation) :
+	GameInstance(a_game.root(), a_game.data(), a_game.mouse(), 1.0f / 60.0f, a_simulation),
 	game(a_game) {
 
 	synchronizedObjects.onSpawn<BuildingNetworkState>([this](std::shared_ptr<MV::NetworkObject<BuildingNetworkState>> a_newItem) {
@@ -228,8 +256,12 @@ bool ClientGameInstance::canUpgradeBuildingFor(const std::shared_ptr<InGamePlaye
 
 #ifdef BINDSTONE_SERVER
 ServerGameInstance::ServerGameInstance(GameServer& a_game) :
-	GameInstance(a_game.root(), a_game.data(), a_game.mouse(), 1.0f / 10.0f),
+	GameInstance(a_game.root(), a_game.data(), a_game.mouse(), 1.0f / 10.0f, SimulationSettings{ a_game.data().constants().deterministicSimulation, static_cast<uint64_t>(MV::randomInteger(0, std::numeric_limits<int64_t>::max())) }),
 	gameServer(a_game){
+	if (!a_game.pathScenarios().empty()) {
+		pathScenarioFile = a_game.pathScenarios() + "/" + MV::guid("pathScenario_") + ".json";
+	}
+
 	synchronizedObjects.onSpawn<CreatureNetworkState>([this](std::shared_ptr<MV::NetworkObject<CreatureNetworkState>> a_newItem) {
 		a_newItem->self()->netId = a_newItem->id();
 	});
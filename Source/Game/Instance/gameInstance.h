@@ -10,6 +10,7 @@
 #include "Game/NetworkLayer/gameServer.h"
 
 #include "Game/Instance/team.h"
+#include "MV/ArtificialIntelligence/pathScenario.h"
 
 class Missile;
 class GameInstance {
@@ -20,10 +21,17 @@ class GameInstance {
 	GameInstance& operator=(const GameInstance &) = delete;
 protected:
 	virtual void initialize(const std::shared_ptr<InGamePlayer> &a_leftPlayer, const std::shared_ptr<InGamePlayer> &a_rightPlayer);
-	GameInstance(const std::shared_ptr<MV::Scene::Node> &a_root, GameData& a_gameData, MV::TapDevice& a_mouse, float a_timeStep);
+	GameInstance(const std::shared_ptr<MV::Scene::Node> &a_root, GameData& a_gameData, MV::TapDevice& a_mouse, float a_timeStep, const SimulationSettings& a_simulation = SimulationSettings());
 
 public:
 	static const int GameCameraId = 1;
+	//milliseconds per world step creatures may spend searching for paths. Unused time is lost, searches cut off by it resume next step.
+	static constexpr double PathSearchBudget = 2.0;
+	//Creatures share lanes, so most searches retrace a recent path.
+	static constexpr size_t PathCacheSize = 64;
+	//Deterministic games step at this fixed rate and snap agents to 1/PathFixedPointSteps of a cell.
+	static constexpr float DeterministicTimeStep = 1.0f / 20.0f;
+	static constexpr int PathFixedPointSteps = 256;
 
 	~GameInstance();
 
@@ -124,6 +132,19 @@ public:
 		buildings.push_back(a_building);
 	}
 
+	//Gameplay randomness must come from here rather than MV::randomNumber so seeded games replay identically.
+	MV::DeterministicRandom& random() {
+		return simulationRandom;
+	}
+
+	bool deterministic() const {
+		return simulation.deterministic;
+	}
+
+	const SimulationSettings& simulationSettings() const {
+		return simulation;
+	}
+
 protected:
 
 	virtual void fixedUpdateImplementation(double /*a_dt*/) {}
@@ -146,6 +167,9 @@ protected:
 	std::shared_ptr<MV::Scene::Node> worldScene;
 
 	MV::Scene::SafeComponent<MV::Scene::PathMap> pathMap;
+	//set before initialize to record the match for the PathfindingBenchmark, written out when the match ends.
+	std::string pathScenarioFile;
+	std::unique_ptr<MV::PathScenarioRecorder> pathScenarioRecorder;
 
 	MV::Script scriptEngine;
 
@@ -161,6 +185,9 @@ protected:
 
 	float timeStep = 0.0f;
 
+	SimulationSettings simulation;
+	MV::DeterministicRandom simulationRandom;
+
 	bool hasActiveTouch = false;
 
 	const MV::PointPrecision maxScaleHard = 3.5f;
@@ -174,10 +201,10 @@ protected:
 
 class ClientGameInstance : public GameInstance {
 	friend MV::Script;
-	ClientGameInstance(Game& a_game);
+	ClientGameInstance(Game& a_game, const SimulationSettings& a_simulation);
 public:
-	static std::unique_ptr<ClientGameInstance> make(const std::shared_ptr<InGamePlayer> &a_leftPlayer, const std::shared_ptr<InGamePlayer> &a_rightPlayer, const std::vector<BindstoneNetworkObjectPool::VariantType>& a_poolObjects, Game& a_game) {
-		auto result = std::unique_ptr<ClientGameInstance>(new ClientGameInstance(a_game));
+	static std::unique_ptr<ClientGameInstance> make(const std::shared_ptr<InGamePlayer> &a_leftPlayer, const std::shared_ptr<InGamePlayer> &a_rightPlayer, const std::vector<BindstoneNetworkObjectPool::VariantType>& a_poolObjects, const SimulationSettings& a_simulation, Game& a_game) {
+		auto result = std::unique_ptr<ClientGameInstance>(new ClientGameInstance(a_game, a_simulation));
 		result->initialize(a_leftPlayer, a_rightPlayer);
 		result->networkPool().synchronize(a_poolObjects);
 		return result;
@@ -140,6 +140,15 @@ public:
 		return right->player;
 	}
 
+	//Each match writes its path changes and creature spawns into a_directory for the PathfindingBenchmark to replay, empty stops recording.
+	void recordPathScenarios(const std::string &a_directory) {
+		pathScenarioDirectory = a_directory;
+	}
+
+	const std::string& pathScenarios() const {
+		return pathScenarioDirectory;
+	}
+
 private:
 	GameServer(const GameServer &) = delete;
 
@@ -195,6 +204,7 @@ private:
 	std::optional<AssignedPlayer> left;
 	std::optional<AssignedPlayer> right;
 	std::string queueId;
+	std::string pathScenarioDirectory;
 
 	MV::Task rootTask;
 };
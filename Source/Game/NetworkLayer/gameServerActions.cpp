@@ -37,7 +37,7 @@ void GetInitialGameState::execute(GameUserConnectionState* a_connection, GameSer
 	a_connection->authenticate(player, secret);
 	if (a_game.allUsersConnected()) {
 		a_game.lobby()->send(makeNetworkString<GameServerStateChange>(GameServerStateChange::OCCUPIED));
-		a_game.server()->sendAll(makeNetworkString<SuppliedInitialGameState>(a_game.leftPlayer(), a_game.rightPlayer(), a_game.instance()->networkPool()));
+		a_game.server()->sendAll(makeNetworkString<SuppliedInitialGameState>(a_game.leftPlayer(), a_game.rightPlayer(), a_game.instance()->networkPool(), a_game.instance()->simulationSettings()));
 	}
 }
 
@@ -56,5 +56,5 @@ void RequestFullGameState::execute(Game &a_game) {
 }
 
 void SuppliedInitialGameState::execute(Game& a_game) {
-	a_game.enterGame(left, right, pool);
+	a_game.enterGame(left, right, pool, simulation);
 }
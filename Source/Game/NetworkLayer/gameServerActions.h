@@ -3,6 +3,7 @@
 
 #include "Game/Instance/team.h"
 #include "Game/NetworkLayer/synchronizeAction.h"
+#include "Game/state.h"
 
 class GameServerAvailable : public NetworkAction {
 public:
@@ -111,23 +112,25 @@ private:
 class SuppliedInitialGameState : public NetworkAction {
 public:
 	SuppliedInitialGameState() {}
-	SuppliedInitialGameState(const std::shared_ptr<InGamePlayer> &a_left, const std::shared_ptr<InGamePlayer> &a_right, const BindstoneNetworkObjectPool &a_pool) : 
+	SuppliedInitialGameState(const std::shared_ptr<InGamePlayer> &a_left, const std::shared_ptr<InGamePlayer> &a_right, const BindstoneNetworkObjectPool &a_pool, const SimulationSettings &a_simulation) : 
 		left(a_left), 
 		right(a_right), 
-		pool(a_pool.all()) {
+		pool(a_pool.all()),
+		simulation(a_simulation) {
 	}
 	
 	virtual void execute(Game& a_connection) override;
 
 	template <class Archive>
 	void serialize(Archive & archive, std::uint32_t const /*version*/) {
-		archive(CEREAL_NVP(left), CEREAL_NVP(right), CEREAL_NVP(pool), cereal::make_nvp("NetworkAction", cereal::base_class<NetworkAction>(this)));
+		archive(CEREAL_NVP(left), CEREAL_NVP(right), CEREAL_NVP(pool), CEREAL_NVP(simulation), cereal::make_nvp("NetworkAction", cereal::base_class<NetworkAction>(this)));
 	}
 
 private:
 	std::shared_ptr<InGamePlayer> left;
 	std::shared_ptr<InGamePlayer> right;
 	std::vector<BindstoneNetworkObjectPool::VariantType> pool;
+	SimulationSettings simulation;
 };
 
 class RequestBuildingUpgrade : public NetworkAction {
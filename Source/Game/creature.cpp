@@ -46,8 +46,11 @@ void ServerCreature::initialize() {
 	spineAnimator = newNode->componentInChildren<MV::Scene::Spine>().get();
 	spineAnimator->animate("run");
 	
+	//creatures share lanes, so they crowd past each other instead of blocking cells and repathing around one another.
+	//Path searches no longer see them, anything placed onto the map should check Map::placeable.
 	pathAgent = owner()->attach<MV::Scene::PathAgent>(gameInstance.path().self(), gameInstance.path()->gridFromLocal(gameInstance.path()->owner()->localFromWorld(owner()->worldPosition())), 3)->
-		gridSpeed(statTemplate.moveSpeed);
+		gridSpeed(statTemplate.moveSpeed)->
+		steering(true);
 
 	pathAgent->onStart.connect("_PARENT", [&](std::shared_ptr<MV::Scene::PathAgent>) {
 		onStartSignal(std::static_pointer_cast<ServerCreature>(shared_from_this()));
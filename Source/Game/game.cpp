@@ -80,7 +80,7 @@ void Game::initializeWindow(){
 	//MV::AudioPlayer::instance()->initAudio();
 	ourMouse.update();
 
-	rootScene = MV::Scene::Node::make(gameData.managers().renderer);
+	rootScene = MV::Scene::Node::make(gameData.managers().renderer)->deferChanges(true)->flattenTransforms(true);
 
 	uiRoot = rootScene->make("UI")->cameraId(1);
 	screenScaler = rootScene->attach<MV::Scene::Sprite>();
@@ -175,14 +175,18 @@ void Game::handleInput() {
 }
 
 void Game::render() {
+	gameData.managers().textures.uploadStreamed();
 	gameData.managers().renderer.clearScreen();
 	updateScreenScaler();
+	//deferred scene notifications go out once here, so layout settles before anything draws.
+	rootScene->flushChanges();
 	if (ourInstance) {
 		ourInstance->scene()->draw();
 	}
 	rootScene->draw();
 	
 	gameData.managers().renderer.updateScreen();
+	gameData.managers().textures.trim();
 }
 
 void Game::updateScreenScaler() {
@@ -66,8 +66,8 @@ public:
 		});
 	}
 
-	GameInstance* enterGame(const std::shared_ptr<InGamePlayer> &a_left, const std::shared_ptr<InGamePlayer> &a_right, const std::vector<BindstoneNetworkObjectPool::VariantType> &a_poolObjects) {
-		ourInstance = ClientGameInstance::make(a_left, a_right, a_poolObjects, *this);
+	GameInstance* enterGame(const std::shared_ptr<InGamePlayer> &a_left, const std::shared_ptr<InGamePlayer> &a_right, const std::vector<BindstoneNetworkObjectPool::VariantType> &a_poolObjects, const SimulationSettings &a_simulation = SimulationSettings()) {
+		ourInstance = ClientGameInstance::make(a_left, a_right, a_poolObjects, a_simulation, *this);
 		gui().page("Main").hide();
 		return ourInstance.get();
 	}
@@ -442,6 +442,13 @@ MV::Script::Registrar<GameInstance> _hookGameInstance([](chaiscript::ChaiScript&
 
 	a_script.add(chaiscript::fun(&GameInstance::creature), "creature");
 	a_script.add(chaiscript::fun(&GameInstance::spawnCreature), "spawnCreature");
+	a_script.add(chaiscript::fun(&GameInstance::deterministic), "deterministic");
+	a_script.add(chaiscript::fun([](GameInstance& a_self, float a_min, float a_max) {
+		return a_self.random().number(a_min, a_max);
+	}), "randomNumber");
+	a_script.add(chaiscript::fun([](GameInstance& a_self, int a_min, int a_max) {
+		return static_cast<int>(a_self.random().integer(a_min, a_max));
+	}), "randomInteger");
 });
 
 #ifdef BINDSTONE_SERVER
@@ -490,6 +497,9 @@ MV::Script::Registrar<Constants> _hookConstants([](chaiscript::ChaiScript& a_scr
 	a_script.add(chaiscript::fun([](Constants& a_self) {
 		return a_self.startHealth;
 	}), "startHealth");
+	a_script.add(chaiscript::fun([](Constants& a_self) {
+		return a_self.deterministicSimulation;
+	}), "deterministicSimulation");
 });
 
 template<>
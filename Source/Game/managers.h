@@ -30,9 +30,16 @@ struct Managers {
 		services.connect(&textLibrary);
 		services.connect(&textures);
 		services.connect(&defaultLogin);
+		textures.stream(&pool);
+#if defined(TARGET_OS_IPHONE) || defined(__ANDROID__)
+		textures.residencyBudget(MobileTextureBudget);
+#endif
 		//services.connect(&audio);
 	}
 
+	//bytes of file and surface textures kept resident on low memory devices.
+	static constexpr size_t MobileTextureBudget = 96 * 1024 * 1024;
+
 	MV::Stopwatch timer;
 	MV::ThreadPool pool;
 	MV::Draw2D renderer;
@@ -13,6 +13,19 @@ struct InGamePlayer;
 
 struct Constants {
 	int startHealth = 20;
+	//Reproducible stepping: a fixed timestep, seeded random and fixed-point agent positions, so a match replays identically
+	//from its seed. Clients still follow the server's snapshots, there is no input lockstep. Set by the game server's -deterministic.
+	bool deterministicSimulation = false;
+};
+
+struct SimulationSettings {
+	bool deterministic = false;
+	uint64_t seed = 0;
+
+	template <class Archive>
+	void serialize(Archive & archive, std::uint32_t const /*version*/) {
+		archive(CEREAL_NVP(deterministic), CEREAL_NVP(seed));
+	}
 };
 
 class GameData {
@@ -0,0 +1,37 @@
+#include "pathScenario.h"
+#include "MV/Serialization/serialize.h"
+
+namespace MV {
+
+	PathScenarioRecorder::PathScenarioRecorder(const std::shared_ptr<Map> &a_map, const std::string &a_scene, double a_timeStep) {
+		scenario.scene = a_scene;
+		scenario.timeStep = a_timeStep;
+		scenario.ticks = 0;
+		staticBlockReceiver = a_map->onStaticBlock.connect([&](std::shared_ptr<Map>, const Point<int> &a_position) {
+			record(PathScenarioEvent::BLOCK, a_position);
+		});
+		staticUnblockReceiver = a_map->onStaticUnblock.connect([&](std::shared_ptr<Map>, const Point<int> &a_position) {
+			record(PathScenarioEvent::UNBLOCK, a_position);
+		});
+		agentStartReceiver = a_map->onAgentStart.connect([&](std::shared_ptr<NavigationAgent> a_agent) {
+			if (spawned.insert(a_agent).second) {
+				record(PathScenarioEvent::SPAWN, cast<int>(a_agent->position()), cast<int>(a_agent->goal()), a_agent->size());
+			}
+		});
+	}
+
+	bool PathScenarioRecorder::save(const std::string &a_path) const {
+		return writeToFile(a_path, toJson(scenario));
+	}
+
+	void PathScenarioRecorder::record(PathScenarioEvent::Type a_type, const Point<int> &a_position, const Point<int> &a_goal, int a_size) {
+		PathScenarioEvent event;
+		event.tick = scenario.ticks;
+		event.type = a_type;
+		event.position = a_position;
+		event.goal = a_goal;
+		event.size = a_size;
+		scenario.events.push_back(event);
+	}
+
+}
@@ -0,0 +1,72 @@
+#ifndef _MV_PATH_SCENARIO_H_
+#define _MV_PATH_SCENARIO_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "MV/ArtificialIntelligence/pathfinding.h"
+
+namespace MV {
+
+	//One change to replay against a Map: an agent setting off for a goal, or a square of cells becoming statically blocked or unblocked.
+	struct PathScenarioEvent {
+		enum Type { SPAWN, BLOCK, UNBLOCK };
+
+		int tick = 0;
+		Type type = SPAWN;
+		Point<int> position;
+		Point<int> goal;
+		//Agent footprint for spawns, width and height of the blocked square otherwise.
+		int size = 1;
+
+		template <class Archive>
+		void serialize(Archive & archive, std::uint32_t const /*version*/) {
+			archive(CEREAL_NVP(tick), CEREAL_NVP(type), CEREAL_NVP(position), CEREAL_NVP(goal), CEREAL_NVP(size));
+		}
+	};
+
+	//Events sorted by tick, replayed against the PathMap in scene.
+	struct PathScenario {
+		std::string scene = "Scenes/map.scene";
+		double timeStep = 1.0 / 30.0;
+		int ticks = 3000;
+		std::vector<PathScenarioEvent> events;
+
+		template <class Archive>
+		void serialize(Archive & archive, std::uint32_t const /*version*/) {
+			archive(CEREAL_NVP(scene), CEREAL_NVP(timeStep), CEREAL_NVP(ticks), CEREAL_NVP(events));
+		}
+	};
+
+	//Writes what happens to a live Map as a PathScenario so real matches can be replayed by the PathfindingBenchmark.
+	//Static blocking is recorded cell by cell, agents once when they first set off (later goal changes are not replayed).
+	class PathScenarioRecorder {
+	public:
+		PathScenarioRecorder(const std::shared_ptr<Map> &a_map, const std::string &a_scene, double a_timeStep);
+
+		//Call once per simulation step, events are stamped with the number of steps taken so far.
+		void step() {
+			++scenario.ticks;
+		}
+
+		const PathScenario& recorded() const {
+			return scenario;
+		}
+
+		bool save(const std::string &a_path) const;
+
+	private:
+		void record(PathScenarioEvent::Type a_type, const Point<int> &a_position, const Point<int> &a_goal = Point<int>(), int a_size = 1);
+
+		PathScenario scenario;
+
+		Map::SharedReceiverType staticBlockReceiver;
+		Map::SharedReceiverType staticUnblockReceiver;
+		Map::AgentSharedReceiverType agentStartReceiver;
+		std::set<std::weak_ptr<NavigationAgent>, std::owner_less<std::weak_ptr<NavigationAgent>>> spawned;
+	};
+
+}
+
+#endif
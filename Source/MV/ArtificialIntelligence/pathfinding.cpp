@@ -1,4 +1,5 @@
 #include "pathfinding.h"
+#include "MV/Utility/threadPool.hpp"
 #include "cereal/archives/json.hpp"
 
 namespace MV {
@@ -71,6 +72,7 @@ namespace MV {
 		auto oldCost = travelCost;
 		travelCost = a_newCost;
 		if (oldCost != travelCost) {
+			++map->ourRevision;
 			auto mapShared = map->shared_from_this();
 			onCostChangeSignal(mapShared, location);
 		}
@@ -81,6 +83,7 @@ namespace MV {
 		++staticBlockedSemaphore;
 		auto mapShared = map->shared_from_this();
 		if (staticBlockedSemaphore == 1) {
+			++map->ourRevision;
 			onStaticBlockSignal(mapShared, location);
 		}
 		if (!wasBlocked) {
@@ -95,6 +98,7 @@ namespace MV {
 		--staticBlockedSemaphore;
 		auto mapShared = map->shared_from_this();
 		if (staticBlockedSemaphore == 0) {
+			++map->ourRevision;
 			onStaticUnblockSignal(mapShared, location);
 		}
 		if (!blocked()) {
@@ -290,6 +294,74 @@ namespace MV {
 		}
 
 		hookUpObservation();
+		++ourRevision;
+		if (requestQueue) {
+			requestQueue->restartSearches();
+		}
+		if (cache) {
+			cache->clear();
+		}
+	}
+
+	Map::~Map() {
+	}
+
+	std::shared_ptr<Map> Map::snapshot() const {
+		auto result = Map::make(size(), usingCorners);
+		refreshSnapshot(*result);
+		result->initializeCells();
+		return result;
+	}
+
+	void Map::initializeCells() const {
+		for (auto&& column : squares) {
+			for (auto&& square : column) {
+				square.clearance();
+			}
+		}
+	}
+
+	void Map::refreshSnapshot(Map &a_snapshot) const {
+		require<ResourceException>(a_snapshot.size() == size(), "Map::refreshSnapshot requires a snapshot of the same size.");
+		for (size_t x = 0; x < squares.size(); ++x) {
+			for (size_t y = 0; y < squares[x].size(); ++y) {
+				auto& source = squares[x][y];
+				auto& target = a_snapshot.squares[x][y];
+				if (source.blocked() && !target.blocked()) {
+					target.block();
+				} else if (!source.blocked() && target.blocked()) {
+					target.unblock();
+				}
+				if (target.baseCost() != source.totalCost()) {
+					target.baseCost(source.totalCost());
+				}
+			}
+		}
+	}
+
+	PathRequestQueue& Map::requests() {
+		if (!requestQueue) {
+			requestQueue = std::make_unique<PathRequestQueue>(*this);
+		}
+		return *requestQueue;
+	}
+
+	PathCache& Map::pathCache() {
+		if (!cache) {
+			cache = std::make_unique<PathCache>(*this);
+		}
+		return *cache;
+	}
+
+	Crowd& Map::crowd() {
+		if (!ourCrowd) {
+			ourCrowd = std::make_unique<Crowd>(*this);
+		}
+		return *ourCrowd;
+	}
+
+	bool Map::placeable(const Point<int> &a_topLeft, int a_size) {
+		return clearedForSize(a_topLeft, a_size) && (!ourCrowd || !ourCrowd->occupied(a_topLeft, a_size));
 	}
 
 	std::shared_ptr<Map> Map::clone() const {
@@ -306,6 +378,7 @@ namespace MV {
 		onStaticUnblock(onStaticUnblockSignal),
 		onCostChange(onCostChangeSignal),
 		onClearanceChange(onClearanceChangeSignal),
+		onAgentStart(onAgentStartSignal),
 		usingCorners(true) {
 	}
 
@@ -316,6 +389,7 @@ namespace MV {
 		onStaticUnblock(onStaticUnblockSignal),
 		onCostChange(onCostChangeSignal),
 		onClearanceChange(onClearanceChangeSignal),
+		onAgentStart(onAgentStartSignal),
 		usingCorners(a_useCorners) {
 
 		squares.reserve(a_size.width);
@@ -358,17 +432,22 @@ namespace MV {
 	}
 
 	void Path::calculate() {
-		open.clear();
-		closed.clear();
+		beginSearch();
+		calculate(std::chrono::high_resolution_clock::time_point::max());
+	}
 
-		insertIntoOpen(startPosition, 0.0f);
-		found = false;
-		PathCalculationNode* currentNode = nullptr;
-		PathCalculationNode* bestNode = nullptr;
-		PointPrecision bestDistance = -1;
-		int64_t totalSearched = 0;
+	bool Path::calculate(const std::chrono::high_resolution_clock::time_point &a_deadline) {
+		if (!searchStarted) {
+			beginSearch();
+		}
+		int64_t searchedThisCall = 0;
+		while (!searchFinished && !open.empty() && (maxSearchNodes <= 0 || totalSearched < maxSearchNodes)) {
+			if (searchedThisCall > 0 && (searchedThisCall % NODES_PER_DEADLINE_CHECK) == 0 && std::chrono::high_resolution_clock::now() >= a_deadline) {
+				return false;
+			}
+			++searchedThisCall;
+			++totalSearched;
 
-		while (!open.empty() && ((maxSearchNodes > 0 && totalSearched++ < maxSearchNodes) || maxSearchNodes <= 0)) {
 			closed.push_back(open.back());
 			currentNode = &closed.back();
 			open.pop_back();
@@ -391,9 +470,31 @@ namespace MV {
 					}
 				}
 			}
+		}
 
+		if (!searchFinished) {
+			finishSearch();
 		}
+		return true;
+	}
 
+	void Path::beginSearch() {
+		open.clear();
+		closed.clear();
+
+		found = false;
+		searchStarted = true;
+		searchFinished = false;
+		totalSearched = 0;
+		currentNode = nullptr;
+		bestNode = nullptr;
+		bestDistance = -1;
+
+		insertIntoOpen(startPosition, 0.0f);
+	}
+
+	void Path::finishSearch() {
+		searchFinished = true;
 		if (!found) {
 			currentNode = (bestNode == nullptr || (distance(goalPosition, startPosition) < distance(goalPosition, bestNode->position()))) ? nullptr : bestNode;
 		}
@@ -406,6 +507,10 @@ namespace MV {
 			currentNode = currentNode->parent();
 		}
 		std::reverse(pathNodes.begin(), pathNodes.end());
+
+		open.clear();
+		closed.clear();
+		bestNode = nullptr;
 	}
 
 	void Path::insertIntoOpen(const Point<int> &a_position, float a_startCost, PathCalculationNode* a_parent /*= nullptr*/, bool a_isCorner /*= false*/) {
@@ -431,6 +536,69 @@ namespace MV {
 		return false;
 	}
 
+	NavigationAgent::~NavigationAgent() {
+		cancelPendingRequest();
+		unblockMap();
+		if (crowdSteering) {
+			map->crowd().remove(this);
+		}
+	}
+
+	std::shared_ptr<NavigationAgent> NavigationAgent::steering(bool a_enabled) {
+		auto self = shared_from_this();
+		if (a_enabled != crowdSteering) {
+			if (a_enabled) {
+				unblockMap();
+				crowdSteering = true;
+				map->crowd().add(this);
+			} else {
+				map->crowd().remove(this);
+				crowdSteering = false;
+				blockMap();
+			}
+			markDirty();
+		}
+		return self;
+	}
+
+	PointPrecision NavigationAgent::applySteering(const Point<PointPrecision> &a_direction, PointPrecision a_step) {
+		auto offset = map->crowd().steer(this, a_direction, a_step);
+		if (offset.x == 0.0f && offset.y == 0.0f) {
+			return 0.0f;
+		}
+		//never get pushed into static obstacles or agents that still hold a footprint.
+		auto steeredPosition = ourPosition + offset;
+		if (map->clearedForSize(cast<int>(steeredPosition - centerOffset), unitSize)) {
+			ourPosition = steeredPosition;
+			return offset.magnitude();
+		}
+		return 0.0f;
+	}
+
+	void NavigationAgent::snapToFixedPoint() {
+		auto snapped = map->snapToFixedPoint(ourPosition);
+		if (snapped != ourPosition) {
+			unblockMap();
+			ourPosition = snapped;
+			blockMap();
+		}
+	}
+
+	void NavigationAgent::updateCrowdPosition() {
+		if (crowdSteering) {
+			map->crowd().moved(this);
+		}
+	}
+
+	void NavigationAgent::markDirty() {
+		costs.clear();
+		receivers.clear();
+		dirtyPath = true;
+		if (pendingRequest) {
+			pendingRequest->invalidate();
+		}
+	}
+
 	void NavigationAgent::update(double a_dt) {
 		if (waitingForPlacement) {
 			if (canPlaceOnMapAtCurrentPosition()) {
@@ -451,6 +619,11 @@ namespace MV {
 					++currentPathIndex;
 				}
 			}
+			if (crowdSteering) {
+				//being pushed aside spends part of this step, so crowded agents never outpace ourSpeed.
+				auto travelDirection = (desiredPositionFromCalculatedPathIndex(currentPathIndex) - ourPosition).normalized();
+				totalDistanceToTravel -= applySteering(travelDirection, totalDistanceToTravel);
+			}
 			while (pathfinding() && totalDistanceToTravel > 0.0f) {
 				auto previousGridSquare = cast<int>(ourPosition);
 				auto desiredPosition = desiredPositionFromCalculatedPathIndex(currentPathIndex);
@@ -470,6 +643,9 @@ namespace MV {
 				updateObservedNodes();
 			}
 
+			snapToFixedPoint();
+			updateCrowdPosition();
+
 			if (!pathfinding()) {
 				receivers.clear();
 				auto self = shared_from_this();
@@ -487,7 +663,14 @@ namespace MV {
 
 	bool NavigationAgent::attemptToRecalculate() {
 		if (dirtyPath || calculatedPath.empty() || (calculatedPath.size() > 1 && currentPathIndex == calculatedPath.size())) {
-			recalculate();
+			if (map->requests().asynchronous()) {
+				requestRecalculate();
+			} else {
+				recalculate();
+			}
+		}
+		if (pendingRequest) {
+			return canFollowStalePath();
 		}
 		if (calculatedPath.size() == 1 && calculatedPath[0].position() != cast<int>(ourGoal)) {
 			markDirty();
@@ -543,4 +726,455 @@ namespace MV {
 		}
 	}
 
+	void NavigationAgent::requestRecalculate() {
+		dirtyPath = true;
+		if (!pendingRequest) {
+			if (applyCachedPath()) {
+				return;
+			}
+			auto boostForIdleAgents = calculatedPath.empty() ? 1 : 0;
+			pendingRequest = map->requests().request(shared_from_this(), requestPriority + boostForIdleAgents);
+		}
+	}
+
+	void NavigationAgent::cancelPendingRequest() {
+		if (pendingRequest) {
+			pendingRequest->cancel();
+			pendingRequest.reset();
+		}
+	}
+
+	bool NavigationAgent::canFollowStalePath() {
+		if (calculatedPath.empty() || currentPathIndex >= calculatedPath.size()) {
+			return false;
+		}
+		auto nextIndex = std::min(currentPathIndex + 1, calculatedPath.size() - 1);
+		unblockMap();
+		bool clear = map->clearedForSize(calculatedPath[currentPathIndex].position(), unitSize) && map->clearedForSize(calculatedPath[nextIndex].position(), unitSize);
+		blockMap();
+		return clear;
+	}
+
+	void NavigationAgent::receivePath(const std::shared_ptr<PathRequest> &a_request) {
+		if (pendingRequest != a_request) {
+			return;
+		}
+		pendingRequest.reset();
+		ourPath = a_request->search;
+		applyCalculatedPath(ourPath->result());
+		storeCalculatedPath();
+	}
+
+	void NavigationAgent::applyCalculatedPath(const std::vector<PathNode> &a_path) {
+		receivers.clear();
+		costs.clear();
+		calculatedPath = a_path;
+
+		//we may have kept moving while the search ran, so resume from wherever we are along the new path.
+		auto ourCell = cast<int>(ourPosition);
+		auto foundCell = std::find_if(calculatedPath.begin(), calculatedPath.end(), [&](const PathNode &a_node) {
+			return a_node.position() == ourCell;
+		});
+		currentPathIndex = foundCell != calculatedPath.end() ? static_cast<size_t>(std::distance(calculatedPath.begin(), foundCell)) + 1 : 0;
+		updateObservedNodes();
+		dirtyPath = false;
+	}
+
+	bool NavigationAgent::applyCachedPath() {
+		auto& cache = map->pathCache();
+		if (!cache.enabled()) {
+			return false;
+		}
+		std::vector<PathNode> cachedPath;
+		unblockMap();
+		bool found = cache.find(cast<int>(ourPosition), cast<int>(ourGoal), unitSize, acceptableDistance, cachedPath);
+		blockMap();
+		if (found) {
+			ourPath.reset();
+			applyCalculatedPath(cachedPath);
+		}
+		return found;
+	}
+
+	void NavigationAgent::storeCalculatedPath() {
+		if (ourPath && ourPath->complete()) {
+			map->pathCache().store(ourPath->start(), ourPath->goal(), unitSize, acceptableDistance, ourPath->result());
+		}
+	}
+
+	std::shared_ptr<PathRequest> PathRequestQueue::request(const std::shared_ptr<NavigationAgent> &a_agent, int a_priority) {
+		auto result = std::make_shared<PathRequest>(a_agent, a_priority, nextSequence++);
+		insertSorted(pending, result);
+		return result;
+	}
+
+	void PathRequestQueue::restartSearches() {
+		for (auto&& request : pending) {
+			request->invalidate();
+		}
+		for (auto&& request : dispatched) {
+			request->invalidate();
+		}
+	}
+
+	void PathRequestQueue::update() {
+		deliverWorkerResults();
+		if (pending.empty()) {
+			return;
+		}
+		if (pool) {
+			if (dispatched.empty()) {
+				dispatchToWorkers();
+			}
+		} else {
+			updateTimeSliced();
+		}
+	}
+
+	void PathRequestQueue::updateTimeSliced() {
+		auto deadline = std::chrono::high_resolution_clock::now() + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::duration<double, std::milli>(millisecondBudget));
+		while (!pending.empty()) {
+			auto request = pending.back();
+			auto agent = request->agent.lock();
+			if (!agent || request->cancelled()) {
+				pending.pop_back();
+				continue;
+			}
+			if (!request->search || request->restart) {
+				request->search = agent->makePath(agent->map);
+				request->restart = false;
+			}
+
+			//agents search from inside their own footprint, same as a synchronous recalculate.
+			agent->unblockMap();
+			bool done = request->search->calculate(deadline);
+			agent->blockMap();
+
+			if (!done) {
+				return;
+			}
+			pending.pop_back();
+			agent->receivePath(request);
+			if (std::chrono::high_resolution_clock::now() >= deadline) {
+				return;
+			}
+		}
+	}
+
+	void PathRequestQueue::dispatchToWorkers() {
+		std::vector<std::shared_ptr<NavigationAgent>> agents;
+		std::vector<std::shared_ptr<PathRequest>> requests;
+		for (auto&& request : pending) {
+			if (auto agent = request->agent.lock()) {
+				if (!request->cancelled()) {
+					agents.push_back(agent);
+					requests.push_back(request);
+				}
+			}
+		}
+		pending.clear();
+		if (requests.empty()) {
+			return;
+		}
+
+		//requesting agents are lifted off the snapshot so they do not block their own starting cells.
+		for (auto&& agent : agents) {
+			agent->unblockMap();
+		}
+		if (!snapshot || snapshot->size() != map.size() || snapshot->corners() != map.corners()) {
+			//searches no longer touch the live map, so it has to be initialized up front to keep its clearance in step.
+			map.initializeCells();
+			snapshot = map.snapshot();
+		} else {
+			map.refreshSnapshot(*snapshot);
+		}
+		for (auto&& agent : agents) {
+			agent->blockMap();
+		}
+
+		outstanding = std::make_shared<std::atomic<size_t>>(requests.size());
+		for (size_t i = 0; i < requests.size(); ++i) {
+			requests[i]->search = agents[i]->makePath(snapshot);
+			requests[i]->restart = false;
+			auto search = requests[i]->search;
+			auto remaining = outstanding;
+			pool->task([search, remaining]() {
+				SCOPE_EXIT{ --(*remaining); };
+				search->calculate(std::chrono::high_resolution_clock::time_point::max());
+			});
+		}
+		dispatched = std::move(requests);
+	}
+
+	void PathRequestQueue::deliverWorkerResults() {
+		if (dispatched.empty() || (outstanding && *outstanding > 0)) {
+			return;
+		}
+		auto finished = std::move(dispatched);
+		dispatched.clear();
+		for (auto&& request : finished) {
+			if (auto agent = request->agent.lock()) {
+				if (request->cancelled()) {
+					continue;
+				}
+				if (request->restart) {
+					request->search.reset();
+					request->restart = false;
+					insertSorted(pending, request);
+				} else {
+					agent->receivePath(request);
+				}
+			}
+		}
+	}
+
+	PathCache::PathCache(Map &a_map) :
+		map(a_map) {
+		map.onStaticBlock.connect("__PATHCACHE", [&](std::shared_ptr<Map>, const Point<int> &a_position) {
+			staticBlockAt(a_position);
+		});
+	}
+
+	PathCache::~PathCache() {
+		map.onStaticBlock.disconnect("__PATHCACHE");
+	}
+
+	PathCache& PathCache::capacity(size_t a_entries) {
+		maximumEntries = a_entries;
+		evict();
+		return *this;
+	}
+
+	bool PathCache::find(const Point<int> &a_start, const Point<int> &a_goal, int a_unitSize, PointPrecision a_distance, std::vector<PathNode> &a_result) {
+		if (!enabled()) {
+			return false;
+		}
+		Key key{ a_start, a_goal, a_unitSize, a_distance };
+		auto found = entries.find(key);
+		if (found != entries.end()) {
+			if (found->second.revision != map.revision()) {
+				entries.erase(found);
+			} else if (frontIsClear(found->second.path, a_unitSize)) {
+				found->second.lastUsed = ++useCounter;
+				a_result = found->second.path;
+				++stats.hits;
+				return true;
+			}
+		}
+		if (splice(key, a_result)) {
+			++stats.splices;
+			store(a_start, a_goal, a_unitSize, a_distance, a_result);
+			return true;
+		}
+		++stats.misses;
+		return false;
+	}
+
+	void PathCache::store(const Point<int> &a_start, const Point<int> &a_goal, int a_unitSize, PointPrecision a_distance, const std::vector<PathNode> &a_path) {
+		if (!enabled() || a_path.empty()) {
+			return;
+		}
+		auto& entry = entries[Key{ a_start, a_goal, a_unitSize, a_distance }];
+		entry.path = a_path;
+		entry.revision = map.revision();
+		entry.lastUsed = ++useCounter;
+		evict();
+	}
+
+	bool PathCache::Entry::covers(const Point<int> &a_position, int a_unitSize) const {
+		return std::any_of(path.begin(), path.end(), [&](const PathNode &a_node) {
+			auto topLeft = a_node.position();
+			return (a_position.x >= topLeft.x) && (a_position.x < (topLeft.x + a_unitSize)) &&
+				(a_position.y >= topLeft.y) && (a_position.y < (topLeft.y + a_unitSize));
+		});
+	}
+
+	bool PathCache::frontIsClear(const std::vector<PathNode> &a_path, int a_unitSize) const {
+		for (size_t i = 1; i < a_path.size() && i <= VALIDATE_CELLS; ++i) {
+			if (!map.clearedForSize(a_path[i].position(), a_unitSize)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool PathCache::splice(const Key &a_key, std::vector<PathNode> &a_result) {
+		Entry* bestEntry = nullptr;
+		size_t bestIndex = 0;
+		auto bestDistance = static_cast<PointPrecision>(SPLICE_DISTANCE);
+		for (auto&& keyEntry : entries) {
+			auto& entryKey = keyEntry.first;
+			auto& entry = keyEntry.second;
+			if (entry.revision != map.revision() || entryKey.goal != a_key.goal || entryKey.unitSize != a_key.unitSize || entryKey.distance != a_key.distance) {
+				continue;
+			}
+			for (size_t i = 0; i < entry.path.size(); ++i) {
+				auto cellDistance = static_cast<PointPrecision>(distance(a_key.start, entry.path[i].position()));
+				//ties favour the node further along the corridor.
+				if (cellDistance <= bestDistance) {
+					bestDistance = cellDistance;
+					bestEntry = &entry;
+					bestIndex = i;
+				}
+			}
+		}
+		if (!bestEntry) {
+			return false;
+		}
+
+		Path join(map.shared_from_this(), a_key.start, bestEntry->path[bestIndex].position(), 0.0f, a_key.unitSize, SPLICE_SEARCH_NODES);
+		auto joinNodes = join.path();
+		if (!join.complete() || joinNodes.empty()) {
+			return false;
+		}
+		joinNodes.insert(joinNodes.end(), bestEntry->path.begin() + bestIndex + 1, bestEntry->path.end());
+		if (!frontIsClear(joinNodes, a_key.unitSize)) {
+			return false;
+		}
+		bestEntry->lastUsed = ++useCounter;
+		a_result = std::move(joinNodes);
+		return true;
+	}
+
+	void PathCache::staticBlockAt(const Point<int> &a_position) {
+		auto currentRevision = map.revision();
+		for (auto i = entries.begin(); i != entries.end();) {
+			//a block elsewhere cannot make a path invalid or shorter, so untouched corridors carry forward.
+			if (i->second.revision + 1 == currentRevision && !i->second.covers(a_position, i->first.unitSize)) {
+				i->second.revision = currentRevision;
+				++i;
+			} else {
+				i = entries.erase(i);
+			}
+		}
+	}
+
+	void PathCache::evict() {
+		while (entries.size() > maximumEntries) {
+			auto oldest = std::min_element(entries.begin(), entries.end(), [&](const std::pair<const Key, Entry> &a_lhs, const std::pair<const Key, Entry> &a_rhs) {
+				bool lhsStale = a_lhs.second.revision != map.revision();
+				bool rhsStale = a_rhs.second.revision != map.revision();
+				return lhsStale != rhsStale ? lhsStale : a_lhs.second.lastUsed < a_rhs.second.lastUsed;
+			});
+			entries.erase(oldest);
+		}
+	}
+
+	void Crowd::add(NavigationAgent* a_agent) {
+		if (bucketOf.find(a_agent) != bucketOf.end()) {
+			return;
+		}
+		auto key = bucketFor(a_agent->center());
+		buckets[key].push_back(a_agent);
+		bucketOf[a_agent] = key;
+		largestAgent = std::max(largestAgent, a_agent->size());
+	}
+
+	void Crowd::remove(NavigationAgent* a_agent) {
+		auto found = bucketOf.find(a_agent);
+		if (found == bucketOf.end()) {
+			return;
+		}
+		auto bucket = buckets.find(found->second);
+		if (bucket != buckets.end()) {
+			bucket->second.erase(std::remove(bucket->second.begin(), bucket->second.end(), a_agent), bucket->second.end());
+			if (bucket->second.empty()) {
+				buckets.erase(bucket);
+			}
+		}
+		bucketOf.erase(found);
+	}
+
+	void Crowd::moved(NavigationAgent* a_agent) {
+		auto found = bucketOf.find(a_agent);
+		if (found == bucketOf.end()) {
+			return;
+		}
+		auto key = bucketFor(a_agent->center());
+		if (key != found->second) {
+			auto& previous = buckets[found->second];
+			previous.erase(std::remove(previous.begin(), previous.end(), a_agent), previous.end());
+			if (previous.empty()) {
+				buckets.erase(found->second);
+			}
+			buckets[key].push_back(a_agent);
+			found->second = key;
+		}
+	}
+
+	Point<PointPrecision> Crowd::steer(const NavigationAgent* a_agent, const Point<PointPrecision> &a_direction, PointPrecision a_step) const {
+		Point<PointPrecision> push;
+		if (separationScale <= 0.0f || steeringStrength <= 0.0f || a_step <= 0.0f) {
+			return push;
+		}
+		auto ourCenter = a_agent->center();
+		auto ourSize = static_cast<PointPrecision>(a_agent->size());
+		auto searchRadius = (ourSize + static_cast<PointPrecision>(largestAgent)) * 0.5f * separationScale;
+		auto bucketReach = static_cast<int32_t>(std::ceil(searchRadius / BUCKET_SIZE));
+		auto centerX = static_cast<int32_t>(std::floor(ourCenter.x / BUCKET_SIZE));
+		auto centerY = static_cast<int32_t>(std::floor(ourCenter.y / BUCKET_SIZE));
+		//right hand side of travel, used to break head on and perfectly stacked meetings consistently.
+		auto sidestep = point(-a_direction.y, a_direction.x);
+
+		for (auto x = centerX - bucketReach; x <= centerX + bucketReach; ++x) {
+			for (auto y = centerY - bucketReach; y <= centerY + bucketReach; ++y) {
+				auto bucket = buckets.find(bucketKey(x, y));
+				if (bucket == buckets.end()) {
+					continue;
+				}
+				for (auto&& other : bucket->second) {
+					if (other == a_agent) {
+						continue;
+					}
+					auto offset = ourCenter - other->center();
+					offset.z = 0;
+					auto minimumDistance = (ourSize + static_cast<PointPrecision>(other->size())) * 0.5f * separationScale;
+					auto separation = offset.magnitude();
+					if (separation >= minimumDistance) {
+						continue;
+					}
+					auto overlap = (minimumDistance - separation) / minimumDistance;
+					auto away = separation > 0.0f ? offset / separation : sidestep;
+					push += away * overlap;
+					auto headOn = -(away.x * a_direction.x + away.y * a_direction.y);
+					if (headOn > 0.7f) {
+						push += sidestep * (overlap * headOn);
+					}
+				}
+			}
+		}
+
+		auto pushAmount = push.magnitude();
+		if (pushAmount > 1.0f) {
+			push /= pushAmount;
+		}
+		return push * (a_step * steeringStrength);
+	}
+
+	bool Crowd::occupied(const Point<int> &a_topLeft, int a_size) const {
+		//any agent overlapping the area has its center within largestAgent / 2 of it.
+		auto reach = static_cast<PointPrecision>(largestAgent) * 0.5f;
+		auto minX = static_cast<int32_t>(std::floor((a_topLeft.x - reach) / BUCKET_SIZE));
+		auto minY = static_cast<int32_t>(std::floor((a_topLeft.y - reach) / BUCKET_SIZE));
+		auto maxX = static_cast<int32_t>(std::floor((a_topLeft.x + a_size + reach) / BUCKET_SIZE));
+		auto maxY = static_cast<int32_t>(std::floor((a_topLeft.y + a_size + reach) / BUCKET_SIZE));
+		for (auto x = minX; x <= maxX; ++x) {
+			for (auto y = minY; y <= maxY; ++y) {
+				auto bucket = buckets.find(bucketKey(x, y));
+				if (bucket == buckets.end()) {
+					continue;
+				}
+				for (auto&& agent : bucket->second) {
+					auto agentTopLeft = agent->position();
+					auto agentSize = static_cast<PointPrecision>(agent->size());
+					if (agentTopLeft.x < a_topLeft.x + a_size && agentTopLeft.x + agentSize > a_topLeft.x &&
+						agentTopLeft.y < a_topLeft.y + a_size && agentTopLeft.y + agentSize > a_topLeft.y) {
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
 }
@@ -9,6 +9,12 @@
 #include <list>
 #include <queue>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 
 #include "MV/Utility/generalUtility.h"
 #include "MV/Utility/scopeGuard.hpp"
@@ -17,8 +23,14 @@
 
 namespace MV {
 
+	class ThreadPool;
 	class Map;
 	class TemporaryCost;
+	class NavigationAgent;
+	class PathRequest;
+	class PathRequestQueue;
+	class PathCache;
+	class Crowd;
 	class MapNode {
 		friend TemporaryCost;
 		friend cereal::access;
@@ -130,9 +142,13 @@ namespace MV {
 
 	class Map : public std::enable_shared_from_this<Map> {
 		friend cereal::access;
+		friend MapNode;
+		friend NavigationAgent;
 	public:
 		typedef void CallbackSignature(std::shared_ptr<Map>, const Point<int> &);
 		typedef SignalRegister<CallbackSignature>::SharedReceiverType SharedReceiverType;
+		typedef void AgentCallbackSignature(std::shared_ptr<NavigationAgent>);
+		typedef SignalRegister<AgentCallbackSignature>::SharedReceiverType AgentSharedReceiverType;
 	private:
 		Signal<CallbackSignature> onBlockSignal;
 		Signal<CallbackSignature> onUnblockSignal;
@@ -140,6 +156,7 @@ namespace MV {
 		Signal<CallbackSignature> onStaticUnblockSignal;
 		Signal<CallbackSignature> onCostChangeSignal;
 		Signal<CallbackSignature> onClearanceChangeSignal;
+		Signal<AgentCallbackSignature> onAgentStartSignal;
 	public:
 		SignalRegister<CallbackSignature> onBlock;
 		SignalRegister<CallbackSignature> onUnblock;
@@ -147,6 +164,8 @@ namespace MV {
 		SignalRegister<CallbackSignature> onStaticUnblock;
 		SignalRegister<CallbackSignature> onCostChange;
 		SignalRegister<CallbackSignature> onClearanceChange;
+		//Any agent on this map setting off toward a new goal, after its own onStart.
+		SignalRegister<AgentCallbackSignature> onAgentStart;
 
 		static std::shared_ptr<Map> make(const Size<int> &a_size, bool a_useCorners = false) {
 			return std::shared_ptr<Map>(new Map(a_size, 1.0f, a_useCorners));
@@ -156,10 +175,53 @@ namespace MV {
 			return std::shared_ptr<Map>(new Map(a_size, a_defaultCost, a_useCorners));
 		}
 
+		~Map();
+
 		void resize(const Size<int> &a_size, float a_defaultCost = 1.0f);
 
 		std::shared_ptr<Map> clone() const;
 
+		//Detached copy of the blocked state and costs with every cell eagerly initialized, safe to search from worker threads.
+		std::shared_ptr<Map> snapshot() const;
+		//Bring a map created with snapshot() back in line with our current state.
+		void refreshSnapshot(Map &a_snapshot) const;
+
+		//Cells normally initialize edges and clearance on first query, this does it for every cell up front.
+		void initializeCells() const;
+
+		PathRequestQueue& requests();
+
+		PathCache& pathCache();
+
+		Crowd& crowd();
+
+		//Whether something a_size cells across fits at a_topLeft. Unlike clearedForSize this also sees steering agents,
+		//which don't block cells, so use it for placing anything onto the map.
+		bool placeable(const Point<int> &a_topLeft, int a_size);
+
+		//Agents snap their positions to multiples of 1/a_stepsPerCell after every move so float error cannot accumulate
+		//differently between machines running the same simulation, 0 disables snapping.
+		void fixedPoint(int a_stepsPerCell) {
+			fixedPointSteps = std::max(a_stepsPerCell, 0);
+		}
+
+		int fixedPoint() const {
+			return fixedPointSteps;
+		}
+
+		Point<PointPrecision> snapToFixedPoint(const Point<PointPrecision> &a_position) const {
+			if (fixedPointSteps == 0) {
+				return a_position;
+			}
+			auto steps = static_cast<PointPrecision>(fixedPointSteps);
+			return point(std::round(a_position.x * steps) / steps, std::round(a_position.y * steps) / steps, a_position.z);
+		}
+
+		//Incremented whenever static blocking or base costs change, dynamic blocking by agents does not count.
+		uint64_t revision() const {
+			return ourRevision;
+		}
+
 		inline std::vector<MapNode>& operator[](int a_x) {
 			return squares[a_x];
 		}
@@ -232,6 +294,12 @@ namespace MV {
 		bool usingCorners;
 
 		std::vector<std::vector<MapNode>> squares;
+
+		std::unique_ptr<PathRequestQueue> requestQueue;
+		std::unique_ptr<PathCache> cache;
+		std::unique_ptr<Crowd> ourCrowd;
+		uint64_t ourRevision = 0;
+		int fixedPointSteps = 0;
 	};
 
 	class TemporaryCost {
@@ -307,6 +375,24 @@ namespace MV {
 			return pathNodes;
 		}
 
+		//Continue searching until finished or the deadline passes. Returns true once the search is done.
+		bool calculate(const std::chrono::high_resolution_clock::time_point &a_deadline);
+
+		//The result of the last finished search, does not calculate.
+		const std::vector<PathNode>& result() const {
+			return pathNodes;
+		}
+
+		bool finished() const {
+			return searchFinished;
+		}
+
+		//Discard any search progress, the next calculate call starts over.
+		void reset() {
+			searchStarted = false;
+			searchFinished = false;
+		}
+
 		const Point<int>& start() const {
 			return startPosition;
 		}
@@ -324,6 +410,11 @@ namespace MV {
 		bool complete() const {
 			return found;
 		}
+
+		//Nodes expanded by the current or last search.
+		int64_t nodesSearched() const {
+			return totalSearched;
+		}
 	private:
 		class PathCalculationNode {
 		public:
@@ -390,6 +481,9 @@ namespace MV {
 
 		void calculate();
 
+		void beginSearch();
+		void finishSearch();
+
 		void insertIntoOpen(const Point<int> &a_position, float a_startCost, PathCalculationNode* a_parent = nullptr, bool a_isCorner = false);
 
 		bool existsBetter(const Point<int> &a_position, float a_startCost);
@@ -400,8 +494,17 @@ namespace MV {
 		}
 
 		bool found = false;
+		bool searchStarted = false;
+		bool searchFinished = false;
+
+		//How many nodes are expanded between deadline checks in time sliced searches.
+		static const int64_t NODES_PER_DEADLINE_CHECK = 16;
 
 		int64_t maxSearchNodes = -1;
+		int64_t totalSearched = 0;
+		PathCalculationNode* currentNode = nullptr;
+		PathCalculationNode* bestNode = nullptr;
+		PointPrecision bestDistance = -1;
 
 		PointPrecision minimumDistance = 0;
 
@@ -421,6 +524,7 @@ namespace MV {
 
 	class NavigationAgent : public std::enable_shared_from_this<NavigationAgent> {
 		friend cereal::access;
+		friend PathRequestQueue;
 	public:
 		typedef void CallbackSignature(std::shared_ptr<NavigationAgent>);
 		typedef SignalRegister<CallbackSignature>::SharedReceiverType SharedReceiverType;
@@ -447,9 +551,7 @@ namespace MV {
 		int debugId() { return ourDebugId; }
 		void debugId(int a_id) { ourDebugId = a_id; }
 
-		~NavigationAgent() {
-			unblockMap();
-		}
+		~NavigationAgent();
 
 		std::shared_ptr<NavigationAgent> clone(const std::shared_ptr<Map> &a_map = nullptr) const {
 			auto result = NavigationAgent::make(a_map == nullptr ? map : a_map, ourPosition);
@@ -457,6 +559,8 @@ namespace MV {
 			result->ourSpeed = ourSpeed;
 			result->acceptableDistance = acceptableDistance;
 			result->unitSize = unitSize;
+			result->requestPriority = requestPriority;
+			result->steering(crowdSteering);
 			return result;
 		}
 
@@ -481,6 +585,22 @@ namespace MV {
 			return !footprintDisabled;
 		}
 
+		//Steering agents stop blocking grid cells and are pushed apart by the map's Crowd instead, so passing
+		//each other no longer invalidates paths. Static blocks and non steering agents are still pathed around.
+		//Path searches don't see steering agents, placement does: Map::placeable and placing a non steering agent
+		//wait for them to move out of the way.
+		std::shared_ptr<NavigationAgent> steering(bool a_enabled);
+
+		bool steering() const {
+			return crowdSteering;
+		}
+
+		//Centre of the agent's footprint in grid units.
+		Point<PointPrecision> center() const {
+			auto halfSize = static_cast<PointPrecision>(unitSize) / 2.0f;
+			return position() + point(halfSize, halfSize);
+		}
+
 		Point<PointPrecision> position() const {
 			return ourPosition - centerOffset;
 		}
@@ -513,6 +633,7 @@ namespace MV {
 			ourPosition = a_newPosition + centerOffset;
 			ourGoal = a_newPosition + centerOffset;
 			blockMap();
+			updateCrowdPosition();
 			markDirty();
 			if (wasMoving) {
 				onArriveSignal(shared_from_this());
@@ -544,6 +665,7 @@ namespace MV {
 					onArriveSignal(shared_from_this());
 				} else if (!wasMoving && pathfinding()) {
 					onStartSignal(shared_from_this());
+					map->onAgentStartSignal(self);
 				}
 			}
 			return self;
@@ -575,6 +697,22 @@ namespace MV {
 			updateObservedNodes();
 			return self;
 		}
+
+		//Higher priority path requests are searched first when the map's request queue is asynchronous.
+		int priority() const {
+			return requestPriority;
+		}
+
+		std::shared_ptr<NavigationAgent> priority(int a_newPriority) {
+			auto self = shared_from_this();
+			requestPriority = a_newPriority;
+			return self;
+		}
+
+		bool waitingForPath() const {
+			return pendingRequest != nullptr;
+		}
+
 		bool pathfinding() const {
 			auto goalDistance = static_cast<PointPrecision>(distance(cast<int>(ourPosition), cast<int>(ourGoal)));
 			return goalDistance > acceptableDistance;
@@ -588,6 +726,24 @@ namespace MV {
 		bool attemptToRecalculate();
 		void incrementPathIndex();
 
+		void requestRecalculate();
+		void cancelPendingRequest();
+		bool canFollowStalePath();
+		void receivePath(const std::shared_ptr<PathRequest> &a_request);
+		void applyCalculatedPath(const std::vector<PathNode> &a_path);
+
+		bool applyCachedPath();
+		void storeCalculatedPath();
+
+		//returns how far the crowd pushed us, which comes out of a_step.
+		PointPrecision applySteering(const Point<PointPrecision> &a_direction, PointPrecision a_step);
+		void updateCrowdPosition();
+		void snapToFixedPoint();
+
+		std::shared_ptr<Path> makePath(const std::shared_ptr<Map> &a_searchMap) const {
+			return std::make_shared<Path>(a_searchMap, cast<int>(ourPosition), cast<int>(ourGoal), acceptableDistance, unitSize, maxNodesToSearch);
+		}
+
 		NavigationAgent(std::shared_ptr<Map> a_map, const Point<int> &a_newPosition, int a_unitSize, bool a_offsetCenterByHalf) :
 			NavigationAgent(a_map, cast<PointPrecision>(a_newPosition), a_unitSize, a_offsetCenterByHalf){
 		}
@@ -649,11 +805,7 @@ namespace MV {
 			unblockMap();
 		}
 
-		void markDirty() {
-			costs.clear();
-			receivers.clear();
-			dirtyPath = true;
-		}
+		void markDirty();
 
 		void removeBlockedPathObservers(unsigned int a_pathId) {
 			blockedNodeObservers.erase(std::remove_if(blockedNodeObservers.begin(), blockedNodeObservers.end(), [&](auto&& blockedObserver) {
@@ -666,24 +818,30 @@ namespace MV {
 		void recalculate() {
 			receivers.clear();
 			costs.clear();
+			cancelPendingRequest();
+			if (applyCachedPath()) {
+				return;
+			}
 
 			unblockMap();
-			ourPath = std::make_shared<Path>(map, cast<int>(ourPosition), cast<int>(ourGoal), acceptableDistance, unitSize, maxNodesToSearch);
+			ourPath = makePath(map);
 			calculatedPath = ourPath->path();
 			blockMap();
 			
 			currentPathIndex = !calculatedPath.empty() && cast<int>(ourPosition) == calculatedPath[0].position() ? 1 : 0;
 			updateObservedNodes();
 			dirtyPath = false;
+			storeCalculatedPath();
 		}
 
 		bool canPlaceOnMapAtCurrentPosition() {
 			auto topLeft = cast<int>(position());
-			return map->clearedForSize(topLeft, unitSize);
+			//steering agents are separated by the crowd once placed, everyone else waits for them to clear out.
+			return crowdSteering ? map->clearedForSize(topLeft, unitSize) : map->placeable(topLeft, unitSize);
 		}
 
 		void blockMap(){
-			if (!footprintDisabled) {
+			if (!footprintDisabled && !crowdSteering) {
 				if (isBlocking) {
 					return;
 				}
@@ -766,6 +924,7 @@ namespace MV {
 		int unitSize = 1;
 
 		bool isBlocking = false;
+		bool crowdSteering = false;
 
 		std::vector<TemporaryCost> costs;
 		std::vector<MapNode::SharedReceiverType> receivers;
@@ -775,8 +934,265 @@ namespace MV {
 		std::shared_ptr<Path> ourPath;
 		std::vector<PathNode> calculatedPath;
 
+		int requestPriority = 0;
+		std::shared_ptr<PathRequest> pendingRequest;
+
 		int ourDebugId = 0;
 	};
+
+	class PathRequest {
+		friend PathRequestQueue;
+		friend NavigationAgent;
+	public:
+		PathRequest(const std::shared_ptr<NavigationAgent> &a_agent, int a_priority, uint64_t a_sequence) :
+			agent(a_agent),
+			ourPriority(a_priority),
+			sequence(a_sequence) {
+		}
+
+		int priority() const {
+			return ourPriority;
+		}
+
+		bool cancelled() const {
+			return isCancelled;
+		}
+
+		//Lower priority sorts first, equal priorities put the oldest request last so it is popped first.
+		bool operator<(const PathRequest &a_rhs) const {
+			return ourPriority < a_rhs.ourPriority || (ourPriority == a_rhs.ourPriority && sequence > a_rhs.sequence);
+		}
+
+	private:
+		//the agent moved or changed goals, any progress is stale.
+		void invalidate() {
+			restart = true;
+		}
+
+		void cancel() {
+			isCancelled = true;
+		}
+
+		std::weak_ptr<NavigationAgent> agent;
+		int ourPriority;
+		uint64_t sequence;
+		std::shared_ptr<Path> search;
+		bool restart = false;
+		bool isCancelled = false;
+	};
+
+	//Owned by a Map. When given a budget, NavigationAgents queue their path searches here instead of calculating
+	//them synchronously in update. Searches are time sliced across calls to update (or run on worker threads
+	//against a snapshot of the map) and agents keep following their old path until the new one is delivered.
+	class PathRequestQueue {
+	public:
+		PathRequestQueue(Map &a_map) :
+			map(a_map) {
+		}
+
+		//Milliseconds of search time allowed per update. Zero or less keeps pathfinding synchronous.
+		PathRequestQueue& budget(double a_milliseconds) {
+			millisecondBudget = a_milliseconds;
+			return *this;
+		}
+
+		double budget() const {
+			return millisecondBudget;
+		}
+
+		bool asynchronous() const {
+			return millisecondBudget > 0.0;
+		}
+
+		//Searches are performed on worker threads against a read-only map snapshot, nullptr disables.
+		PathRequestQueue& workers(ThreadPool* a_pool) {
+			pool = a_pool;
+			return *this;
+		}
+
+		ThreadPool* workers() const {
+			return pool;
+		}
+
+		std::shared_ptr<PathRequest> request(const std::shared_ptr<NavigationAgent> &a_agent, int a_priority);
+
+		size_t size() const {
+			return pending.size() + dispatched.size();
+		}
+
+		void update();
+
+		//Searches in progress hold on to map cells, call when the map is restructured.
+		void restartSearches();
+
+	private:
+		void updateTimeSliced();
+		void dispatchToWorkers();
+		void deliverWorkerResults();
+
+		Map& map;
+		double millisecondBudget = 0.0;
+		ThreadPool* pool = nullptr;
+		uint64_t nextSequence = 0;
+
+		std::vector<std::shared_ptr<PathRequest>> pending;
+
+		std::vector<std::shared_ptr<PathRequest>> dispatched;
+		std::shared_ptr<std::atomic<size_t>> outstanding;
+		std::shared_ptr<Map> snapshot;
+	};
+
+	//Owned by a Map. Remembers complete paths so agents repeatedly travelling between the same cells (creatures
+	//spawned from one building heading to the same well) skip the search. Entries are tied to the map revision:
+	//a static block only drops the entries whose corridor it lands on, other revision changes drop everything.
+	//Agents that start near a cached corridor heading to the same goal join it with a short search.
+	class PathCache {
+	public:
+		struct Statistics {
+			size_t hits = 0;
+			size_t splices = 0;
+			size_t misses = 0;
+		};
+
+		PathCache(Map &a_map);
+		~PathCache();
+
+		//Maximum number of remembered paths, zero disables the cache.
+		PathCache& capacity(size_t a_entries);
+
+		size_t capacity() const {
+			return maximumEntries;
+		}
+
+		bool enabled() const {
+			return maximumEntries > 0;
+		}
+
+		size_t size() const {
+			return entries.size();
+		}
+
+		//Fills a_result and returns true if a valid cached or spliced path exists. The caller's own footprint should be lifted.
+		bool find(const Point<int> &a_start, const Point<int> &a_goal, int a_unitSize, PointPrecision a_distance, std::vector<PathNode> &a_result);
+
+		void store(const Point<int> &a_start, const Point<int> &a_goal, int a_unitSize, PointPrecision a_distance, const std::vector<PathNode> &a_path);
+
+		void clear() {
+			entries.clear();
+		}
+
+		const Statistics& statistics() const {
+			return stats;
+		}
+
+		void resetStatistics() {
+			stats = Statistics();
+		}
+
+		//How far (in cells) an agent may be from a cached corridor and still join it.
+		static const int SPLICE_DISTANCE = 3;
+		//Cells at the front of a cached path that must be currently clear for it to be reused.
+		static const size_t VALIDATE_CELLS = 4;
+		//Node limit for the search joining an agent to a nearby cached corridor.
+		static const int64_t SPLICE_SEARCH_NODES = 64;
+
+	private:
+		struct Key {
+			Point<int> start;
+			Point<int> goal;
+			int unitSize;
+			PointPrecision distance;
+
+			bool operator<(const Key &a_rhs) const {
+				return std::tie(start.x, start.y, goal.x, goal.y, unitSize, distance) < std::tie(a_rhs.start.x, a_rhs.start.y, a_rhs.goal.x, a_rhs.goal.y, a_rhs.unitSize, a_rhs.distance);
+			}
+		};
+
+		struct Entry {
+			std::vector<PathNode> path;
+			uint64_t revision = 0;
+			uint64_t lastUsed = 0;
+
+			bool covers(const Point<int> &a_position, int a_unitSize) const;
+		};
+
+		bool frontIsClear(const std::vector<PathNode> &a_path, int a_unitSize) const;
+		bool splice(const Key &a_key, std::vector<PathNode> &a_result);
+		void staticBlockAt(const Point<int> &a_position);
+		void evict();
+
+		Map& map;
+		size_t maximumEntries = 0;
+		uint64_t useCounter = 0;
+		std::map<Key, Entry> entries;
+		Statistics stats;
+	};
+
+	//Owned by a Map. Tracks steering agents in a spatial hash so each one can cheaply find its neighbours and
+	//be pushed apart from them (boids style separation with a sidestep for head on meetings).
+	class Crowd {
+	public:
+		Crowd(Map &a_map) :
+			map(a_map) {
+		}
+
+		//Agents closer than their combined half sizes times this scale push apart.
+		Crowd& separation(PointPrecision a_scale) {
+			separationScale = std::max(a_scale, 0.0f);
+			return *this;
+		}
+
+		PointPrecision separation() const {
+			return separationScale;
+		}
+
+		//Fraction of an agent's step that can be spent being pushed aside, the rest follows its path.
+		Crowd& strength(PointPrecision a_fraction) {
+			steeringStrength = std::min(std::max(a_fraction, 0.0f), 1.0f);
+			return *this;
+		}
+
+		PointPrecision strength() const {
+			return steeringStrength;
+		}
+
+		size_t size() const {
+			return bucketOf.size();
+		}
+
+		void add(NavigationAgent* a_agent);
+		void remove(NavigationAgent* a_agent);
+		//Call after an agent's position changes to keep the spatial hash current.
+		void moved(NavigationAgent* a_agent);
+
+		//Offset to move a_agent by this step given its normalized travel direction and how far it may move.
+		Point<PointPrecision> steer(const NavigationAgent* a_agent, const Point<PointPrecision> &a_direction, PointPrecision a_step) const;
+
+		//True if any agent's footprint overlaps the a_size square of cells at a_topLeft.
+		bool occupied(const Point<int> &a_topLeft, int a_size) const;
+
+		//Side length of a spatial hash bucket in grid cells.
+		static constexpr PointPrecision BUCKET_SIZE = 4.0f;
+
+	private:
+		typedef int64_t BucketKey;
+
+		BucketKey bucketFor(const Point<PointPrecision> &a_position) const {
+			return bucketKey(static_cast<int32_t>(std::floor(a_position.x / BUCKET_SIZE)), static_cast<int32_t>(std::floor(a_position.y / BUCKET_SIZE)));
+		}
+
+		static BucketKey bucketKey(int32_t a_x, int32_t a_y) {
+			return (static_cast<BucketKey>(a_x) << 32) | static_cast<uint32_t>(a_y);
+		}
+
+		Map& map;
+		PointPrecision separationScale = 1.0f;
+		PointPrecision steeringStrength = 0.5f;
+		int largestAgent = 1;
+
+		std::unordered_map<BucketKey, std::vector<NavigationAgent*>> buckets;
+		std::unordered_map<NavigationAgent*, BucketKey> bucketOf;
+	};
     
     template <class Archive>
     void MapNode::save(Archive & archive) const {
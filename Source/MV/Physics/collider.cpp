@@ -3,6 +3,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_REGISTER_TYPE(MV::Scene::Collider);
 CEREAL_REGISTER_TYPE(MV::Scene::Environment);
@@ -2,6 +2,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 #include "MV/Utility/visitor.hpp"
 
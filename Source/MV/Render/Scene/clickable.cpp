@@ -4,6 +4,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_REGISTER_TYPE(MV::Scene::Clickable);
 CEREAL_REGISTER_DYNAMIC_INIT(mv_sceneclickable);
@@ -3,6 +3,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_REGISTER_TYPE(MV::Scene::Component);
 CEREAL_REGISTER_DYNAMIC_INIT(mv_scenecomponent);
@@ -72,6 +73,10 @@ namespace MV {
 		}
 
 		void Component::notifyParentOfComponentChange() {
+			std::weak_ptr<Component> weakSelf = shared_from_this();
+			if (DeferredChanges::defer([weakSelf]() { if (auto self = weakSelf.lock()) { self->notifyParentOfComponentChange(); } })) {
+				return;
+			}
 			try {
 				owner()->onComponentUpdateSignal(shared_from_this());
 			} catch (MV::PointerException &) {
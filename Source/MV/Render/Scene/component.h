@@ -150,7 +150,13 @@ namespace MV {
 			virtual bool draw() { return true; }
 			virtual void endDraw() { }
 
-			void update(double a_delta) {
+			//false for components that draw outside of bounds(), nodes holding one are never culled.
+			virtual bool cullable() const { return true; }
+			//everything draw() may touch, for components whose visuals spill past bounds() in a known way.
+			virtual BoxAABB<> cullBounds() { return bounds(); }
+
+			//a_includeConcurrent is false when an ancestor's updateWorkers runs concurrentUpdateImplementation afterward.
+			void update(double a_delta, bool a_includeConcurrent = true) {
 				accumulatedDelta += a_delta;
 				updateImplementation(a_delta);
 				if (rootTask) {
@@ -158,6 +164,9 @@ namespace MV {
 						rootTask.reset();
 					}
 				}
+				if (a_includeConcurrent) {
+					concurrentUpdateImplementation(a_delta);
+				}
 			}
 
 			std::shared_ptr<Component> bounds(const BoxAABB<> &a_localBounds) {
@@ -279,6 +288,9 @@ namespace MV {
 			}
 
 			virtual void updateImplementation(double a_delta) {}
+			//Runs after updateImplementation, on a worker thread when an ancestor has updateWorkers. Only touch this component
+			//and our owner's subtree here, scene changes and notifications made meanwhile are deferred until every subtree is done.
+			virtual void concurrentUpdateImplementation(double /*a_delta*/) {}
 			double accumulatedDelta = 0.0;
 		private:
 			bool allowSerialize = true;
@@ -2,6 +2,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 #include "MV/Utility/log.h"
 
@@ -13,9 +14,6 @@ namespace MV {
 	namespace Scene {
 
 		Drawable::~Drawable() {
-			if (bufferId != 0) {
-				glDeleteBuffers(1, &bufferId);
-			}
 		}
 
 		bool Drawable::draw() {
@@ -131,64 +129,89 @@ namespace MV {
 		}
 
 		void Drawable::defaultDrawImplementation() {
+			auto& ourRenderer = owner()->renderer();
+			if (ourRenderer.renderQueue().enabled() && batchable()) {
+				if (!vertexIndices.empty()) {
+					queuedState.shader = shaderProgram;
+					queuedState.cameraId = owner()->cameraId();
+					queuedState.defaultBlend = !presetBlendFunction(queuedState.blendSource, queuedState.blendDestination);
+					ourRenderer.renderQueue().push(queuedState, owner()->worldTransform(), points, vertexIndices);
+				}
+			} else {
+				drawImmediately();
+			}
+		}
+
+		bool Drawable::batchable() const {
+			return !userMaterialSettings && drawType == GL_TRIANGLES && (!shaderProgram || shaderProgram->batchable());
+		}
+
+		void Drawable::drawImmediately() {
 			auto& ourRenderer = owner()->renderer();
 			if (ourRenderer.headless()) { return; }
 
 			if (!vertexIndices.empty()) {
+				ourRenderer.renderQueue().flush();
 				require<ResourceException>(shaderProgram, "No shader program for Drawable!");
 				shaderProgram->use();
 
-				if (bufferId == 0) {
-					glGenBuffers(1, &bufferId);
-				}
-
 				applyPresetBlendMode(ourRenderer);
 
-				glBindBuffer(GL_ARRAY_BUFFER, bufferId);
-
-				auto structSize = static_cast<GLsizei>(sizeof(points[0]));
-				if (dirtyVertexBuffer) {
-					dirtyVertexBuffer = false;
-					glBufferData(GL_ARRAY_BUFFER, points.size() * structSize, &(points[0]), GL_STATIC_DRAW);
-				}
-				glEnableVertexAttribArray(0);
-				glEnableVertexAttribArray(1);
-				glEnableVertexAttribArray(2);
-
-				auto positionOffset = static_cast<size_t>(offsetof(DrawPoint, x));
-				auto textureOffset = static_cast<size_t>(offsetof(DrawPoint, textureX));
-				auto colorOffset = static_cast<size_t>(offsetof(DrawPoint, R));
-				glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)positionOffset); //Point
-				glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)textureOffset); //UV
-				glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)colorOffset); //Color
+				uploadDirtyPoints();
+				drawBuffer.bind(ourRenderer.renderState());
 
 				materialSettingsImplementation(shaderProgram);
 				if (userMaterialSettings) {
 					try { userMaterialSettings(shaderProgram); } catch (std::exception &e) { MV::error("Drawable::defaultDrawImplementation. Exception in userMaterialSettings: ", e.what()); }
 				}
 
-				glDrawElements(drawType, static_cast<GLsizei>(vertexIndices.size()), GL_UNSIGNED_INT, &vertexIndices[0]);
+				drawBuffer.draw(drawType, vertexIndices.size());
+			}
+		}
 
-				glDisableVertexAttribArray(0);
-				glDisableVertexAttribArray(1);
-				glDisableVertexAttribArray(2);
-				glUseProgram(0);
-				if (blendModePreset != DEFAULT) {
-					ourRenderer.defaultBlendFunction();
-				}
+		void Drawable::uploadDirtyPoints() {
+			auto& state = owner()->renderer().renderState();
+			if (dirtyVertexBuffer) {
+				dirtyVertexBuffer = false;
+				dirtyPointsBegin = dirtyPointsEnd = 0;
+				drawBuffer.points(state, points);
+				drawBuffer.indices(state, vertexIndices);
+			} else if (dirtyPointsEnd > dirtyPointsBegin) {
+				drawBuffer.points(state, points, dirtyPointsBegin, std::min(dirtyPointsEnd, points.size()));
+				dirtyPointsBegin = dirtyPointsEnd = 0;
+			}
+		}
+
+		void Drawable::dirtyPoints(size_t a_begin, size_t a_end) {
+			if (dirtyPointsEnd > dirtyPointsBegin) {
+				dirtyPointsBegin = std::min(dirtyPointsBegin, a_begin);
+				dirtyPointsEnd = std::max(dirtyPointsEnd, a_end);
+			} else {
+				dirtyPointsBegin = a_begin;
+				dirtyPointsEnd = a_end;
 			}
 		}
 
 		void Drawable::applyPresetBlendMode(Draw2D &ourRenderer) const {
-			if (blendModePreset != DEFAULT) {
-				if (blendModePreset == ADD) {
-					ourRenderer.setBlendFunction(GL_ONE, GL_ONE);
-				} else if (blendModePreset == MULTIPLY) {
-					ourRenderer.setBlendFunction(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
-				} else if (blendModePreset == SCREEN) {
-					ourRenderer.setBlendFunction(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
-				}
+			GLenum source, destination;
+			if (presetBlendFunction(source, destination)) {
+				ourRenderer.setBlendFunction(source, destination);
+			} else {
+				ourRenderer.defaultBlendFunction();
+			}
+		}
+
+		bool Drawable::presetBlendFunction(GLenum &a_source, GLenum &a_destination) const {
+			if (blendModePreset == ADD) {
+				a_source = GL_ONE; a_destination = GL_ONE;
+			} else if (blendModePreset == MULTIPLY) {
+				a_source = GL_DST_COLOR; a_destination = GL_ONE_MINUS_SRC_ALPHA;
+			} else if (blendModePreset == SCREEN) {
+				a_source = GL_ONE; a_destination = GL_ONE_MINUS_SRC_COLOR;
+			} else {
+				return false;
 			}
+			return true;
 		}
 
 		void Drawable::refreshBounds() {
@@ -236,11 +259,11 @@ namespace MV {
 
 		void Drawable::materialSettingsImplementation(Shader* a_shaderProgram) {
 			auto ourOwner = owner();
-			a_shaderProgram->set("time", static_cast<PointPrecision>(accumulatedDelta), false); //optional but helpful default
-			if (ourOwner->worldAlpha() != 1.0f) { a_shaderProgram->set("alpha", ourOwner->worldAlpha(), false); }
+			a_shaderProgram->set(Uniforms::time, static_cast<PointPrecision>(accumulatedDelta), false); //optional but helpful default
+			if (ourOwner->worldAlpha() != 1.0f) { a_shaderProgram->set(Uniforms::alpha, ourOwner->worldAlpha(), false); }
 			addTexturesToShader();
 
-			a_shaderProgram->set("transformation", ourOwner->renderer().cameraProjectionMatrix(ourOwner->cameraId()) * ourOwner->worldTransform());
+			a_shaderProgram->set(Uniforms::transformation, ourOwner->renderer().cameraProjectionMatrix(ourOwner->cameraId()) * ourOwner->worldTransform());
 		}
 
 		void Drawable::addTexturesToShader() {
@@ -249,13 +272,11 @@ namespace MV {
 				return;
 			}
 			auto& bounds = !ourTextures.empty() ? ourTextures.begin()->second->rawPercent() : unitBox;
-			if (shaderProgram->setVec2("uvMin", bounds.minPoint, false)) {
-				shaderProgram->setVec2("uvMax", bounds.maxPoint, false); //optional but helpful default
+			if (shaderProgram->setVec2(Uniforms::uvMin, bounds.minPoint, false)) {
+				shaderProgram->setVec2(Uniforms::uvMax, bounds.maxPoint, false); //optional but helpful default
 			}
-			bool firstTexture = true;
-			for (auto&& kv : cachedTextureList) {
-				shaderProgram->set(kv.first, kv.second, firstTexture);
-				firstTexture = false;
+			for (size_t i = 0; i < cachedTextureList.size(); ++i) {
+				shaderProgram->set(ShaderUniform::texture(i), cachedTextureList[i], static_cast<GLuint>(i), i == 0);
 			}
 		}
 
@@ -264,13 +285,14 @@ namespace MV {
 			std::set<std::shared_ptr<MV::TextureDefinition>> actuallyRegistered;
 			for (auto&& kv : ourTextures) {
 				if (actuallyRegistered.find(kv.second->texture()) == actuallyRegistered.end()) {
-					cachedTextureList.emplace_back("texture" + std::to_string(actuallyRegistered.size()), kv.second->texture());
+					cachedTextureList.push_back(kv.second->texture());
 					actuallyRegistered.insert(kv.second->texture());
 				}
 			}
 			if (actuallyRegistered.empty()) {
-				cachedTextureList.emplace_back("texture0", nullptr);
+				cachedTextureList.push_back(nullptr);
 			}
+			queuedState.textures = cachedTextureList;
 		}
 
 		void Drawable::initialize() {
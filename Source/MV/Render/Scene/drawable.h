@@ -199,7 +199,7 @@ namespace MV {
 			std::shared_ptr<Drawable> setPoint(size_t a_index, const Color& a_value) {
 				if (points[a_index].color() != a_value) {
 					points[a_index] = a_value;
-					dirtyVertexBuffer = true;
+					dirtyPoints(a_index, a_index + 1);
 				}
 				return std::static_pointer_cast<Drawable>(shared_from_this());
 			}
@@ -211,6 +211,7 @@ namespace MV {
 
 			//fine to just pass back a reference, changing the index order doesn't impact the bounding box logic.
 			std::vector<GLuint>& pointIndices() {
+				dirtyVertexBuffer = true; //the caller may edit indices, they upload alongside the points.
 				return vertexIndices;
 			}
 
@@ -266,6 +267,8 @@ namespace MV {
 			}
 
 			void applyPresetBlendMode(Draw2D &ourRenderer) const;
+			//returns false for DEFAULT, which leaves the renderer's blend function alone.
+			bool presetBlendFunction(GLenum &a_source, GLenum &a_destination) const;
 
 			virtual void boundsImplementation(const BoxAABB<> &a_bounds) override;
 
@@ -279,8 +282,15 @@ namespace MV {
 				return true;
 			}
 
+			//queues into the renderer's RenderQueue when batchable, otherwise draws immediately.
 			virtual void defaultDrawImplementation();
 
+			//true when nothing about this draw needs its own uniforms, so it can share a draw call.
+			virtual bool batchable() const;
+
+			//flushes the RenderQueue and issues this drawable's own draw call.
+			void drawImmediately();
+
 			virtual void refreshBounds();
 
 			template <class Archive>
@@ -374,9 +384,14 @@ namespace MV {
 
 			Shader* shaderProgram = nullptr;
 			std::string shaderProgramId = PREMULTIPLY_ID;
-			GLuint bufferId = 0;
+			DrawBuffer drawBuffer;
 
+			//dirtyVertexBuffer re-uploads every point and index, the dirtyPoints range only re-uploads those points.
 			bool dirtyVertexBuffer = true;
+			size_t dirtyPointsBegin = 0;
+			size_t dirtyPointsEnd = 0;
+			void dirtyPoints(size_t a_begin, size_t a_end);
+			void uploadDirtyPoints();
 
 			std::map<size_t, std::shared_ptr<TextureHandle>> ourTextures;
 			std::map<size_t, TextureHandle::SignalType::SharedType> textureSizeSignals;
@@ -399,7 +414,9 @@ namespace MV {
 
 			void rebuildTextureCache();
 
-			std::vector<std::pair<std::string, std::shared_ptr<TextureDefinition>>> cachedTextureList;
+			//bound to texture0...textureN in order.
+			std::vector<std::shared_ptr<TextureDefinition>> cachedTextureList;
+			RenderQueue::State queuedState;
 
 		private:
 			virtual void clearTextureCoordinates(size_t a_textureId) {
@@ -4,6 +4,7 @@
 #include "MV/Utility/generalUtility.h"
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_REGISTER_TYPE(MV::Scene::Emitter);
 CEREAL_CLASS_VERSION(MV::Scene::ParticleChangeValues, 1);
@@ -400,53 +401,27 @@ namespace MV {
 			auto ourOwner = owner();
 			auto& ourRenderer = ourOwner->renderer();
 			if (ourRenderer.headless()) { return; }
+			ourRenderer.renderQueue().flush();
 
 			std::lock_guard<std::recursive_mutex> guard(lock); //important!
 			if (!vertexIndices.empty()) {
 				require<ResourceException>(shaderProgram, "No shader program for Drawable!");
 				shaderProgram->use();
 
-				if (bufferId == 0) {
-					glGenBuffers(1, &bufferId);
-				}
-
 				applyPresetBlendMode(ourRenderer);
 
-				glBindBuffer(GL_ARRAY_BUFFER, bufferId);
-				auto structSize = static_cast<GLsizei>(sizeof(points[0]));
-				if (dirtyVertexBuffer) {
-					dirtyVertexBuffer = false;
-					glBufferData(GL_ARRAY_BUFFER, points.size() * structSize, &(points[0]), GL_STATIC_DRAW);
-				}
-
-				glEnableVertexAttribArray(0);
-				glEnableVertexAttribArray(1);
-				glEnableVertexAttribArray(2);
-
-				auto positionOffset = static_cast<size_t>(offsetof(DrawPoint, x));
-				auto textureOffset = static_cast<size_t>(offsetof(DrawPoint, textureX));
-				auto colorOffset = static_cast<size_t>(offsetof(DrawPoint, R));
-				glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)positionOffset); //Point
-				glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)textureOffset); //UV
-				glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)colorOffset); //Color
+				uploadDirtyPoints();
+				drawBuffer.bind(ourRenderer.renderState());
 
 				std::set<std::shared_ptr<MV::TextureDefinition>> actuallyRegistered;
 				addTexturesToShader();
 				auto emitterSpace = relativeNodePosition.expired() ? ourOwner : relativeNodePosition.lock();
-				shaderProgram->set("transformation", ourRenderer.cameraProjectionMatrix(ourOwner->cameraId()) * emitterSpace->worldTransform());
+				shaderProgram->set(Uniforms::transformation, ourRenderer.cameraProjectionMatrix(ourOwner->cameraId()) * emitterSpace->worldTransform());
 				if (userMaterialSettings) {
 					try { userMaterialSettings(shaderProgram); } catch (std::exception &e) { MV::error("Emitter::defaultDrawImplementation. Exception in userMaterialSettings: ", e.what()); }
 				}
 
-				glDrawElements(drawType, static_cast<GLsizei>(vertexIndices.size()), GL_UNSIGNED_INT, &vertexIndices[0]);
-
-				glDisableVertexAttribArray(0);
-				glDisableVertexAttribArray(1);
-				glDisableVertexAttribArray(2);
-				glUseProgram(0);
-				if (blendModePreset != DEFAULT) {
-					ourOwner->renderer().defaultBlendFunction();
-				}
+				drawBuffer.draw(drawType, vertexIndices.size());
 			}
 		}
 
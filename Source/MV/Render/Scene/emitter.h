@@ -249,6 +249,9 @@ namespace MV {
 
 			~Emitter();
 
+			//particles leave the spawn area bounds() describes, and may live in another node's space.
+			bool cullable() const override { return false; }
+
 		protected:
 			Emitter(const std::weak_ptr<Node> &a_owner, ThreadPool &a_pool);
 
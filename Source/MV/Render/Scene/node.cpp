@@ -2,10 +2,15 @@
 #include "stddef.h"
 #include <numeric>
 #include <regex>
+#include <atomic>
+#include <cctype>
+#include "MV/Utility/threadPool.hpp"
+#include "MV/Utility/mappedFile.h"
 
 #include "cereal/archives/adapters.hpp"
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_CLASS_VERSION(MV::Scene::Node, 2);
 
@@ -14,6 +19,7 @@ namespace MV {
 		int64_t Node::recalculateLocalBoundsCalls = 0;
 		int64_t Node::recalculateChildBoundsCalls = 0;
 		int64_t Node::recalculateMatrixCalls = 0;
+		int64_t Node::culledNodeDraws = 0;
 
 		Node::ReSort::ReSort(const std::shared_ptr<Node> &a_self):
 			self(a_self) {
@@ -31,6 +37,9 @@ namespace MV {
 				inserted = true;
 				if (self->myParent) {
 					int64_t newIndex = std::distance(self->myParent->childNodes.begin(), insertSorted(self->myParent->childNodes, self));
+					self->myParent->invalidateComponentLookups();
+					self->myParent->invalidateTransformLayout();
+					self->myParent->invalidateChildVolumes();
 					return originalIndex != newIndex;
 				}
 			}
@@ -54,7 +63,13 @@ namespace MV {
 		}
 
 		void Node::draw() {
+			if (flatTransforms) {
+				flatTransforms->update();
+			}
 			if (allowDraw) {
+				if (culled()) {
+					return;
+				}
 				bool allowChildrenToDraw = true;
 				for (size_t i = 0; i < childComponents.size();++i) {
 					allowChildrenToDraw = childComponents[i]->draw() && allowChildrenToDraw;
@@ -77,11 +92,23 @@ namespace MV {
 		}
 
 		void Node::draw(const TransformMatrix &a_overrideParentMatrix) {
+			if (flatTransforms) {
+				flatTransforms->update();
+			}
 			if (allowDraw) {
-				SCOPE_EXIT{ usingTemporaryMatrix = false; worldMatrixDirty = true; localMatrixDirty = true; };
+				SCOPE_EXIT{
+					usingTemporaryMatrix = false; worldMatrixDirty = true; localMatrixDirty = true;
+					//matrices recalculated while drawing came from the override, so our flattened copy is stale too.
+					if (transformHierarchy) {
+						transformHierarchy->dirty[transformSlot] = 1;
+					}
+				};
 				usingTemporaryMatrix = true;
 				temporaryWorldMatrixTransform = a_overrideParentMatrix;
 				temporaryWorldMatrixTransform *= localTransform();
+				if (culled()) {
+					return;
+				}
 				bool allowChildrenToDraw = true;
 				for (size_t i = 0; i < childComponents.size();++i) {
 					allowChildrenToDraw = childComponents[i]->draw() && allowChildrenToDraw;
@@ -104,14 +131,22 @@ namespace MV {
 		}
 
 		void Node::update(double a_delta, bool a_force) {
+			updateSerial(a_delta, a_force, true);
+		}
+
+		void Node::updateSerial(double a_delta, bool a_force, bool a_includeConcurrent) {
 			auto selfReference = shared_from_this(); //keep us alive no matter the update step
 			allowChangeCallNeeded = true;
 			if (allowUpdate || a_force) {
 				for (size_t i = 0; i < childComponents.size(); ++i) {
-					childComponents[i]->update(a_delta);
+					childComponents[i]->update(a_delta, a_includeConcurrent);
 				}
+				const bool concurrentChildren = a_includeConcurrent && updatePool && childNodes.size() > 1;
 				for (size_t i = 0; i < childNodes.size(); ++i) {
-					childNodes[i]->update(a_delta);
+					childNodes[i]->updateSerial(a_delta, false, a_includeConcurrent && !concurrentChildren);
+				}
+				if (concurrentChildren) {
+					updateChildrenConcurrently(a_delta);
 				}
 				if (rootTask) {
 					if (!rootTask->update(a_delta)) {
@@ -126,6 +161,68 @@ namespace MV {
 			}
 		}
 
+		void Node::updateConcurrent(double a_delta) {
+			if (allowUpdate) {
+				for (size_t i = 0; i < childComponents.size(); ++i) {
+					childComponents[i]->concurrentUpdateImplementation(a_delta);
+				}
+				for (size_t i = 0; i < childNodes.size(); ++i) {
+					childNodes[i]->updateConcurrent(a_delta);
+				}
+			}
+		}
+
+		namespace {
+			struct ConcurrentUpdate {
+				std::vector<std::shared_ptr<Node>> subtrees;
+				std::vector<DeferredChanges> changes;
+				std::vector<std::exception_ptr> failures;
+				std::atomic<size_t> next{ 0 };
+				std::atomic<size_t> finished{ 0 };
+			};
+		}
+
+		void Node::updateChildrenConcurrently(double a_delta) {
+			auto work = std::make_shared<ConcurrentUpdate>();
+			work->subtrees = childNodes;
+			work->changes.reserve(childNodes.size());
+			for (auto&& subtree : work->subtrees) {
+				work->changes.emplace_back(subtree.get());
+			}
+			work->failures.resize(childNodes.size());
+
+			//workers and this thread claim subtrees until none are left, a helper the pool starts late just finds nothing to do.
+			auto run = [work, a_delta]() {
+				for (size_t i = work->next++; i < work->subtrees.size(); i = work->next++) {
+					DeferredChanges::current() = &work->changes[i];
+					try {
+						work->subtrees[i]->updateConcurrent(a_delta);
+					} catch (...) {
+						work->failures[i] = std::current_exception();
+					}
+					DeferredChanges::current() = nullptr;
+					++work->finished;
+				}
+			};
+			const size_t helpers = std::min(updatePool->threads(), work->subtrees.size() - 1);
+			for (size_t i = 0; i < helpers; ++i) {
+				updatePool->task(std::function<void()>(run));
+			}
+			run();
+			while (work->finished < work->subtrees.size()) {
+				std::this_thread::yield();
+			}
+
+			for (auto&& changes : work->changes) {
+				changes.commit();
+			}
+			for (auto&& failure : work->failures) {
+				if (failure) {
+					std::rethrow_exception(failure);
+				}
+			}
+		}
+
 		void Node::drawUpdate(double a_delta) {
 			auto selfReference = shared_from_this(); //keep us alive no matter the update step
 			selfReference->update(a_delta);
@@ -133,7 +230,7 @@ namespace MV {
 		}
 
 		std::shared_ptr<Node> Node::make(Draw2D& a_draw2d, const std::string &a_id) {
-			return std::shared_ptr<Node>(new Node(a_draw2d, a_id));
+			return makePooled<Node>([&](void* a_memory) { return new (a_memory) Node(a_draw2d, a_id); });
 		}
 
 		std::shared_ptr<Node> Node::make(Draw2D& a_draw2d) {
@@ -145,15 +242,7 @@ namespace MV {
 		}
 
 		std::shared_ptr<Node> Node::load(const std::string &a_filename, MV::Services& a_services, const std::string &a_newNodeId, bool a_doPostLoadStep) {
-			auto contents = fileContents(a_filename);
-			require<ResourceException>(!contents.empty(), "File not found for Node::load: ", a_filename);
-
-			LoadOptions nodeOptions(a_services, a_doPostLoadStep);
-			std::shared_ptr<Node> result = MV::fromJson<std::shared_ptr<Node>>(contents, a_services);
-			if (!a_newNodeId.empty()) {
-				result->id(a_newNodeId);
-			}
-			return result;
+			return loadFile(a_filename, a_services, a_newNodeId, a_doPostLoadStep);
 		}
 
 		std::shared_ptr<Node> Node::loadBinary(const std::string &a_filename, MV::Services& a_services, bool a_doPostLoadStep) {
@@ -161,11 +250,24 @@ namespace MV {
 		}
 
 		std::shared_ptr<Node> Node::loadBinary(const std::string &a_filename, MV::Services& a_services, const std::string &a_newNodeId, bool a_doPostLoadStep) {
-			auto contents = fileContents(a_filename);
-			require<ResourceException>(!contents.empty(), "File not found for Node::load: ", a_filename);
+			return loadFile(a_filename, a_services, a_newNodeId, a_doPostLoadStep);
+		}
+
+		std::shared_ptr<Node> Node::loadFile(const std::string &a_filename, MV::Services& a_services, const std::string &a_newNodeId, bool a_doPostLoadStep) {
+			MappedFile file(a_filename);
+			require<ResourceException>(!file.empty(), "File not found for Node::load: ", a_filename);
 			LoadOptions nodeOptions(a_services, a_doPostLoadStep);
 
-			std::shared_ptr<Node> result = MV::fromBinaryString<std::shared_ptr<Node>>(contents, a_services);
+			//converted assets keep their .scene and .prefab names, so the format comes from the contents.
+			std::shared_ptr<Node> result;
+			auto firstCharacter = std::find_if(file.data(), file.data() + file.size(), [](char a_character) { return !std::isspace(static_cast<unsigned char>(a_character)); });
+			if (isSceneArchive(file.data(), file.size())) {
+				result = MV::fromSceneArchive<std::shared_ptr<Node>>(file.data(), file.size(), a_services);
+			} else if (firstCharacter != file.data() + file.size() && *firstCharacter == '{') {
+				result = MV::fromJsonData<std::shared_ptr<Node>>(file.data(), file.size(), a_services);
+			} else {
+				result = MV::fromBinaryData<std::shared_ptr<Node>>(file.data(), file.size(), a_services);
+			}
 			if (!a_newNodeId.empty()) {
 				result->id(a_newNodeId);
 			}
@@ -195,12 +297,10 @@ namespace MV {
 		}
 
 		std::shared_ptr<Node> Node::saveBinary(const std::string &a_filename, bool a_renameNodeToFile) {
-			return save(a_filename, a_renameNodeToFile ? fileNameFromPath(a_filename) : nodeId);
+			return saveBinary(a_filename, a_renameNodeToFile ? fileNameFromPath(a_filename) : nodeId);
 		}
 
 		std::shared_ptr<Node> Node::saveBinary(const std::string &a_filename, const std::string &a_newId) {
-			std::stringstream stream(fileContents(a_filename));
-
 			std::string oldId = nodeId;
 			auto oldParent = myParent;
 			SCOPE_EXIT{ nodeId = oldId; myParent = oldParent; };
@@ -208,11 +308,7 @@ namespace MV {
 			myParent = nullptr;
 
 			auto self = shared_from_this();
-			{
-				cereal::PortableBinaryOutputArchive archive(stream);
-				archive(self);
-			}
-			writeToFile(a_filename, stream.str());
+			writeToFile(a_filename, MV::toSceneArchive(self));
 			return self;
 		}
 
@@ -245,6 +341,9 @@ namespace MV {
 		}
 
 		std::shared_ptr<Node> Node::add(const std::shared_ptr<Node> &a_child, bool a_overrideSortDepth) {
+			if (DeferredChanges::defer([self = shared_from_this(), a_child, a_overrideSortDepth]() { self->add(a_child, a_overrideSortDepth); })) {
+				return shared_from_this();
+			}
 			Node* parentCheck = this;
 			while (parentCheck = parentCheck->myParent) {
 				MV::require<RangeException>(parentCheck != a_child.get(), "Adding [", a_child->id(), "] to [", id(), "] would result in a circular ownership!");
@@ -257,12 +356,22 @@ namespace MV {
 				}
 				insertSorted(childNodes, a_child);
 				a_child->myParent = this;
+				a_child->flatTransforms.reset();
+				invalidateComponentLookups();
+				invalidateTransformLayout();
+				invalidateChildVolumes();
+				a_child->nodeIndex.reset();
+				if (auto index = rootIndex()) {
+					index->insert(a_child.get());
+				}
 				if (a_child->ourCameraId != ourCameraId) {
 					a_child->cameraIdInternal(ourCameraId);
 				}
+				a_child->adoptChangeJournal(changeJournal);
 				a_child->onAddSignal(a_child);
 				onChildAddSignal(a_child);
 				a_child->markMatrixDirty(true);
+				a_child->markParentBoundsDirty();
 			}
 			return shared_from_this();
 		}
@@ -279,10 +388,20 @@ namespace MV {
 			auto foundNode = std::find_if(childNodes.begin(), childNodes.end(), [&](const std::shared_ptr<Node> &a_child){
 				return a_child->id() == a_id;
 			});
+			if (foundNode != childNodes.end() && DeferredChanges::defer([self = shared_from_this(), child = *foundNode]() { self->remove(child, false); })) {
+				return *foundNode;
+			}
 			if(foundNode != childNodes.end()){
 				auto self = shared_from_this();
 				auto child = *foundNode;
 				childNodes.erase(foundNode);
+				invalidateComponentLookups();
+				invalidateTransformLayout();
+				forgetChildBounds(child.get());
+				notifyChange(onChildBoundsChangeSignal, ChangeJournal::CHILD_BOUNDS);
+				markParentBoundsDirty();
+				unindexChild(child.get());
+				child->adoptChangeJournal(nullptr);
 				child->onRemoveSignal(child);
 				onChildRemoveSignal(self, child);
 				return child;
@@ -295,10 +414,20 @@ namespace MV {
 			auto foundNode = std::find_if(childNodes.begin(), childNodes.end(), [&](const std::shared_ptr<Node> &a_ourChild){
 				return a_ourChild == a_child;
 			});
+			if (foundNode != childNodes.end() && DeferredChanges::defer([self = shared_from_this(), a_child]() { self->remove(a_child, false); })) {
+				return a_child;
+			}
 			if(foundNode != childNodes.end()){
 				auto self = shared_from_this();
 				auto child = *foundNode;
 				childNodes.erase(foundNode);
+				invalidateComponentLookups();
+				invalidateTransformLayout();
+				forgetChildBounds(child.get());
+				notifyChange(onChildBoundsChangeSignal, ChangeJournal::CHILD_BOUNDS);
+				markParentBoundsDirty();
+				unindexChild(child.get());
+				child->adoptChangeJournal(nullptr);
 				child->onRemoveSignal(child);
 				onChildRemoveSignal(self, child);
 				return child;
@@ -309,12 +438,26 @@ namespace MV {
 
 		std::shared_ptr<Node> Node::clear() {
 			auto self = shared_from_this();
+			if (DeferredChanges::defer([self]() { self->clear(); })) {
+				return self;
+			}
+			if (childNodes.empty()) {
+				return self;
+			}
+			clearChangedChildBounds();
 			while(!childNodes.empty()){
 				auto childToRemove = *childNodes.begin();
 				childNodes.erase(childNodes.begin());
+				invalidateComponentLookups();
+				invalidateTransformLayout();
+				forgetChildBounds(childToRemove.get());
+				unindexChild(childToRemove.get());
+				childToRemove->adoptChangeJournal(nullptr);
 				childToRemove->onRemoveSignal(childToRemove);
 				onChildRemoveSignal(self, childToRemove);
 			}
+			notifyChange(onChildBoundsChangeSignal, ChangeJournal::CHILD_BOUNDS);
+			markParentBoundsDirty();
 			return self;
 		}
 
@@ -347,17 +490,8 @@ namespace MV {
 		}
 
 		std::shared_ptr<Node> Node::get(const std::string &a_id, bool a_throw) {
-			auto foundNode = std::find_if(childNodes.begin(), childNodes.end(), [&](const std::shared_ptr<Node> &a_child){
-				return a_child->id() == a_id;
-			});
-			if(foundNode != childNodes.end()){
-				return *foundNode;
-			}
-			for(auto&& child : childNodes){
-				auto found = child->get(a_id, false);
-				if(found){
-					return found;
-				}
+			if (auto found = find(a_id)) {
+				return found->shared_from_this();
 			}
 			require<ResourceException>(!a_throw, "Failed to get: [", a_id, "] from parent node: [", nodeId, "]");
 			return nullptr;
@@ -374,19 +508,60 @@ namespace MV {
 		}
 
 		bool Node::has(const std::string &a_id) const {
-			auto foundNode = std::find_if(childNodes.begin(), childNodes.end(), [&](const std::shared_ptr<Node> &a_child) {
-				return a_child->id() == a_id;
-			});
-			if (foundNode != childNodes.end()) {
-				return true;
+			return find(a_id) != nullptr;
+		}
+
+		Node* Node::find(const std::string &a_id) const {
+			if (childNodes.empty()) {
+				return nullptr;
+			}
+			const Node* rootNode = this;
+			while (rootNode->myParent) {
+				rootNode = rootNode->myParent;
+			}
+			if (!rootNode->nodeIndex) {
+				rootNode->nodeIndex = std::make_unique<NodeIndex>(const_cast<Node*>(rootNode));
+			}
+			Node* result = nullptr;
+			for (Node* candidate : rootNode->nodeIndex->find(a_id)) {
+				//save temporarily renames nodes without telling the index.
+				if (candidate->nodeId == a_id && candidate->descendantOf(this)) {
+					if (result) {
+						return search(a_id);
+					}
+					result = candidate;
+				}
+			}
+			return result;
+		}
+
+		Node* Node::search(const std::string &a_id) const {
+			for (auto&& child : childNodes) {
+				if (child->nodeId == a_id) {
+					return child.get();
+				}
 			}
 			for (auto&& child : childNodes) {
-				auto found = child->has(a_id);
-				if (found) {
+				if (auto found = child->search(a_id)) {
 					return found;
 				}
 			}
-			return false;
+			return nullptr;
+		}
+
+		NodeIndex* Node::rootIndex() const {
+			const Node* rootNode = this;
+			while (rootNode->myParent) {
+				rootNode = rootNode->myParent;
+			}
+			return rootNode->nodeIndex.get();
+		}
+
+		void Node::unindexChild(Node* a_child) {
+			if (auto index = rootIndex()) {
+				index->erase(a_child);
+			}
+			a_child->nodeIndex.reset();
 		}
 
 		bool Node::hasImmediate(const std::string &a_id) const {
@@ -402,7 +577,11 @@ namespace MV {
 				bool orderChanged = false;
 				{
 					ReSort sort(self);
+					auto oldId = nodeId;
 					nodeId = a_id;
+					if (auto index = rootIndex()) {
+						index->rename(this, oldId);
+					}
 					orderChanged = sort.insert();
 				}
 				if (orderChanged) {
@@ -446,7 +625,7 @@ namespace MV {
 			auto self = shared_from_this();
 			if (a_newPosition != translateTo) {
 				translateTo = a_newPosition;
-				onTransformChangeSignal(self);
+				transformChanged(self);
 			}
 			return self;
 		}
@@ -456,7 +635,7 @@ namespace MV {
 			auto newRotationRadians = toRadians(a_newRotation);
 			if (newRotationRadians != rotateTo) {
 				rotateTo = newRotationRadians;
-				onTransformChangeSignal(self);
+				transformChanged(self);
 			}
 			return self;
 		}
@@ -465,7 +644,7 @@ namespace MV {
 			auto self = shared_from_this();
 			if (a_newRotation != rotateTo) {
 				rotateTo = a_newRotation;
-				onTransformChangeSignal(self);
+				transformChanged(self);
 			}
 			return self;
 		}
@@ -474,7 +653,7 @@ namespace MV {
 			auto self = shared_from_this();
 			if (scaleTo != a_newScale) {
 				scaleTo = a_newScale;
-				onTransformChangeSignal(self);
+				transformChanged(self);
 			}
 			return self;
 		}
@@ -585,29 +764,269 @@ namespace MV {
 			}
 		}
 
+		namespace {
+			//a_inner is inside a_outer, true if it reaches any of a_outer's faces so a_outer may shrink without it.
+			bool touchesEdge(const BoxAABB<> &a_inner, const BoxAABB<> &a_outer) {
+				return a_inner.minPoint.x <= a_outer.minPoint.x || a_inner.minPoint.y <= a_outer.minPoint.y || a_inner.minPoint.z <= a_outer.minPoint.z ||
+					a_inner.maxPoint.x >= a_outer.maxPoint.x || a_inner.maxPoint.y >= a_outer.maxPoint.y || a_inner.maxPoint.z >= a_outer.maxPoint.z;
+			}
+		}
+
 		void Node::recalculateChildBounds() {
 			recalculateChildBoundsCalls++;
-			{
-				dirtyChildBounds = false;
-				if (!childNodes.empty()) {
-					localChildBounds = childNodes[0]->bounds();
-					for (size_t i = 1; i < childNodes.size(); ++i) {
-						if (childNodes[i]->selfVisible()) {
-							auto nodeBounds = childNodes[i]->bounds();
-							if (!nodeBounds.empty()) {
-								localChildBounds.expandWith(nodeBounds);
-							}
-						}
+			auto oldBounds = localChildBounds;
+			if (fullChildBoundsPass || childNodes.empty() || childNodes[0].get() != childBoundsSeed) {
+				gatherChildBounds();
+			} else {
+				//children that grew or moved inside the union are folded in, one that shrank off an edge needs everyone.
+				//children recalculating here can queue more, they are folded in by this same loop.
+				for (size_t i = 0; i < changedChildBounds.size() && !fullChildBoundsPass; ++i) {
+					auto* child = changedChildBounds[i];
+					if (!child) {
+						continue;
+					}
+					BoxAABB<> contribution;
+					bool contributes = childBoundsContribution(child, contribution);
+					if (child->contributesToParentBounds && (!contributes || !contribution.contains(child->parentBoundsContribution, true)) &&
+						touchesEdge(child->parentBoundsContribution, localChildBounds)) {
+						fullChildBoundsPass = true;
+					} else if (contributes) {
+						localChildBounds.expandWith(contribution);
 					}
+					child->parentBoundsContribution = contribution;
+					child->contributesToParentBounds = contributes;
+				}
+				if (fullChildBoundsPass) {
+					gatherChildBounds();
 				} else {
-					localChildBounds = BoxAABB<>();
+					clearChangedChildBounds();
 				}
 			}
-			markParentBoundsDirty();
+			if (localChildBounds != oldBounds) {
+				markParentBoundsDirty();
+			}
+		}
+
+		void Node::gatherChildBounds() {
+			fullChildBoundsPass = false;
+			if (childNodes.empty()) {
+				localChildBounds = BoxAABB<>();
+				childBoundsSeed = nullptr;
+			} else {
+				childBoundsSeed = childNodes[0].get();
+				for (size_t i = 0; i < childNodes.size(); ++i) {
+					auto* child = childNodes[i].get();
+					child->contributesToParentBounds = childBoundsContribution(child, child->parentBoundsContribution);
+					if (i == 0) {
+						localChildBounds = child->parentBoundsContribution;
+					} else if (child->contributesToParentBounds) {
+						localChildBounds.expandWith(child->parentBoundsContribution);
+					}
+				}
+			}
+			//children recalculating above queue themselves again, what we just gathered already reflects them.
+			clearChangedChildBounds();
+		}
+
+		void Node::clearChangedChildBounds() {
+			for (auto&& child : changedChildBounds) {
+				if (child) {
+					child->queuedInParentBounds = false;
+				}
+			}
+			changedChildBounds.clear();
+			dirtyChildBounds = false;
+		}
+
+		bool Node::childBoundsContribution(Node* a_child, BoxAABB<> &a_contribution) {
+			//our first child always counts, even hidden or empty, the rest only when visible with some size.
+			if (!childNodes.empty() && a_child == childNodes[0].get()) {
+				a_contribution = a_child->bounds();
+				return true;
+			}
+			if (a_child->selfVisible()) {
+				a_contribution = a_child->bounds();
+				return !a_contribution.empty();
+			}
+			a_contribution = BoxAABB<>();
+			return false;
+		}
+
+		void Node::childBoundsChanged(Node* a_child) {
+			dirtyChildBounds = true;
+			if (!fullChildBoundsPass && !a_child->queuedInParentBounds) {
+				if (changedChildBounds.size() * 2 >= childNodes.size()) {
+					//most of our children changed, gathering them all is cheaper than testing each against the union.
+					fullChildBoundsPass = true;
+				} else {
+					a_child->queuedInParentBounds = true;
+					changedChildBounds.push_back(a_child);
+				}
+			}
+		}
+
+		void Node::forgetChildBounds(Node* a_child) {
+			if (a_child->queuedInParentBounds) {
+				//nulled rather than erased, recalculateChildBounds may be walking the queue.
+				*std::find(changedChildBounds.begin(), changedChildBounds.end(), a_child) = nullptr;
+				a_child->queuedInParentBounds = false;
+			}
+			if (a_child == childBoundsSeed || (a_child->contributesToParentBounds && touchesEdge(a_child->parentBoundsContribution, localChildBounds))) {
+				fullChildBoundsPass = true;
+			}
+			a_child->contributesToParentBounds = false;
+			invalidateChildVolumes();
+			dirtyChildBounds = true;
+			dirtyCullBounds = true;
+		}
+
+		BoxAABB<> Node::boundsInParent() {
+			auto nodeBounds = bounds();
+			auto transform = localTransform();
+			BoxAABB<> result(transform * nodeBounds.minPoint);
+			for (int corner = 1; corner < 8; ++corner) {
+				result.expandWith(transform * Point<>(
+					(corner & 1) ? nodeBounds.maxPoint.x : nodeBounds.minPoint.x,
+					(corner & 2) ? nodeBounds.maxPoint.y : nodeBounds.minPoint.y,
+					(corner & 4) ? nodeBounds.maxPoint.z : nodeBounds.minPoint.z));
+			}
+			return result;
+		}
+
+		std::vector<std::shared_ptr<Node>> Node::childrenAt(const Point<> &a_localPoint) {
+			std::vector<std::shared_ptr<Node>> result;
+			if (childVolumeHierarchy) {
+				childVolumeHierarchy->query(a_localPoint, result);
+			} else {
+				for (auto&& child : childNodes) {
+					if (child->selfVisible() && !child->bounds().empty() && child->boundsInParent().contains(a_localPoint)) {
+						result.push_back(child);
+					}
+				}
+			}
+			return result;
+		}
+
+		std::vector<std::shared_ptr<Node>> Node::childrenIntersecting(const BoxAABB<> &a_localBounds) {
+			std::vector<std::shared_ptr<Node>> result;
+			if (childVolumeHierarchy) {
+				childVolumeHierarchy->query(a_localBounds, result);
+			} else {
+				for (auto&& child : childNodes) {
+					if (child->selfVisible() && !child->bounds().empty() && child->boundsInParent().collides(a_localBounds)) {
+						result.push_back(child);
+					}
+				}
+			}
+			return result;
+		}
+
+		std::shared_ptr<Node> Node::childVolumes(bool a_enabled) {
+			if (a_enabled && !childVolumeHierarchy) {
+				childVolumeHierarchy = std::make_unique<ChildVolumes>(this);
+			} else if (!a_enabled) {
+				childVolumeHierarchy.reset();
+			}
+			return shared_from_this();
+		}
+
+		bool Node::culled() {
+			if (draw2d.headless()) {
+				return false;
+			}
+			if (dirtyCullBounds) {
+				recalculateCullBounds();
+			}
+			if (cullBoundsUnbounded || localCullBounds.empty()) {
+				return false;
+			}
+			//in clip space the camera sees [-1, 1] on both axes whatever the camera or render target.
+			auto clipTransform = draw2d.cameraProjectionMatrix(ourCameraId) * worldTransform();
+			Point<> minimum, maximum;
+			for (int corner = 0; corner < 8; ++corner) {
+				auto projected = clipTransform * Point<>(
+					(corner & 1) ? localCullBounds.maxPoint.x : localCullBounds.minPoint.x,
+					(corner & 2) ? localCullBounds.maxPoint.y : localCullBounds.minPoint.y,
+					(corner & 4) ? localCullBounds.maxPoint.z : localCullBounds.minPoint.z);
+				if (corner == 0) {
+					minimum = maximum = projected;
+				} else {
+					minimum.x = std::min(minimum.x, projected.x); minimum.y = std::min(minimum.y, projected.y);
+					maximum.x = std::max(maximum.x, projected.x); maximum.y = std::max(maximum.y, projected.y);
+				}
+			}
+			if (maximum.x < -1.0f || minimum.x > 1.0f || maximum.y < -1.0f || minimum.y > 1.0f) {
+				++culledNodeDraws;
+				return true;
+			}
+			return false;
+		}
+
+		void Node::recalculateCullBounds() {
+			localCullBounds = BoxAABB<>();
+			cullBoundsUnbounded = false;
+			bool hasBounds = false;
+			auto include = [&](const BoxAABB<> &a_bounds) {
+				if (!a_bounds.empty()) {
+					if (hasBounds) {
+						localCullBounds.expandWith(a_bounds);
+					} else {
+						localCullBounds = a_bounds;
+						hasBounds = true;
+					}
+				}
+			};
+			for (auto&& component : childComponents) {
+				if (!component->cullable()) {
+					cullBoundsUnbounded = true;
+				}
+				include(component->cullBounds());
+			}
+			for (auto&& child : childNodes) {
+				if (!child->allowDraw) {
+					continue;
+				}
+				if (child->dirtyCullBounds) {
+					child->recalculateCullBounds();
+				}
+				//a child drawn by another camera can't be projected with ours, so it never lets us cull.
+				if (child->cullBoundsUnbounded || child->ourCameraId != ourCameraId) {
+					cullBoundsUnbounded = true;
+				} else if (!child->localCullBounds.empty()) {
+					auto childTransform = child->localTransform();
+					auto& childBounds = child->localCullBounds;
+					for (int corner = 0; corner < 8; ++corner) {
+						auto transformed = childTransform * Point<>(
+							(corner & 1) ? childBounds.maxPoint.x : childBounds.minPoint.x,
+							(corner & 2) ? childBounds.maxPoint.y : childBounds.minPoint.y,
+							(corner & 4) ? childBounds.maxPoint.z : childBounds.minPoint.z);
+						if (!hasBounds) {
+							localCullBounds = BoxAABB<>(transformed);
+							hasBounds = true;
+						} else {
+							localCullBounds.expandWith(transformed);
+						}
+					}
+				}
+			}
+			//children recalculating their matrices above mark us dirty again, what we just gathered already reflects them.
+			dirtyCullBounds = false;
 		}
 
 		void Node::recalculateMatrix() {
 			bool eitherMatrixUpdated = localMatrixDirty || worldMatrixDirty;
+			recalculateLocalMatrix();
+			if (eitherMatrixUpdated) {
+				if (myParent) {
+					auto parentWorld = myParent->worldTransform();
+					recalculateWorldMatrix(&parentWorld);
+				} else {
+					recalculateWorldMatrix(nullptr);
+				}
+			}
+		}
+
+		void Node::recalculateLocalMatrix() {
 			if (localMatrixDirty) {
 				localMatrixDirty = false;
 				localMatrixTransform.makeIdentity();
@@ -622,19 +1041,22 @@ namespace MV {
 					localMatrixTransform.scale(scaleTo.x, scaleTo.y, scaleTo.z);
 				}
 
-				markParentBoundsDirty();
+				markParentBoundsDirty(false);
 			}
+		}
 
-			if (eitherMatrixUpdated) {
-				recalculateMatrixCalls++;
-				worldMatrixDirty = false;
-				if (myParent) {
-					worldMatrixTransform = myParent->worldTransform() * localMatrixTransform;
-					parentAccumulatedAlpha = myParent->parentAccumulatedAlpha * nodeAlpha;
-				} else {
-					worldMatrixTransform = localMatrixTransform;
-					parentAccumulatedAlpha = nodeAlpha;
-				}
+		void Node::recalculateWorldMatrix(const TransformMatrix* a_parentWorld) {
+			recalculateMatrixCalls++;
+			worldMatrixDirty = false;
+			if (a_parentWorld) {
+				worldMatrixTransform = *a_parentWorld * localMatrixTransform;
+				parentAccumulatedAlpha = myParent->parentAccumulatedAlpha * nodeAlpha;
+			} else {
+				worldMatrixTransform = localMatrixTransform;
+				parentAccumulatedAlpha = nodeAlpha;
+			}
+			if (transformHierarchy) {
+				transformHierarchy->worldMatrices[transformSlot] = worldMatrixTransform;
 			}
 		}
 
@@ -687,14 +1109,17 @@ namespace MV {
 						myParent = nullptr;
 					}
 					onParentAlphaChangeSignal = nullptr;
-					onTransformChangeSignal(a_self);
+					transformChanged(a_self);
 					recalculateAlpha();
 				}
 				safeOnChange();
 			});
 			onTransformChange.connect("SELF", [&](const std::shared_ptr<Node> &a_self) {
-				markMatrixDirty();
-				safeOnChange();
+				//deferred trees already did this in transformChanged.
+				if (!changeJournal) {
+					markMatrixDirty();
+					safeOnChange();
+				}
 			});
 			
 			auto onChangeCallback = [blockOnChange](const std::shared_ptr<Node> &a_self) {
@@ -719,13 +1144,24 @@ namespace MV {
 			});
 
 			onChange.connect("SELF", [&](const std::shared_ptr<Node> &a_self) {
-				if (a_self->myParent) {
+				//deferred trees journal the change for every ancestor up front.
+				if (a_self->myParent && !a_self->changeJournal) {
 					a_self->myParent->onChangeSignal(myParent->shared_from_this());
 				}
 			});
 		}
 
 		void Node::safeOnChange() {
+			if (auto* deferred = DeferredChanges::current()) {
+				deferred->change(this, ChangeJournal::CHANGE);
+				return;
+			}
+			if (changeJournal) {
+				//an ancestor with a pending change already has it pending all the way up.
+				for (Node* current = this; current && current->changeJournal == changeJournal && changeJournal->record(current, ChangeJournal::CHANGE); current = current->myParent) {
+				}
+				return;
+			}
 			std::shared_ptr<Node> safeguard = shared_from_this();
 			if (!inOnChange) {
 				SCOPE_EXIT{ inOnChange = false; };
@@ -898,6 +1334,9 @@ namespace MV {
 				worldMatrixTransform = localMatrixTransform;
 				parentAccumulatedAlpha = nodeAlpha;
 			}
+			if (transformHierarchy) {
+				transformHierarchy->worldMatrices[transformSlot] = worldMatrixTransform;
+			}
 		}
 
 		void Node::quietLocalAndChildMatrixFix() {
@@ -934,11 +1373,7 @@ namespace MV {
 		}
 
 		std::vector<Point<>> Node::localFromScreen(const std::vector<Point<int>> &a_screen) {
-			std::vector<Point<>> processed;
-			for (const Point<int>& point : a_screen) {
-				processed.push_back(draw2d.localFromScreen(point, ourCameraId, worldTransform()));
-			}
-			return processed;
+			return draw2d.localFromScreen(a_screen, ourCameraId, worldTransform());
 		}
 
 		Point<> Node::localFromWorld(const Point<> &a_world) {
@@ -946,10 +1381,7 @@ namespace MV {
 		}
 
 		std::vector<Point<>> Node::localFromWorld(std::vector<Point<>> a_world) {
-			for (Point<>& point : a_world) {
-				point = draw2d.localFromWorld(point, ourCameraId, worldTransform());
-			}
-			return a_world;
+			return draw2d.localFromWorld(std::move(a_world), ourCameraId, worldTransform());
 		}
 
 		Point<int> Node::screenFromLocal(const Point<> &a_local) {
@@ -957,11 +1389,7 @@ namespace MV {
 		}
 
 		std::vector<Point<int>> Node::screenFromLocal(const std::vector<Point<>> &a_local) {
-			std::vector<Point<int>> processed;
-			for (const Point<>& point : a_local) {
-				processed.push_back(draw2d.screenFromLocal(point, ourCameraId, worldTransform()));
-			}
-			return processed;
+			return draw2d.screenFromLocal(a_local, ourCameraId, worldTransform());
 		}
 
 		Point<> Node::worldFromLocal(const Point<> &a_local) {
@@ -969,10 +1397,7 @@ namespace MV {
 		}
 
 		std::vector<Point<>> Node::worldFromLocal(std::vector<Point<>> a_local) {
-			for (Point<>& point : a_local) {
-				point = draw2d.worldFromLocal(point, ourCameraId, worldTransform());
-			}
-			return a_local;
+			return draw2d.worldFromLocal(std::move(a_local), ourCameraId, worldTransform());
 		}
 
 		std::shared_ptr<Node> Node::screenPosition(const Point<int> &a_newPosition) {
@@ -1044,15 +1469,20 @@ namespace MV {
 		void Node::markMatrixDirty(bool a_rootCall) {
 			if (a_rootCall) {
 				localMatrixDirty = true;
-				
-				markBoundsDirty();
+
+				//our bounds are in our own space so moving doesn't change them, only where our parents see us.
+				markParentBoundsDirty(false);
+				notifyChange(onLocalBoundsChangeSignal, ChangeJournal::LOCAL_BOUNDS);
 			} else {
 				worldMatrixDirty = true;
 			}
+			if (transformHierarchy) {
+				transformHierarchy->dirty[transformSlot] = 1;
+			}
 			for (auto&& child : *this) {
 				child->markMatrixDirty(false);
 			}
-			onMatrixDirtySignal(shared_from_this());
+			notifyChange(onMatrixDirtySignal, ChangeJournal::MATRIX_DIRTY);
 		}
 
 		std::string Node::getUniqueId(const std::string &a_original) const {
@@ -1112,6 +1542,7 @@ namespace MV {
 			for (auto&& childNode : childNodes) {
 				if (childNode->serializable()) {
 					result->childNodes.push_back(childNode->cloneInternal(result));
+					result->invalidateComponentLookups();
 				}
 			}
 
@@ -1122,6 +1553,8 @@ namespace MV {
 			}
 
 			result->quietLocalAndChildMatrixFix();
+			//components may have searched the clone before all of its children were in place.
+			result->nodeIndex.reset();
 
 			if (a_parent) {
 				a_parent->add(result);
@@ -1156,6 +1589,7 @@ namespace MV {
 			for (auto&& childNode : childNodes) {
 				if (childNode->serializable()) {
 					result->childNodes.push_back(childNode->cloneInternal(result));
+					result->invalidateComponentLookups();
 				}
 			}
 
@@ -1179,15 +1613,525 @@ namespace MV {
 			}
 		}
 
-		void Node::markParentBoundsDirty() {
+		void Node::markParentBoundsDirty(bool a_boundsChanged) {
+			auto* deferred = DeferredChanges::current();
+			Node* changed = this;
 			auto* currentParent = myParent;
 			while (currentParent) {
-				currentParent->dirtyChildBounds = true;
-				currentParent->onChildBoundsChangeSignal(currentParent->shared_from_this());
+				if (deferred && deferred->outside(currentParent)) {
+					deferred->parentBoundsChanged();
+					return;
+				}
+				if (a_boundsChanged) {
+					currentParent->childBoundsChanged(changed);
+				}
+				currentParent->dirtyCullBounds = true;
+				if (currentParent->childVolumeHierarchy) {
+					currentParent->childVolumeHierarchy->refit(changed);
+				}
+				currentParent->notifyChange(currentParent->onChildBoundsChangeSignal, ChangeJournal::CHILD_BOUNDS);
+				changed = currentParent;
 				currentParent = currentParent->myParent;
 			}
 		}
 
+		void Node::transformChanged(const std::shared_ptr<Node> &a_self) {
+			if (auto* deferred = DeferredChanges::current()) {
+				//our subtree still sees the move right away, everyone else hears about it at the commit.
+				markMatrixDirty();
+				deferred->change(this, ChangeJournal::TRANSFORM);
+				return;
+			}
+			if (changeJournal) {
+				markMatrixDirty();
+				changeJournal->record(this, ChangeJournal::TRANSFORM);
+				safeOnChange();
+			} else {
+				onTransformChangeSignal(a_self);
+			}
+		}
+
+		void Node::replayChanges(uint8_t a_changes) {
+			auto self = shared_from_this();
+			if (a_changes & ChangeJournal::TRANSFORM) {
+				transformChanged(self);
+			}
+			if (a_changes & ChangeJournal::MATRIX_DIRTY) {
+				notifyChange(onMatrixDirtySignal, ChangeJournal::MATRIX_DIRTY);
+			}
+			if (a_changes & ChangeJournal::LOCAL_BOUNDS) {
+				notifyChange(onLocalBoundsChangeSignal, ChangeJournal::LOCAL_BOUNDS);
+			}
+			if (a_changes & ChangeJournal::CHILD_BOUNDS) {
+				notifyChange(onChildBoundsChangeSignal, ChangeJournal::CHILD_BOUNDS);
+			}
+			if (a_changes & ChangeJournal::CHANGE) {
+				safeOnChange();
+			}
+		}
+
+		void Node::adoptChangeJournal(const std::shared_ptr<ChangeJournal> &a_journal) {
+			if (changeJournal != a_journal) {
+				changeJournal = a_journal;
+				//anything pending in our old tree is reported by the new one instead.
+				auto pending = pendingChanges;
+				pendingChanges = 0;
+				if (changeJournal && pending) {
+					changeJournal->record(this, pending);
+				}
+				for (auto&& child : childNodes) {
+					child->adoptChangeJournal(a_journal);
+				}
+			}
+		}
+
+		std::shared_ptr<Node> Node::deferChanges(bool a_defer) {
+			auto self = shared_from_this();
+			require<ResourceException>(!myParent, "deferChanges is only valid on a root node: [", nodeId, "]");
+			if (a_defer && !changeJournal) {
+				adoptChangeJournal(std::make_shared<ChangeJournal>());
+			} else if (!a_defer && changeJournal) {
+				changeJournal->flush();
+				adoptChangeJournal(nullptr);
+			}
+			return self;
+		}
+
+		void Node::flushChanges() {
+			if (changeJournal) {
+				changeJournal->flush();
+			}
+		}
+
+		std::shared_ptr<Node> Node::flattenTransforms(bool a_flatten) {
+			auto self = shared_from_this();
+			require<ResourceException>(!myParent, "flattenTransforms is only valid on a root node: [", nodeId, "]");
+			if (a_flatten && !flatTransforms) {
+				flatTransforms = std::make_unique<TransformHierarchy>(this);
+			} else if (!a_flatten) {
+				flatTransforms.reset();
+			}
+			return self;
+		}
+
+		/**************************\
+		| ---TransformHierarchy--- |
+		\**************************/
+
+		TransformHierarchy::~TransformHierarchy() {
+			invalidate();
+		}
+
+		void TransformHierarchy::invalidate() {
+			for (auto&& node : nodes) {
+				node->transformHierarchy = nullptr;
+				node->transformSlot = -1;
+			}
+			nodes.clear();
+			parents.clear();
+			worldMatrices.clear();
+			dirty.clear();
+		}
+
+		void TransformHierarchy::update() {
+			if (nodes.empty()) {
+				rebuild();
+			}
+			for (size_t i = 0; i < nodes.size(); ++i) {
+				if (dirty[i]) {
+					dirty[i] = 0;
+					Node* node = nodes[i];
+					//anything already recalculated lazily since it was marked has stored its result here.
+					if (node->localMatrixDirty || node->worldMatrixDirty) {
+						node->recalculateLocalMatrix();
+						if (nodes.empty()) {
+							//a bounds observer restructured the tree, whatever is left recalculates lazily.
+							return;
+						}
+						node->recalculateWorldMatrix(parents[i] < 0 ? nullptr : &worldMatrices[parents[i]]);
+					}
+				}
+			}
+		}
+
+		void TransformHierarchy::rebuild() {
+			pending.emplace_back(root, -1);
+			while (!pending.empty()) {
+				auto current = pending.back();
+				pending.pop_back();
+				Node* node = current.first;
+				auto slot = static_cast<int32_t>(nodes.size());
+				nodes.push_back(node);
+				parents.push_back(current.second);
+				worldMatrices.push_back(node->worldMatrixTransform);
+				dirty.push_back(node->localMatrixDirty || node->worldMatrixDirty);
+				node->transformHierarchy = this;
+				node->transformSlot = slot;
+				for (auto child = node->childNodes.rbegin(); child != node->childNodes.rend(); ++child) {
+					pending.emplace_back(child->get(), slot);
+				}
+			}
+		}
+
+		/********************\
+		| ---ChildVolumes--- |
+		\********************/
+
+		void ChildVolumes::query(const Point<> &a_localPoint, std::vector<std::shared_ptr<Node>> &a_results) {
+			query([&](const BoxAABB<> &a_bounds) { return a_bounds.contains(a_localPoint); }, a_results);
+		}
+
+		void ChildVolumes::query(const BoxAABB<> &a_localBounds, std::vector<std::shared_ptr<Node>> &a_results) {
+			query([&](const BoxAABB<> &a_bounds) { return a_bounds.collides(a_localBounds); }, a_results);
+		}
+
+		template <typename T>
+		void ChildVolumes::query(const T &a_test, std::vector<std::shared_ptr<Node>> &a_results) {
+			update();
+			if (volumes.empty()) {
+				return;
+			}
+			pending.push_back(0);
+			while (!pending.empty()) {
+				auto index = pending.back();
+				pending.pop_back();
+				auto& volume = volumes[index];
+				if (!volume.hasBounds || !a_test(volume.bounds)) {
+					continue;
+				}
+				if (volume.count == 0) {
+					pending.push_back(volume.right);
+					pending.push_back(index + 1);
+				} else {
+					for (int32_t i = volume.first; i < volume.first + volume.count; ++i) {
+						if (entries[i].hittable && a_test(entries[i].bounds)) {
+							a_results.push_back(entries[i].node->shared_from_this());
+						}
+					}
+				}
+			}
+			std::stable_sort(a_results.begin(), a_results.end(), [](const std::shared_ptr<Node> &a_lhs, const std::shared_ptr<Node> &a_rhs) {
+				return a_lhs->sortDepth < a_rhs->sortDepth;
+			});
+		}
+
+		void ChildVolumes::refit(Node* a_child) {
+			if (stale || dirty) {
+				return;
+			}
+			auto slot = a_child->childVolumeSlot;
+			if (slot < 0 || slot >= static_cast<int32_t>(entries.size()) || entries[slot].node != a_child) {
+				stale = true;
+			} else if (!entries[slot].queued) {
+				if (changedEntries.size() * 2 >= entries.size()) {
+					//most children moved, refitting everything beats walking up from each of them.
+					dirty = true;
+				} else {
+					entries[slot].queued = true;
+					changedEntries.push_back(slot);
+				}
+			}
+		}
+
+		void ChildVolumes::update() {
+			if (!stale && !dirty) {
+				//children recalculating their matrices below can queue more, they are refit by this same loop.
+				for (size_t i = 0; i < changedEntries.size() && !stale && !dirty; ++i) {
+					auto& entry = entries[changedEntries[i]];
+					updateEntry(entry);
+					for (auto index = entry.leaf; index >= 0 && !volumes[index].queued; index = volumes[index].parent) {
+						volumes[index].queued = true;
+						changedVolumes.push_back(index);
+					}
+				}
+				if (!stale && !dirty) {
+					//sides always come after their branch, so refitting from the back finishes both sides first.
+					std::sort(changedVolumes.begin(), changedVolumes.end(), std::greater<int32_t>());
+					for (auto index : changedVolumes) {
+						refitVolume(index);
+					}
+				}
+				clearChanges();
+				if (!stale && !dirty) {
+					return;
+				}
+			}
+			if (stale) {
+				clearChanges();
+				entries.clear();
+				volumes.clear();
+				for (auto&& child : owner->childNodes) {
+					entries.push_back({ child.get(), BoxAABB<>(), false, false, -1 });
+					updateEntry(entries.back());
+				}
+				if (!entries.empty()) {
+					build(0, -1, static_cast<int32_t>(entries.size()));
+				}
+			} else {
+				for (auto&& entry : entries) {
+					updateEntry(entry);
+				}
+			}
+			for (auto index = static_cast<int32_t>(volumes.size()) - 1; index >= 0; --index) {
+				refitVolume(index);
+			}
+			//children recalculating their matrices above ask for a refit again, their boxes are already current.
+			clearChanges();
+			stale = false;
+			dirty = false;
+		}
+
+		void ChildVolumes::clearChanges() {
+			for (auto slot : changedEntries) {
+				entries[slot].queued = false;
+			}
+			for (auto index : changedVolumes) {
+				volumes[index].queued = false;
+			}
+			changedEntries.clear();
+			changedVolumes.clear();
+		}
+
+		void ChildVolumes::updateEntry(Entry &a_entry) {
+			a_entry.bounds = a_entry.node->boundsInParent();
+			a_entry.hittable = a_entry.node->selfVisible() && !a_entry.node->bounds().empty();
+		}
+
+		int32_t ChildVolumes::build(int32_t a_first, int32_t a_parent, int32_t a_count) {
+			auto index = static_cast<int32_t>(volumes.size());
+			volumes.push_back({ BoxAABB<>(), false, false, a_first, a_count, -1, a_parent });
+			if (a_count <= LeafSize) {
+				for (int32_t i = a_first; i < a_first + a_count; ++i) {
+					entries[i].leaf = index;
+					entries[i].node->childVolumeSlot = i;
+				}
+				return index;
+			}
+			//split at the median center along whichever axis the centers spread furthest.
+			auto center = [](const Entry &a_entry) { return (a_entry.bounds.minPoint + a_entry.bounds.maxPoint) / 2.0f; };
+			BoxAABB<> centers(center(entries[a_first]));
+			for (int32_t i = a_first + 1; i < a_first + a_count; ++i) {
+				centers.expandWith(center(entries[i]));
+			}
+			bool splitX = centers.width() >= centers.height();
+			auto begin = entries.begin() + a_first;
+			std::nth_element(begin, begin + a_count / 2, begin + a_count, [&](const Entry &a_lhs, const Entry &a_rhs) {
+				return splitX ? center(a_lhs).x < center(a_rhs).x : center(a_lhs).y < center(a_rhs).y;
+			});
+			volumes[index].count = 0;
+			build(a_first, index, a_count / 2);
+			auto right = build(a_first + a_count / 2, index, a_count - a_count / 2);
+			volumes[index].right = right;
+			return index;
+		}
+
+		void ChildVolumes::refitVolume(int32_t a_index) {
+			auto& volume = volumes[a_index];
+			volume.hasBounds = false;
+			auto include = [&](const BoxAABB<> &a_bounds) {
+				if (volume.hasBounds) {
+					volume.bounds.expandWith(a_bounds);
+				} else {
+					volume.bounds = a_bounds;
+					volume.hasBounds = true;
+				}
+			};
+			if (volume.count == 0) {
+				for (auto side : { a_index + 1, volume.right }) {
+					if (volumes[side].hasBounds) {
+						include(volumes[side].bounds);
+					}
+				}
+			} else {
+				for (int32_t i = volume.first; i < volume.first + volume.count; ++i) {
+					if (entries[i].hittable) {
+						include(entries[i].bounds);
+					}
+				}
+			}
+		}
+
+		/*********************\
+		| ---ChangeJournal--- |
+		\*********************/
+
+		bool ChangeJournal::record(Node* a_node, uint8_t a_changes) {
+			auto previous = a_node->pendingChanges;
+			a_node->pendingChanges |= a_changes;
+			if (previous == 0) {
+				entries.push_back(a_node->weak_from_this());
+			}
+			return (previous & a_changes) != a_changes;
+		}
+
+		void ChangeJournal::flush() {
+			if (inFlush) {
+				return;
+			}
+			inFlush = true;
+			SCOPE_EXIT{ inFlush = false; };
+
+			auto fire = [](const std::shared_ptr<Node> &a_node, uint8_t a_change, Signal<Node::BasicSignature> &a_signal) {
+				if (a_node->pendingChanges & a_change) {
+					a_node->pendingChanges &= ~a_change;
+					try {
+						a_signal(a_node);
+					} catch (std::exception &e) {
+						std::cerr << "ChangeJournal::flush callback exception: " << e.what() << std::endl;
+					}
+				}
+			};
+
+			for (int pass = 0; pass < MaximumFlushPasses && !entries.empty(); ++pass) {
+				std::vector<std::pair<size_t, std::shared_ptr<Node>>> nodes;
+				nodes.reserve(entries.size());
+				for (auto&& entry : entries) {
+					if (auto node = entry.lock()) {
+						size_t depth = 0;
+						for (Node* current = node->myParent; current; current = current->myParent) {
+							++depth;
+						}
+						nodes.emplace_back(depth, std::move(node));
+					}
+				}
+				entries.clear();
+				std::stable_sort(nodes.begin(), nodes.end(), [](const auto &a_lhs, const auto &a_rhs) {
+					return a_lhs.first < a_rhs.first;
+				});
+
+				//onChange goes last so the changes it reports have all been announced first.
+				for (auto&& node : nodes) {
+					fire(node.second, TRANSFORM, node.second->onTransformChangeSignal);
+					fire(node.second, MATRIX_DIRTY, node.second->onMatrixDirtySignal);
+					fire(node.second, LOCAL_BOUNDS, node.second->onLocalBoundsChangeSignal);
+					fire(node.second, CHILD_BOUNDS, node.second->onChildBoundsChangeSignal);
+				}
+				for (auto&& node : nodes) {
+					fire(node.second, CHANGE, node.second->onChangeSignal);
+					if (node.second->pendingChanges != 0) {
+						entries.push_back(node.second);
+					}
+				}
+			}
+			if (!entries.empty()) {
+				MV::warning("ChangeJournal::flush: observers are still changing the scene after ", MaximumFlushPasses, " passes, the rest waits for the next flush.");
+			}
+		}
+
+		/***********************\
+		| ---DeferredChanges--- |
+		\***********************/
+
+		void DeferredChanges::change(Node* a_node, uint8_t a_changes) {
+			//a node tends to report several changes in a row, those share one entry.
+			if (!changes.empty() && changes.back().node == a_node) {
+				changes.back().changes |= a_changes;
+			} else {
+				changes.push_back({ a_node, a_node->weak_from_this(), a_changes });
+			}
+		}
+
+		bool DeferredChanges::outside(const Node* a_node) const {
+			return a_node == subtree->myParent;
+		}
+
+		void DeferredChanges::commit() {
+			for (auto&& entry : changes) {
+				if (auto node = entry.handle.lock()) {
+					node->replayChanges(entry.changes);
+				}
+			}
+			changes.clear();
+			if (parentBoundsDirty) {
+				parentBoundsDirty = false;
+				subtree->markParentBoundsDirty();
+			}
+			auto pending = std::move(actions);
+			actions.clear();
+			for (auto&& action : pending) {
+				action();
+			}
+		}
+
+		/*****************\
+		| ---NodeIndex--- |
+		\*****************/
+
+		std::atomic<uint64_t> NodeIndex::nextGeneration{ 0 };
+
+		NodeIndex::NodeIndex(Node* a_root) {
+			insert(a_root);
+		}
+
+		void NodeIndex::insert(Node* a_subtree) {
+			link(a_subtree);
+			for (auto&& child : a_subtree->childNodes) {
+				insert(child.get());
+			}
+		}
+
+		void NodeIndex::erase(Node* a_subtree) {
+			unlink(a_subtree, a_subtree->nodeId);
+			for (auto&& child : a_subtree->childNodes) {
+				erase(child.get());
+			}
+		}
+
+		void NodeIndex::rename(Node* a_node, const std::string &a_oldId) {
+			unlink(a_node, a_oldId);
+			link(a_node);
+		}
+
+		void NodeIndex::link(Node* a_node) {
+			auto& bucket = nodes[a_node->nodeId];
+			bucket.nodes.push_back(a_node);
+			bucket.generation = ++nextGeneration;
+		}
+
+		void NodeIndex::unlink(Node* a_node, const std::string &a_id) {
+			auto found = nodes.find(a_id);
+			if (found != nodes.end()) {
+				auto& bucket = found->second;
+				bucket.nodes.erase(std::remove(bucket.nodes.begin(), bucket.nodes.end(), a_node), bucket.nodes.end());
+				if (bucket.nodes.empty()) {
+					nodes.erase(found);
+				} else {
+					bucket.generation = ++nextGeneration;
+				}
+			}
+		}
+
+		const std::vector<Node*>& NodeIndex::find(const std::string &a_id) const {
+			static const std::vector<Node*> none;
+			auto found = nodes.find(a_id);
+			return found != nodes.end() ? found->second.nodes : none;
+		}
+
+		uint64_t NodeIndex::generation(const std::string &a_id) const {
+			auto found = nodes.find(a_id);
+			return found != nodes.end() ? found->second.generation : 0;
+		}
+
+		/******************\
+		| ---NodeLookup--- |
+		\******************/
+
+		std::shared_ptr<Node> NodeLookup::get(Node &a_scope, bool a_throw) {
+			auto cached = found.lock();
+			if (cached && cached->nodeId == nodeId && cached->descendantOf(&a_scope)) {
+				//a node with our id joining the tree may be nearer, so any change to that id searches again.
+				auto index = a_scope.rootIndex();
+				if (index && index->generation(nodeId) == foundGeneration) {
+					return cached;
+				}
+			}
+			cached = a_scope.get(nodeId, a_throw);
+			found = cached;
+			auto index = a_scope.rootIndex();
+			foundGeneration = index ? index->generation(nodeId) : 0;
+			return cached;
+		}
+
 		void Node::unsilenceInternal(bool a_callBatched /*= true*/, bool a_callChanged /*= true*/) {
 			const std::shared_ptr<Node> self = shared_from_this();
 			bool changed = false;
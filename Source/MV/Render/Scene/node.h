@@ -1,15 +1,216 @@
 #ifndef _MV_SCENE_NODE_H_
 #define _MV_SCENE_NODE_H_
 
+#include <atomic>
+#include <unordered_map>
+#include <typeindex>
 #include "component.h"
+#include "MV/Utility/objectPool.h"
 
 namespace MV {
+	class ThreadPool;
 
 	namespace Scene {
 
+		//Change notifications recorded for a deferred root (see Node::deferChanges), flushed parent before child.
+		class ChangeJournal {
+		public:
+			enum Change : uint8_t {
+				TRANSFORM = 1 << 0,
+				MATRIX_DIRTY = 1 << 1,
+				LOCAL_BOUNDS = 1 << 2,
+				CHILD_BOUNDS = 1 << 3,
+				CHANGE = 1 << 4
+			};
+			//observers that keep changing the scene while being notified get cut off after this many passes.
+			static constexpr int MaximumFlushPasses = 8;
+
+			//returns false if every change in a_changes was already pending for a_node.
+			bool record(Node* a_node, uint8_t a_changes);
+			void flush();
+
+			bool flushing() const {
+				return inFlush;
+			}
+			bool empty() const {
+				return entries.empty();
+			}
+		private:
+			std::vector<std::weak_ptr<Node>> entries;
+			bool inFlush = false;
+		};
+
+		//Scene changes one subtree makes while Node::updateWorkers runs its concurrent component updates.
+		//Committed on the updating thread in child order once every subtree is done, notifications first then structural changes.
+		class DeferredChanges {
+		public:
+			DeferredChanges(Node* a_subtree) :
+				subtree(a_subtree) {
+			}
+
+			//the subtree this thread is updating concurrently, nullptr outside of a concurrent update.
+			static DeferredChanges*& current() {
+				static thread_local DeferredChanges* active = nullptr;
+				return active;
+			}
+
+			//queues a_action for the commit and returns true during a concurrent update, otherwise returns false so the caller acts now.
+			template <typename F>
+			static bool defer(F &&a_action) {
+				if (auto* changes = current()) {
+					changes->actions.emplace_back(std::forward<F>(a_action));
+					return true;
+				}
+				return false;
+			}
+
+			//a_changes are ChangeJournal::Change flags.
+			void change(Node* a_node, uint8_t a_changes);
+			//true for the first ancestor outside our subtree, bounds changes stop there until the commit.
+			bool outside(const Node* a_node) const;
+			void parentBoundsChanged() {
+				parentBoundsDirty = true;
+			}
+
+			void commit();
+		private:
+			struct Entry {
+				Node* node;
+				std::weak_ptr<Node> handle;
+				uint8_t changes;
+			};
+
+			Node* subtree;
+			std::vector<Entry> changes;
+			std::vector<std::function<void()>> actions;
+			bool parentBoundsDirty = false;
+		};
+
+		//World matrices for a whole tree in one array ordered parent before child, owned by a root with flattenTransforms(true).
+		//The root's draw() brings every dirty matrix up to date in a single pass instead of each node asking its parents.
+		class TransformHierarchy {
+		public:
+			TransformHierarchy(Node* a_root) :
+				root(a_root) {
+			}
+			~TransformHierarchy();
+
+			//drops the layout when nodes are added, removed or re-sorted anywhere in the tree, update() rebuilds it.
+			void invalidate();
+			void update();
+
+			size_t size() const {
+				return nodes.size();
+			}
+		private:
+			friend Node;
+			TransformHierarchy(const TransformHierarchy&) = delete;
+			TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+			void rebuild();
+
+			Node* root;
+			std::vector<Node*> nodes;
+			std::vector<int32_t> parents;
+			std::vector<TransformMatrix> worldMatrices;
+			std::vector<uint8_t> dirty;
+			std::vector<std::pair<Node*, int32_t>> pending;
+		};
+
+		//Every node in a tree by id. Owned by the root, built the first time get or has searches it and kept current by add, remove and id.
+		class NodeIndex {
+		public:
+			NodeIndex(Node* a_root);
+
+			void insert(Node* a_subtree);
+			void erase(Node* a_subtree);
+			void rename(Node* a_node, const std::string &a_oldId);
+
+			const std::vector<Node*>& find(const std::string &a_id) const;
+			//Changes whenever a node with a_id is added, removed or renamed anywhere in the tree, 0 if there are none.
+			uint64_t generation(const std::string &a_id) const;
+		private:
+			struct Bucket {
+				std::vector<Node*> nodes;
+				uint64_t generation = 0;
+			};
+
+			void link(Node* a_node);
+			void unlink(Node* a_node, const std::string &a_id);
+
+			std::unordered_map<std::string, Bucket> nodes;
+			//shared by every index so a lookup carried into another tree can't mistake its generation for current.
+			static std::atomic<uint64_t> nextGeneration;
+		};
+
+		//Bounding volume hierarchy over a node's children in its local space, kept by nodes with childVolumes(true) so
+		//childrenAt and childrenIntersecting skip whole groups of children. Moving children only refits the boxes,
+		//adding, removing or re-sorting children rebuilds it on the next query.
+		class ChildVolumes {
+		public:
+			ChildVolumes(Node* a_owner) :
+				owner(a_owner) {
+			}
+
+			void invalidate() {
+				stale = true;
+			}
+			//a_child moved or changed bounds, only its box and the volumes above it are refit on the next query.
+			void refit(Node* a_child);
+
+			void query(const Point<> &a_localPoint, std::vector<std::shared_ptr<Node>> &a_results);
+			void query(const BoxAABB<> &a_localBounds, std::vector<std::shared_ptr<Node>> &a_results);
+		private:
+			ChildVolumes(const ChildVolumes&) = delete;
+			ChildVolumes& operator=(const ChildVolumes&) = delete;
+
+			struct Entry {
+				Node* node;
+				BoxAABB<> bounds;
+				bool hittable;
+				bool queued;
+				int32_t leaf;
+			};
+			struct Volume {
+				BoxAABB<> bounds;
+				bool hasBounds;
+				bool queued;
+				//leaves cover entries[first, first + count), branches have count 0 and their left side right after them.
+				int32_t first;
+				int32_t count;
+				int32_t right;
+				int32_t parent;
+			};
+			static const int32_t LeafSize = 4;
+
+			template <typename T>
+			void query(const T &a_test, std::vector<std::shared_ptr<Node>> &a_results);
+			void update();
+			int32_t build(int32_t a_first, int32_t a_parent, int32_t a_count);
+			void updateEntry(Entry &a_entry);
+			void clearChanges();
+			void refitVolume(int32_t a_index);
+
+			Node* owner;
+			std::vector<Entry> entries;
+			std::vector<Volume> volumes;
+			std::vector<int32_t> pending;
+			//entries waiting to be refit, dirty when enough changed that refitting everything is cheaper.
+			std::vector<int32_t> changedEntries;
+			std::vector<int32_t> changedVolumes;
+			bool stale = true;
+			bool dirty = false;
+		};
+
 		class Node : public std::enable_shared_from_this<Node> {
 			friend cereal::access;
 			friend Component;
+			friend ChangeJournal;
+			friend DeferredChanges;
+			friend NodeIndex;
+			friend TransformHierarchy;
+			friend ChildVolumes;
+			friend class NodeLookup;
 
 			struct LoadOptions {
 				LoadOptions(MV::Services &a_services, bool a_doPostLoad) : doPostLoad(a_doPostLoad), services(a_services) {
@@ -120,6 +321,7 @@ namespace MV {
 			static int64_t recalculateLocalBoundsCalls;
 			static int64_t recalculateChildBoundsCalls;
 			static int64_t recalculateMatrixCalls;
+			static int64_t culledNodeDraws;
 
 			~Node();
 
@@ -166,8 +368,46 @@ namespace MV {
 				return Quiet(shared_from_this());
 			}
 
+			//Root only. Transform, bounds, matrix dirty and onChange notifications for the whole tree are journaled and
+			//held until flushChanges, call it once a frame before drawing so observers hear about each node at most once a frame.
+			//Dirty flags still update immediately, only the signals wait. Changes made while drawing go out with the next flush.
+			std::shared_ptr<Node> deferChanges(bool a_defer);
+			bool deferringChanges() const {
+				return changeJournal != nullptr;
+			}
+			void flushChanges();
+
+			//Update our children as independent subtrees. Their components' concurrentUpdateImplementation runs on this pool
+			//after the normal update, with scene changes deferred to a serial commit. nullptr runs everything on the calling thread.
+			std::shared_ptr<Node> updateWorkers(ThreadPool* a_pool) {
+				updatePool = a_pool;
+				return shared_from_this();
+			}
+			ThreadPool* updateWorkers() const {
+				return updatePool;
+			}
+
+			//Root only. Keeps the tree's world matrices in a TransformHierarchy so draw() updates them in one linear pass.
+			std::shared_ptr<Node> flattenTransforms(bool a_flatten);
+			bool flatteningTransforms() const {
+				return flatTransforms != nullptr;
+			}
+
+			//Our visible children whose bounds, transformed into our space, contain a_localPoint or overlap a_localBounds,
+			//ordered back to front by sortDepth. Every child is tested unless childVolumes is on.
+			std::vector<std::shared_ptr<Node>> childrenAt(const Point<> &a_localPoint);
+			std::vector<std::shared_ptr<Node>> childrenIntersecting(const BoxAABB<> &a_localBounds);
+
+			//Keeps a ChildVolumes hierarchy for childrenAt and childrenIntersecting, worth it for nodes with many children hit tested often.
+			std::shared_ptr<Node> childVolumes(bool a_enabled);
+			bool childVolumes() const {
+				return childVolumeHierarchy != nullptr;
+			}
+
 			static std::shared_ptr<Node> make(Draw2D& a_draw2d, const std::string &a_id);
 			static std::shared_ptr<Node> make(Draw2D& a_draw2d);
+			//load and loadBinary accept JSON, scene archives and the older portable binary saves alike, telling them apart by
+			//their contents. saveBinary writes scene archives, SceneConverter turns JSON assets into them at build time.
 			static std::shared_ptr<Node> load(const std::string &a_filename, MV::Services& a_services, bool a_doPostLoadStep = true);
 			static std::shared_ptr<Node> loadBinary(const std::string &a_filename, MV::Services& a_services, bool a_doPostLoadStep = true);
 			static std::shared_ptr<Node> load(const std::string &a_filename, MV::Services& a_services, const std::string &a_overrideId, bool a_doPostLoadStep = true);
@@ -192,8 +432,12 @@ namespace MV {
 			template<typename ComponentType>
 			SafeComponent<ComponentType> attach(std::shared_ptr<ComponentType> a_component) {
 				auto self = shared_from_this();
+				if (DeferredChanges::defer([self, a_component]() { self->attach(a_component); })) {
+					return SafeComponent<ComponentType>(self, a_component);
+				}
 				a_component->detach();
 				childComponents.push_back(a_component);
+				invalidateComponentLookups();
 				a_component->reattached(self);
 				onAttachSignal(a_component);
 				return SafeComponent<ComponentType>(self, a_component);
@@ -202,32 +446,36 @@ namespace MV {
 			template<typename ComponentType>
 			SafeComponent<ComponentType> attach() {
 				auto self = shared_from_this();
-				auto newComponent = std::shared_ptr<ComponentType>(new ComponentType(self));
-				childComponents.push_back(newComponent);
-				newComponent->initialize();
-				onAttachSignal(newComponent);
+				auto newComponent = makePooled<ComponentType>([&](void* a_memory) { return new (a_memory) ComponentType(self); });
+				if (!DeferredChanges::defer([self, newComponent]() { self->attachConstructed(newComponent); })) {
+					attachConstructed(newComponent);
+				}
 				return SafeComponent<ComponentType>(self, newComponent);
 			}
 
 			template<typename ComponentType, typename... Args>
 			SafeComponent<ComponentType> attach(Args&&... a_arguments){
 				auto self = shared_from_this();
-				auto newComponent = std::shared_ptr<ComponentType>(new ComponentType(self, std::forward<Args>(a_arguments)...));
-				childComponents.push_back(newComponent);
-				newComponent->initialize();
-				onAttachSignal(newComponent);
+				auto newComponent = makePooled<ComponentType>([&](void* a_memory) { return new (a_memory) ComponentType(self, std::forward<Args>(a_arguments)...); });
+				if (!DeferredChanges::defer([self, newComponent]() { self->attachConstructed(newComponent); })) {
+					attachConstructed(newComponent);
+				}
 				return SafeComponent<ComponentType>(self, newComponent);
 			}
 
 			template<typename ComponentType>
 			std::shared_ptr<Node> detach(bool a_exactType = true, bool a_throwIfNotFound = true) {
 				auto self = shared_from_this();
+				if (DeferredChanges::defer([self, a_exactType, a_throwIfNotFound]() { self->detach<ComponentType>(a_exactType, a_throwIfNotFound); })) {
+					return self;
+				}
 				std::vector<std::shared_ptr<Component>>::const_iterator foundComponent = componentIterator<ComponentType>(a_exactType, a_throwIfNotFound);
 				if (foundComponent != childComponents.end()) {
 					auto sharedComponent = (*foundComponent);
 					auto originalOwner = sharedComponent->componentOwner;
 					sharedComponent->detachImplementation();
 					childComponents.erase(foundComponent);
+					invalidateComponentLookups();
 					onDetachSignal(sharedComponent);
 					if (sharedComponent->componentOwner.lock() == originalOwner.lock()) {
 						sharedComponent->componentOwner.reset();
@@ -239,12 +487,16 @@ namespace MV {
 			template<typename ComponentType>
 			std::shared_ptr<Node> detach(std::shared_ptr<ComponentType> a_component) {
 				auto self = shared_from_this();
+				if (DeferredChanges::defer([self, a_component]() { self->detach(a_component); })) {
+					return self;
+				}
 				auto found = std::find(childComponents.begin(), childComponents.end(), a_component);
 				if (found != childComponents.end()) {
 					auto sharedComponent = *found;
 					auto originalOwner = sharedComponent->componentOwner;
 					sharedComponent->detachImplementation();
 					childComponents.erase(found);
+					invalidateComponentLookups();
 					onDetachSignal(a_component);
 					if (sharedComponent->componentOwner.lock() == originalOwner.lock()) {
 						sharedComponent->componentOwner.reset();
@@ -260,6 +512,9 @@ namespace MV {
 
 			std::shared_ptr<Node> detach(const std::string &a_componentId, bool a_throwIfNotFound = true) {
 				auto self = shared_from_this();
+				if (DeferredChanges::defer([self, a_componentId, a_throwIfNotFound]() { self->detach(a_componentId, a_throwIfNotFound); })) {
+					return self;
+				}
 				auto found = std::find_if(childComponents.begin(), childComponents.end(), [&](const std::shared_ptr<Component> &a_component) {
 					return a_component->id() == a_componentId;
 				});
@@ -268,6 +523,7 @@ namespace MV {
 					auto originalOwner = sharedComponent->componentOwner;
 					sharedComponent->detachImplementation();
 					childComponents.erase(found);
+					invalidateComponentLookups();
 					onDetachSignal(sharedComponent);
 					if (sharedComponent->componentOwner.lock() == originalOwner.lock()) {
 						sharedComponent->componentOwner.reset();
@@ -354,17 +610,19 @@ namespace MV {
 
 			template<typename ComponentType>
 			SafeComponent<ComponentType> componentInChildren(bool a_exactType = true, bool a_throwIfNotFound = true, bool a_includeSelf = true) const {
-				std::vector<std::shared_ptr<Component>>::const_iterator foundComponent = a_includeSelf ? componentIterator<ComponentType>(a_exactType, false) : childComponents.end();
-				if (foundComponent != childComponents.end()) {
-					return SafeComponent<ComponentType>(shared_from_this(), std::dynamic_pointer_cast<ComponentType>(*foundComponent));
-				} else if (!childNodes.empty()) {
+				Component* foundComponent = nullptr;
+				if (a_includeSelf) {
+					foundComponent = componentInSubtree<ComponentType>(a_exactType);
+				} else {
 					for (auto&& childNode : childNodes) {
-						auto childComponent = childNode->componentInChildren<ComponentType>(a_exactType, false, true);
-						if (childComponent) {
-							return childComponent;
+						if ((foundComponent = childNode->componentInSubtree<ComponentType>(a_exactType))) {
+							break;
 						}
 					}
 				}
+				if (foundComponent) {
+					return SafeComponent<ComponentType>(foundComponent->owner(), std::dynamic_pointer_cast<ComponentType>(foundComponent->shared_from_this()));
+				}
 				
 				if (a_throwIfNotFound) {
 					require<ResourceException>(false, "Component with type [", typeid(ComponentType).name(), "] not found in node (or children of node) [", id(), "]");
@@ -407,7 +665,7 @@ namespace MV {
 					return SafeComponent<ComponentType>(shared_from_this(), std::dynamic_pointer_cast<ComponentType>(*found));
 				} else if (!childNodes.empty()) {
 					for (auto&& childNode : childNodes) {
-						auto childComponent = componentInChildren<ComponentType>(a_componentId, false);
+						auto childComponent = childNode->componentInChildren<ComponentType>(a_componentId, false);
 						if (childComponent) {
 							return childComponent;
 						}
@@ -518,6 +776,10 @@ namespace MV {
 
 			std::shared_ptr<Node> cameraId(int32_t a_newCameraId) {
 				cameraIdInternal(a_newCameraId);
+				//ancestors only gather cull bounds from children sharing their camera.
+				for (auto* ancestor = myParent; ancestor; ancestor = ancestor->myParent) {
+					ancestor->dirtyCullBounds = true;
+				}
 				return shared_from_this();
 			}
 
@@ -702,6 +964,18 @@ namespace MV {
 			void recalculateLocalBounds();
 			void recalculateAlpha();
 			void recalculateMatrix();
+			void recalculateLocalMatrix();
+			void recalculateWorldMatrix(const TransformMatrix* a_parentWorld);
+			void invalidateTransformLayout() {
+				if (transformHierarchy) {
+					transformHierarchy->invalidate();
+				}
+			}
+			void invalidateChildVolumes() {
+				if (childVolumeHierarchy) {
+					childVolumeHierarchy->invalidate();
+				}
+			}
 
 			//manual post load only if you know what you're doing.
 			void postLoadStep();
@@ -762,11 +1036,67 @@ namespace MV {
 
 			void markBoundsDirty() {
 				dirtyLocalBounds = true;
+				dirtyCullBounds = true;
 				markParentBoundsDirty();
-				onLocalBoundsChangeSignal(shared_from_this());
+				notifyChange(onLocalBoundsChangeSignal, ChangeJournal::LOCAL_BOUNDS);
 			}
 
-			void markParentBoundsDirty();
+			//finishes attaching a component constructed for us, it initializes once it is in childComponents.
+			void attachConstructed(const std::shared_ptr<Component> &a_component) {
+				childComponents.push_back(a_component);
+				invalidateComponentLookups();
+				a_component->initialize();
+				onAttachSignal(a_component);
+			}
+
+			//fires a_signal now, or journals a_change when our root defers changes.
+			void notifyChange(Signal<BasicSignature> &a_signal, uint8_t a_change) {
+				if (auto* deferred = DeferredChanges::current()) {
+					deferred->change(this, a_change);
+				} else if (changeJournal) {
+					changeJournal->record(this, a_change);
+				} else {
+					a_signal(shared_from_this());
+				}
+			}
+			void transformChanged(const std::shared_ptr<Node> &a_self);
+			//notifies a_changes (ChangeJournal::Change flags) deferred by a concurrent update.
+			void replayChanges(uint8_t a_changes);
+
+			void updateSerial(double a_delta, bool a_force, bool a_includeConcurrent);
+			void updateConcurrent(double a_delta);
+			void updateChildrenConcurrently(double a_delta);
+			void adoptChangeJournal(const std::shared_ptr<ChangeJournal> &a_journal);
+
+			//get's descendant lookup through our root's index, falling back to search when a_id is not unique among our descendants.
+			Node* find(const std::string &a_id) const;
+			//the original depth first lookup, defines which duplicate id get returns.
+			Node* search(const std::string &a_id) const;
+			bool descendantOf(const Node* a_ancestor) const {
+				for (Node* current = myParent; current; current = current->myParent) {
+					if (current == a_ancestor) {
+						return true;
+					}
+				}
+				return false;
+			}
+			//our root's index if it has been built.
+			NodeIndex* rootIndex() const;
+			void unindexChild(Node* a_child);
+
+			//a_boundsChanged false when only our transform changed, that moves us in our parents' cull bounds and child
+			//volumes but leaves localChildBounds alone since children are gathered into it untransformed.
+			void markParentBoundsDirty(bool a_boundsChanged = true);
+			//queues a_child for the next recalculateChildBounds.
+			void childBoundsChanged(Node* a_child);
+			//drops a_child, which is leaving us, from localChildBounds.
+			void forgetChildBounds(Node* a_child);
+			//what a_child adds to localChildBounds, false if it adds nothing.
+			bool childBoundsContribution(Node* a_child, BoxAABB<> &a_contribution);
+			void gatherChildBounds();
+			void clearChangedChildBounds();
+			//our bounds transformed into our parent's space.
+			BoxAABB<> boundsInParent();
 
 			void silenceInternal() {
 				onChildAddSignal.block();
@@ -799,19 +1129,23 @@ namespace MV {
 
 			template<typename ComponentType>
 			std::vector<std::shared_ptr<Component>>::const_iterator componentIterator(bool a_exactType = true, bool a_throwIfNotFound = true) const {
-				if (a_exactType) {
-					for (auto currentComponent = childComponents.cbegin(); currentComponent != childComponents.cend(); ++currentComponent) {
-						if (typeid(*(*currentComponent)) == typeid(ComponentType)) {
-							return currentComponent;
-						}
-					}
+				const std::type_index type(typeid(ComponentType));
+				auto cached = std::find_if(componentLookups.cbegin(), componentLookups.cend(), [&](const ComponentLookup &a_lookup) {
+					return a_lookup.type == type && a_lookup.exactType == a_exactType;
+				});
+				int32_t index = -1;
+				if (cached != componentLookups.cend()) {
+					index = cached->index;
 				} else {
-					for (auto currentComponent = childComponents.cbegin(); currentComponent != childComponents.cend(); ++currentComponent) {
-						auto castComponent = std::dynamic_pointer_cast<ComponentType>(*currentComponent);
-						if (castComponent) {
-							return currentComponent;
+					for (size_t i = 0; i < childComponents.size() && index < 0; ++i) {
+						if (a_exactType ? typeid(*childComponents[i]) == typeid(ComponentType) : dynamic_cast<ComponentType*>(childComponents[i].get()) != nullptr) {
+							index = static_cast<int32_t>(i);
 						}
 					}
+					componentLookups.push_back({ type, a_exactType, index });
+				}
+				if (index >= 0) {
+					return childComponents.cbegin() + index;
 				}
 				if (a_throwIfNotFound) {
 					std::string componentsString;
@@ -823,6 +1157,40 @@ namespace MV {
 				return childComponents.cend();
 			}
 
+			//componentInChildren for one subtree, remembered until a component or child changes anywhere inside it.
+			template<typename ComponentType>
+			Component* componentInSubtree(bool a_exactType) const {
+				const std::type_index type(typeid(ComponentType));
+				auto cached = std::find_if(subtreeComponentLookups.cbegin(), subtreeComponentLookups.cend(), [&](const SubtreeComponentLookup &a_lookup) {
+					return a_lookup.type == type && a_lookup.exactType == a_exactType;
+				});
+				if (cached != subtreeComponentLookups.cend()) {
+					return cached->found;
+				}
+				Component* found = nullptr;
+				auto foundComponent = componentIterator<ComponentType>(a_exactType, false);
+				if (foundComponent != childComponents.cend()) {
+					found = foundComponent->get();
+				} else {
+					for (auto&& childNode : childNodes) {
+						if ((found = childNode->componentInSubtree<ComponentType>(a_exactType))) {
+							break;
+						}
+					}
+				}
+				subtreeComponentLookups.push_back({ type, a_exactType, found });
+				return found;
+			}
+
+			//call whenever childComponents or the order of childNodes changes.
+			void invalidateComponentLookups() {
+				componentLookups.clear();
+				//a subtree lookup is only cached if every node its search visited cached one too, so ancestors past an empty cache have nothing stale.
+				for (const Node* current = this; current && !current->subtreeComponentLookups.empty(); current = current->myParent) {
+					current->subtreeComponentLookups.clear();
+				}
+			}
+
 			template<typename ... ComponentType>
 			void componentsInChildrenInternal(bool exactType, bool includeComponentsInThis, std::vector<std::variant<SafeComponent<ComponentType>...>>& results) const {
 				if (includeComponentsInThis) {
@@ -852,11 +1220,17 @@ namespace MV {
 
 			void markMatrixDirty(bool a_rootCall = true);
 
+			//true when our whole subtree lands outside the camera's view, Node::draw skips it entirely.
+			bool culled();
+			void recalculateCullBounds();
+
 			void recalculateMatrixAfterLoad();
 			void localAndChildPostLoadInitializeComponents();
 
 			Node(Draw2D &a_draw2d, const std::string &a_id);
 
+			static std::shared_ptr<Node> loadFile(const std::string &a_filename, MV::Services& a_services, const std::string &a_overrideId, bool a_doPostLoadStep);
+
 			void fixChildOwnership();
 
 			template <class Archive>
@@ -903,9 +1277,19 @@ namespace MV {
 				);
 				if (childNodes.empty() && !filteredChildren.empty()) {
 					childNodes = filteredChildren;
+					invalidateComponentLookups();
+					invalidateTransformLayout();
+					invalidateChildVolumes();
+					fullChildBoundsPass = true;
+					if (auto index = rootIndex()) {
+						for (auto&& child : childNodes) {
+							index->insert(child.get());
+						}
+					}
 				}
 				if (childComponents.empty() && !filteredChildComponents.empty()) {
 					childComponents = filteredChildComponents;
+					invalidateComponentLookups();
 				}
 				if (version < 2) {
 					rotateTo = toRadians(rotateTo);
@@ -993,8 +1377,74 @@ namespace MV {
 
 			bool dirtyLocalBounds = false;
 			bool dirtyChildBounds = false;
+			//children whose bounds changed since localChildBounds was gathered, recalculateChildBounds folds in just these
+			//unless one shrank away from an edge of localChildBounds or we need a full pass anyway.
+			std::vector<Node*> changedChildBounds;
+			bool fullChildBoundsPass = true;
+			//localChildBounds always starts from our first child, a different one up front needs a full pass.
+			Node* childBoundsSeed = nullptr;
+			//what we last added to our parent's localChildBounds.
+			BoxAABB<> parentBoundsContribution;
+			bool contributesToParentBounds = false;
+			bool queuedInParentBounds = false;
+
+			//our components and every visible descendant in our local space, unlike localChildBounds children are transformed into it.
+			BoxAABB<> localCullBounds;
+			bool dirtyCullBounds = true;
+			bool cullBoundsUnbounded = false;
 
 			int32_t ourCameraId = 0;
+
+			std::shared_ptr<ChangeJournal> changeJournal;
+			uint8_t pendingChanges = 0;
+
+			ThreadPool* updatePool = nullptr;
+
+			mutable std::unique_ptr<NodeIndex> nodeIndex;
+
+			std::unique_ptr<TransformHierarchy> flatTransforms;
+			//our place in the root's flatTransforms, only set while its layout is current.
+			TransformHierarchy* transformHierarchy = nullptr;
+			int32_t transformSlot = -1;
+
+			std::unique_ptr<ChildVolumes> childVolumeHierarchy;
+			//our entry in our parent's childVolumeHierarchy, only meaningful while it isn't stale.
+			int32_t childVolumeSlot = -1;
+
+			//nodes hold a handful of components, so these stay small flat lists searched by type.
+			struct ComponentLookup {
+				std::type_index type;
+				bool exactType;
+				//into childComponents, -1 when we have none of this type.
+				int32_t index;
+			};
+			struct SubtreeComponentLookup {
+				std::type_index type;
+				bool exactType;
+				Component* found;
+			};
+			mutable std::vector<ComponentLookup> componentLookups;
+			mutable std::vector<SubtreeComponentLookup> subtreeComponentLookups;
+		};
+
+		//Remembers the node a scoped get found so repeated lookups only search again once a node with that id is added,
+		//removed or renamed, or the found node leaves that scope. Reordering siblings doesn't count, so with several
+		//matches in scope the remembered one may no longer be the first get would return.
+		class NodeLookup {
+		public:
+			NodeLookup(const std::string &a_id = std::string()) :
+				nodeId(a_id) {
+			}
+
+			std::shared_ptr<Node> get(Node &a_scope, bool a_throw = true);
+
+			const std::string& id() const {
+				return nodeId;
+			}
+		private:
+			std::string nodeId;
+			std::weak_ptr<Node> found;
+			uint64_t foundGeneration = 0;
 		};
 
 		std::ostream& operator<<(std::ostream& os, const std::shared_ptr<Node>& a_node);
@@ -2,6 +2,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_REGISTER_TYPE(MV::Scene::Palette);
 CEREAL_REGISTER_DYNAMIC_INIT(mv_scenepalette);
@@ -48,6 +48,10 @@ namespace MV {
 				return map->size();
 			}
 
+			std::shared_ptr<Map> grid() const {
+				return map;
+			}
+
 			MapNode& nodeFromGrid(const Point<int> &a_location) {
 				return map->get(a_location);
 			}
@@ -97,6 +101,32 @@ namespace MV {
 				return map->corners();
 			}
 
+			//Milliseconds per update spent on agent path searches, zero or less calculates paths synchronously.
+			std::shared_ptr<PathMap> pathBudget(double a_milliseconds) {
+				map->requests().budget(a_milliseconds);
+				return std::static_pointer_cast<PathMap>(shared_from_this());
+			}
+
+			double pathBudget() const {
+				return map->requests().budget();
+			}
+
+			//Run queued path searches on a snapshot of the map using this pool, nullptr to search on the main thread.
+			std::shared_ptr<PathMap> pathWorkers(ThreadPool* a_pool) {
+				map->requests().workers(a_pool);
+				return std::static_pointer_cast<PathMap>(shared_from_this());
+			}
+
+			//Number of recently found paths kept for reuse and splicing, 0 disables the cache.
+			std::shared_ptr<PathMap> pathCacheSize(size_t a_entries) {
+				map->pathCache().capacity(a_entries);
+				return std::static_pointer_cast<PathMap>(shared_from_this());
+			}
+
+			size_t pathCacheSize() const {
+				return map->pathCache().capacity();
+			}
+
 		protected:
 			PathMap(const std::weak_ptr<Node> &a_owner, const Size<int> &a_gridSize, bool a_useCorners = true) :
 				PathMap(a_owner, Size<>(1.0f, 1.0f), a_gridSize, a_useCorners) {
@@ -106,6 +136,10 @@ namespace MV {
 
 			virtual bool serializePoints() const override { return false; }
 
+			virtual void updateImplementation(double a_dt) override {
+				map->requests().update();
+			}
+
 			virtual BoxAABB<> boundsImplementation() override { return Drawable::boundsImplementation(); }
 
 			virtual void boundsImplementation(const BoxAABB<> &a_bounds) override {
@@ -330,6 +364,16 @@ namespace MV {
 				return !agent->hasFootprint();
 			}
 
+			//Steer around other steering agents instead of blocking grid cells for them.
+			std::shared_ptr<PathAgent> steering(bool a_enabled) {
+				agent->steering(a_enabled);
+				return std::static_pointer_cast<PathAgent>(shared_from_this());
+			}
+
+			bool steering() const {
+				return agent->steering();
+			}
+
 		protected:
 			PathAgent(const std::weak_ptr<Node> &a_owner, const std::shared_ptr<PathMap> &a_map, const Point<> &a_gridPosition, int a_unitSize = 1) :
 				Component(a_owner),
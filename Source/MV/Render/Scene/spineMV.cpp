@@ -8,6 +8,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_REGISTER_TYPE(MV::Scene::Spine);
 CEREAL_REGISTER_DYNAMIC_INIT(mv_scenespine);
@@ -150,6 +151,7 @@ namespace MV{
 				spBone_setYDown(true);
 				spineWorldVertices = new float[SPINE_MESH_VERTEX_COUNT_MAX]();
 				updateImplementation(0.0f);
+				concurrentUpdateImplementation(0.0f);
 
 				for (int i = 0, n = skeleton->slotsCount; i < n; i++) {
 					spSlot* slot = skeleton->drawOrder[i];
@@ -185,16 +187,21 @@ namespace MV{
 				if (pendingDelete) {
 					pendingDelete = false;
 					unloadImplementation();
-				} else {
-					spSkeleton_updateWorldTransform(skeleton);
 				}
 			}
 		}
 
+		void Spine::concurrentUpdateImplementation(double) {
+			if (loaded()) {
+				spSkeleton_updateWorldTransform(skeleton);
+			}
+		}
+
 		void Spine::unloadImplementation() {
 			if (loaded() && !inUpdate) {
 				tracks.clear();
 				slotsToNodes.clear();
+				slotLookupsDirty = true;
 				points.clear();
 				vertexIndices.clear();
 				fileBundle = FileBundle();
@@ -299,10 +306,12 @@ namespace MV{
 
 		std::shared_ptr<Spine> Spine::bindNode(const std::string &a_slotId, const std::string &a_nodeId) {
 			slotsToNodes[a_slotId].insert(a_nodeId);
+			slotLookupsDirty = true;
 			return std::static_pointer_cast<Spine>(shared_from_this());
 		}
 		std::shared_ptr<Spine> Spine::unbindSlot(const std::string &a_slotId) {
 			slotsToNodes.erase(a_slotId);
+			slotLookupsDirty = true;
 			return std::static_pointer_cast<Spine>(shared_from_this());
 		}
 		std::shared_ptr<Spine> Spine::unbindNode(const std::string &a_slotId, const std::string &a_nodeId) {
@@ -312,26 +321,35 @@ namespace MV{
 			} else {
 				slotToNodeBinding.erase(a_nodeId);
 			}
+			slotLookupsDirty = true;
 			return std::static_pointer_cast<Spine>(shared_from_this());
 		}
 
 		std::shared_ptr<Spine> Spine::unbindAll() {
 			slotsToNodes.clear();
+			slotLookupsDirty = true;
 			return std::static_pointer_cast<Spine>(shared_from_this());
 		}
 
+		std::map<std::string, std::vector<NodeLookup>>& Spine::slotLookups() {
+			if (slotLookupsDirty) {
+				slotLookupsDirty = false;
+				slotNodeLookups.clear();
+				for (auto&& slotToNodes : slotsToNodes) {
+					auto& lookups = slotNodeLookups[slotToNodes.first];
+					lookups.assign(slotToNodes.second.begin(), slotToNodes.second.end());
+				}
+			}
+			return slotNodeLookups;
+		}
+
 		void Spine::defaultDrawImplementation(){
 			if (owner()->renderer().headless()) { return; }
 
 			if (loaded()) {
-				if (bufferId == 0) {
-					glGenBuffers(1, &bufferId);
-				}
-
-				glBindBuffer(GL_ARRAY_BUFFER, bufferId);
-
 				points.clear();
 				vertexIndices.clear();
+				uploadedSkeletonPoints = 0;
 				
 				FileTextureDefinition *previousTexture = nullptr;
 				spBlendMode previousBlending = SP_BLEND_MODE_NORMAL;
@@ -356,11 +374,11 @@ namespace MV{
 						previousTexture = texture;
 						previousBlending = slot->data->blendMode;
 					}
-					auto nodesToRender = slotsToNodes.find(slot->data->name);
-					if (nodesToRender != slotsToNodes.end()) {
+					auto nodesToRender = slotLookups().find(slot->data->name);
+					if (nodesToRender != slotNodeLookups.end()) {
 						bool interrupted = false;
 						for (auto&& nodeToRender : nodesToRender->second) {
-							auto node = owner()->get(nodeToRender, false);
+							auto node = nodeToRender.get(*owner(), false);
 							if (node) {
 								if (!interrupted) {
 									interrupted = true;
@@ -401,41 +419,32 @@ namespace MV{
 			else if (a_spineBlendMode == SP_BLEND_MODE_SCREEN) {
 				owner()->renderer().setBlendFunction(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
 			}
+			else {
+				owner()->renderer().defaultBlendFunction();
+			}
 		}
 
 		size_t Spine::renderSkeletonBatch(size_t a_lastRenderedIndex, GLuint a_textureId, spBlendMode a_blendMode) {
-			auto structSize = static_cast<GLsizei>(sizeof(points[0]));
-			auto bufferSizeToRender = (points.size()) * structSize;
-
-			if(bufferSizeToRender > 0){
+			if(!points.empty() && vertexIndices.size() > a_lastRenderedIndex){
 				auto ourOwner = owner();
+				//attached nodes may have queued draws since the last skeleton batch.
+				ourOwner->renderer().renderQueue().flush();
 				shaderProgram->use();
-				SCOPE_EXIT{ glUseProgram(0); };
-				SCOPE_EXIT{ ourOwner->renderer().defaultBlendFunction(); };
 				applySpineBlendMode(a_blendMode);
-				glBufferData(GL_ARRAY_BUFFER, bufferSizeToRender, &(points[0]), GL_STATIC_DRAW);
 
-				glEnableVertexAttribArray(0);
-				glEnableVertexAttribArray(1);
-				glEnableVertexAttribArray(2);
-
-				auto positionOffset = static_cast<size_t>(offsetof(DrawPoint, x));
-				auto textureOffset = static_cast<size_t>(offsetof(DrawPoint, textureX));
-				auto colorOffset = static_cast<size_t>(offsetof(DrawPoint, R));
-				glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)positionOffset); //Point
-				glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)textureOffset); //UV
-				glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)colorOffset); //Color
+				//only the slots loaded since the previous batch are new, earlier ones are already in the buffer.
+				auto& state = ourOwner->renderer().renderState();
+				drawBuffer.points(state, points, uploadedSkeletonPoints, points.size());
+				drawBuffer.indices(state, vertexIndices, a_lastRenderedIndex, vertexIndices.size());
+				uploadedSkeletonPoints = points.size();
+				drawBuffer.bind(state);
 
 				TransformMatrix transformationMatrix(ourOwner->renderer().cameraProjectionMatrix(ourOwner->cameraId()) * ourOwner->worldTransform());
 
-				shaderProgram->set("texture0", a_textureId);
-				shaderProgram->set("transformation", transformationMatrix);
-
-				glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(vertexIndices.size() - a_lastRenderedIndex), GL_UNSIGNED_INT, &vertexIndices[a_lastRenderedIndex]);
+				shaderProgram->set(ShaderUniform::texture(0), a_textureId);
+				shaderProgram->set(Uniforms::transformation, transformationMatrix);
 
-				glDisableVertexAttribArray(0);
-				glDisableVertexAttribArray(1);
-				glDisableVertexAttribArray(2);
+				drawBuffer.draw(GL_TRIANGLES, vertexIndices.size() - a_lastRenderedIndex, a_lastRenderedIndex);
 				return vertexIndices.size();
 			}
 			return a_lastRenderedIndex;
@@ -445,6 +454,7 @@ namespace MV{
 			Drawable::cloneHelper(a_clone);
 			auto spineClone = std::static_pointer_cast<Spine>(a_clone);
 			spineClone->slotsToNodes = slotsToNodes;
+			spineClone->slotLookupsDirty = true;
 			return a_clone;
 		}
 
@@ -182,6 +182,8 @@ namespace MV {
 			void applySpineBlendMode(spBlendMode previousBlending);
 
 			virtual void updateImplementation(double a_delta) override;
+			//bone world transforms only read our own skeleton, so they can run on an update worker.
+			virtual void concurrentUpdateImplementation(double a_delta) override;
 			void unloadImplementation();
 		private:
 			virtual void boundsImplementation(const BoxAABB<> &) override {}
@@ -209,6 +211,7 @@ namespace MV {
 					cereal::make_nvp("slotsToNodes", slotsToNodes),
 					cereal::make_nvp("Drawable", cereal::base_class<Drawable>(this))
 				);
+				slotLookupsDirty = true;
 			}
 
 			template <class Archive>
@@ -231,6 +234,7 @@ namespace MV {
 			bool skeletonRenderStateChangedSinceLastIteration(spBlendMode a_previousBlending, spBlendMode a_currentBlending, FileTextureDefinition * a_previousTexture, FileTextureDefinition * a_texture);
 
 			size_t renderSkeletonBatch(size_t lastRenderedIndex, GLuint a_textureId, spBlendMode a_blendMode);
+			size_t uploadedSkeletonPoints = 0;
 
 			FileTextureDefinition * loadSpineSlotIntoPoints(spSlot* slot);
 			FileTextureDefinition *getSpineTextureFromSlot(spSlot* slot) const;
@@ -256,6 +260,10 @@ namespace MV {
 			int defaultTrack = 0;
             std::map<int, std::unique_ptr<AnimationTrack>> tracks;
 			std::map<std::string, std::set<std::string>> slotsToNodes;
+			//slotsToNodes as cached lookups for drawing, rebuilt whenever the bindings change.
+			std::map<std::string, std::vector<NodeLookup>>& slotLookups();
+			std::map<std::string, std::vector<NodeLookup>> slotNodeLookups;
+			bool slotLookupsDirty = true;
 		};
 
 
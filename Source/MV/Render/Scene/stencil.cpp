@@ -3,6 +3,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_REGISTER_TYPE(MV::Scene::Stencil);
 CEREAL_REGISTER_DYNAMIC_INIT(mv_scenestencil);
@@ -14,13 +15,14 @@ namespace MV {
 // 			shaderUpdater = [&](MV::Shader* a_shader) {
 // 				a_shader->set("alphaFilter", 0.01f);
 // 			};
-			Drawable::defaultDrawImplementation();
+			drawImmediately();
 		}
 
 		int Stencil::totalStencilDepth = 0;
 
  		bool Stencil::preDraw() {
 			if (shouldDraw) {
+				owner()->renderer().renderQueue().flush();
 				glStencilMask(0xFF);
 				if (totalStencilDepth++ == 0) {
 					glEnable(GL_STENCIL_TEST);
@@ -47,6 +49,7 @@ namespace MV {
 		//TODO: Cache the stencil properly instead of assuming nothing changed in this node and naively drawing it again (may cause artifacts!)
 		void Stencil::endDraw() {
 			if (shouldDraw) {
+				owner()->renderer().renderQueue().flush();
 				glColorMask(false, false, false, false);
 				glStencilFunc(GL_ALWAYS, totalStencilDepth, totalStencilDepth);
 				glStencilOp(GL_DECR, GL_DECR, GL_DECR);
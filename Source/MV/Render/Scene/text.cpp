@@ -2,6 +2,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_REGISTER_TYPE(MV::Scene::Text);
 CEREAL_REGISTER_DYNAMIC_INIT(mv_scenetext);
@@ -29,11 +30,11 @@ namespace MV{
 
 		void Text::initialize() {
 			Drawable::initialize();
+			formattedText->onChange([&]() {
+				notifyParentOfBoundsChange();
+			});
 			if (ownerIsAlive()) {
 				auto silenceSelf = owner()->silence();
-				formattedText->scene()->id(guid("TEXT_"))->position(points[0]);
-				owner()->add(formattedText->scene());
-
 				cursorSprite = owner()->make(guid("CURSOR_"))->serializable(false)->attach<Sprite>()->bounds(size(2.0f, 5.0f));
 				cursorSprite->hide();
 			}
@@ -49,14 +50,13 @@ namespace MV{
 			} else if (justification() == TextJustification::RIGHT) {
 				xPosition = formattedText->width() - 2.0f;
 			}
-			auto textSilence = formattedText->scene()->silence();
 			auto cursorHeight = formattedText->defaultState()->font->height();
 			auto linePositionY = formattedText->positionForLine(line->index());
 			auto cursorLineHeight = std::max<float>(formattedText->minimumLineHeight(), (line) ? line->height() : cursorHeight);
 			linePositionY += cursorLineHeight / 2.0f - cursorHeight / 2.0f;
 
 			auto cursorSilence = cursorSprite->owner()->silence();
-			cursorSprite->owner()->position(formattedText->scene()->position() + MV::Point<>(xPosition, linePositionY));
+			cursorSprite->owner()->position(points[0].point() + MV::Point<>(xPosition, linePositionY));
 			cursorSprite->bounds(MV::size(2.0f, cursorHeight));
 
 			if (displayCursor) {
@@ -67,7 +67,7 @@ namespace MV{
 		void Text::positionCursorWithCharacter(size_t a_maxCursor, std::shared_ptr<FormattedCharacter> a_cursorCharacter) {
 			if (cursorSprite && cursorSprite->ownerIsAlive()) {
 				auto cursorSilence = cursorSprite->owner()->silence();
-				cursorSprite->owner()->position(formattedText->scene()->position() + ((a_cursorCharacter->position() + a_cursorCharacter->offset()) * a_cursorCharacter->scale()));
+				cursorSprite->owner()->position(points[0].point() + a_cursorCharacter->drawPosition());
 				cursorSprite->bounds(MV::size(2.0f, a_cursorCharacter->characterSize().height));
 				if (cursor >= a_maxCursor) {
 					cursorSprite->owner()->translate({ a_cursorCharacter->characterSize().width * a_cursorCharacter->scale().x, 0.0f });
@@ -78,6 +78,112 @@ namespace MV{
 			}
 		}
 
+		bool Text::backgroundVisible() const {
+			return std::any_of(points.begin(), points.end(), [](const DrawPoint &a_point) { return a_point.A > 0.0f; });
+		}
+
+		void Text::rebuildGlyphs() {
+			dirtyGlyphs = false;
+			formattedText->changesHandled();
+			for (auto&& batch : glyphBatches) {
+				batch->points.clear();
+				batch->indices.clear();
+				batch->dirty = true;
+			}
+			hasGlyphs = false;
+			glyphBounds = BoxAABB<>();
+
+			auto origin = points[0].point();
+			formattedText->eachVisibleCharacter([&](const FormattedCharacter &a_character) {
+				auto page = a_character.character->texture();
+				auto found = std::find_if(glyphBatches.begin(), glyphBatches.end(), [&](const std::unique_ptr<GlyphBatch> &a_batch) { return a_batch->page == page; });
+				if (found == glyphBatches.end()) {
+					glyphBatches.push_back(std::make_unique<GlyphBatch>());
+					glyphBatches.back()->page = page;
+					found = glyphBatches.end() - 1;
+				}
+				auto& batch = **found;
+
+				auto topLeft = origin + a_character.drawPosition();
+				auto size = a_character.drawSize();
+				Point<> bottomRight(topLeft.x + size.width, topLeft.y + size.height, topLeft.z);
+				auto& uv = a_character.character->textureBounds();
+				auto& color = a_character.state->color;
+
+				appendQuadVertexIndices(batch.indices, static_cast<GLuint>(batch.points.size()));
+				batch.points.push_back(DrawPoint(topLeft, color, TexturePoint(uv.minPoint.x, uv.minPoint.y)));
+				batch.points.push_back(DrawPoint(Point<>(topLeft.x, bottomRight.y, topLeft.z), color, TexturePoint(uv.minPoint.x, uv.maxPoint.y)));
+				batch.points.push_back(DrawPoint(bottomRight, color, TexturePoint(uv.maxPoint.x, uv.maxPoint.y)));
+				batch.points.push_back(DrawPoint(Point<>(bottomRight.x, topLeft.y, topLeft.z), color, TexturePoint(uv.maxPoint.x, uv.minPoint.y)));
+
+				if (hasGlyphs) {
+					glyphBounds.expandWith(topLeft);
+				} else {
+					glyphBounds = BoxAABB<>(topLeft);
+					hasGlyphs = true;
+				}
+				glyphBounds.expandWith(bottomRight);
+			});
+			glyphBatches.erase(std::remove_if(glyphBatches.begin(), glyphBatches.end(), [](const std::unique_ptr<GlyphBatch> &a_batch) { return a_batch->points.empty(); }), glyphBatches.end());
+		}
+
+		BoxAABB<> Text::cullBounds() {
+			if (dirtyGlyphs || formattedText->changed()) {
+				rebuildGlyphs();
+			}
+			auto result = bounds();
+			if (hasGlyphs) {
+				result.expandWith(glyphBounds);
+			}
+			return result;
+		}
+
+		void Text::defaultDrawImplementation() {
+			if (backgroundVisible()) {
+				Drawable::defaultDrawImplementation();
+			}
+			if (dirtyGlyphs || formattedText->changed()) {
+				rebuildGlyphs();
+			}
+			if (glyphBatches.empty()) {
+				return;
+			}
+
+			auto& ourRenderer = owner()->renderer();
+			if (ourRenderer.renderQueue().enabled() && batchable()) {
+				auto glyphState = queuedState;
+				glyphState.shader = shaderProgram;
+				glyphState.cameraId = owner()->cameraId();
+				glyphState.defaultBlend = !presetBlendFunction(glyphState.blendSource, glyphState.blendDestination);
+				for (auto&& batch : glyphBatches) {
+					glyphState.textures = { batch->page };
+					ourRenderer.renderQueue().push(glyphState, owner()->worldTransform(), batch->points, batch->indices);
+				}
+			} else if (!ourRenderer.headless()) {
+				ourRenderer.renderQueue().flush();
+				require<ResourceException>(shaderProgram, "No shader program for Text!");
+				shaderProgram->use();
+				applyPresetBlendMode(ourRenderer);
+
+				materialSettingsImplementation(shaderProgram);
+				if (userMaterialSettings) {
+					try { userMaterialSettings(shaderProgram); } catch (std::exception &e) { MV::error("Text::defaultDrawImplementation. Exception in userMaterialSettings: ", e.what()); }
+				}
+
+				auto& state = ourRenderer.renderState();
+				for (auto&& batch : glyphBatches) {
+					if (batch->dirty) {
+						batch->dirty = false;
+						batch->buffer.points(state, batch->points);
+						batch->buffer.indices(state, batch->indices);
+					}
+					batch->buffer.bind(state);
+					shaderProgram->set(ShaderUniform::texture(0), batch->page, 0);
+					batch->buffer.draw(GL_TRIANGLES, batch->indices.size());
+				}
+			}
+		}
+
 		void Text::updateImplementation(double a_dt) {
 			if (displayCursor) {
 				accumulatedTime += a_dt;
@@ -184,7 +290,6 @@ namespace MV{
 
 		void Text::detachImplementation() {
 			Drawable::detachImplementation();
-			formattedText->scene()->removeFromParent();
 			if (cursorSprite && cursorSprite->ownerIsAlive()) {
 				cursorSprite->owner()->removeFromParent();
 			}
@@ -196,7 +301,7 @@ namespace MV{
 			points[2] = a_bounds.maxPoint;
 			points[3].x = a_bounds.maxPoint.x;	points[3].y = a_bounds.minPoint.y;	points[3].z = points[1].z;
 
-			formattedText->scene()->position(a_bounds.minPoint);
+			dirtyGlyphs = true;
 			if (usingBoundsForLineHeight) {
 				formattedText->minimumLineHeight(a_bounds.height());
 			}
@@ -168,9 +168,10 @@ namespace MV{
 
 			virtual void initialize() override;
 
-			virtual void defaultDrawImplementation() {
-				Drawable::defaultDrawImplementation();
-			}
+			//draws the background quad only when it's visible, then one mesh per glyph atlas page.
+			virtual void defaultDrawImplementation() override;
+
+			virtual BoxAABB<> cullBounds() override;
 
 			Text(const std::weak_ptr<Node> &a_owner, TextLibrary& a_textLibrary, const std::string &a_defaultFontIdentifier);
 
@@ -203,7 +204,6 @@ namespace MV{
 
 				construct(std::shared_ptr<Node>(), *library);
 
-				construct->formattedText->scene()->removeFromParent();
 				construct->load(archive, version);
 
 				construct->initialize();
@@ -251,6 +251,23 @@ namespace MV{
 				setCursor(cursor + a_change);
 			}
 
+			bool backgroundVisible() const;
+
+			void rebuildGlyphs();
+
+			struct GlyphBatch {
+				std::shared_ptr<TextureDefinition> page;
+				std::vector<DrawPoint> points;
+				std::vector<GLuint> indices;
+				DrawBuffer buffer;
+				bool dirty = true;
+			};
+			//almost always a single batch, a new one only starts when the text spans atlas pages.
+			std::vector<std::unique_ptr<GlyphBatch>> glyphBatches;
+			BoxAABB<> glyphBounds;
+			bool hasGlyphs = false;
+			bool dirtyGlyphs = true;
+
 			TextLibrary& textLibrary;
 
 			std::shared_ptr<FormattedText> formattedText;
@@ -1,5 +1,5 @@
 ﻿#include "formattedText.h"
-#include "MV/Render/Scene/sprite.h"
+#include "MV/Render/textures.h"
 #include <algorithm>
 #include "MV/Utility/log.h"
 #include "MV/Utility/tinyutf8.h"
@@ -40,12 +40,13 @@ namespace MV {
 	std::shared_ptr<CharacterDefinition> FontDefinition::characterDefinition(const std::string &renderChar) {
 		std::shared_ptr<CharacterDefinition> &character = cachedGlyphs[renderChar];
 		if(!character){
+			Size<int> glyphSize;
+			if (TTF_SizeUTF8(font, renderChar.c_str(), &glyphSize.width, &glyphSize.height) != 0) {
+				glyphSize = Size<int>();
+			}
 			character = CharacterDefinition::make(
-				SurfaceTextureDefinition::make(renderChar, [=]() -> std::shared_ptr<OwnedSurface> {
-					if (textLibrary->renderer().headless()) { return nullptr; }
-					
-					return OwnedSurface::make(TTF_RenderUTF8_Blended(font, renderChar.c_str(), {255, 255, 255, 255}));
-				}),
+				textLibrary->atlas().add(shared_from_this(), renderChar, glyphSize),
+				glyphSize,
 				renderChar,
 				shared_from_this()
 			);
@@ -56,38 +57,135 @@ namespace MV {
 
 
 
+	/*************************\
+	| ------GlyphAtlas------- |
+	\*************************/
+
+	GlyphAtlas::Placement GlyphAtlas::add(const std::shared_ptr<FontDefinition> &a_font, const std::string &a_character, const Size<int> &a_size) {
+		Placement result;
+		if (a_size.width <= 0 || a_size.height <= 0) {
+			return result;
+		}
+		require<ResourceException>(a_size.width + Padding * 2 <= PageSize && a_size.height + Padding * 2 <= PageSize, "GlyphAtlas::add glyph [", a_character, "] does not fit in an atlas page: ", a_size);
+
+		Point<int> position;
+		std::shared_ptr<Page> target;
+		for (auto&& page : pages) {
+			if (page->place(a_size, position)) {
+				target = page;
+				break;
+			}
+		}
+		if (!target) {
+			target = std::make_shared<Page>();
+			std::weak_ptr<Page> weakPage = target;
+			target->texture = SurfaceTextureDefinition::make("GlyphAtlas" + std::to_string(pages.size()), [=]() {
+				auto lockedPage = weakPage.lock();
+				return lockedPage ? lockedPage->render() : makeSurface({PageSize, PageSize});
+			});
+			target->place(a_size, position);
+			pages.push_back(target);
+		}
+
+		target->glyphs.push_back({a_font, a_character, position, a_size});
+		if (!target->handle) {
+			target->handle = target->texture->makeHandle();
+		} else if (target->texture->loaded()) {
+			target->texture->updateRegion(renderGlyph(target->glyphs.back()), position);
+		}
+
+		result.page = target->texture;
+		result.area = BoxAABB<int>(position, a_size);
+		result.percent = BoxAABB<PointPrecision>(
+			Point<>(static_cast<PointPrecision>(result.area.minPoint.x) / PageSize, static_cast<PointPrecision>(result.area.minPoint.y) / PageSize),
+			Point<>(static_cast<PointPrecision>(result.area.maxPoint.x) / PageSize, static_cast<PointPrecision>(result.area.maxPoint.y) / PageSize));
+		return result;
+	}
+
+	bool GlyphAtlas::Page::place(const Size<int> &a_size, Point<int> &a_position) {
+		int width = a_size.width + Padding * 2;
+		int height = a_size.height + Padding * 2;
+		Point<int> start = shelf;
+		int startHeight = shelfHeight;
+		if (start.x + width > PageSize) {
+			start.x = 0;
+			start.y += shelfHeight;
+			startHeight = 0;
+		}
+		if (start.y + height > PageSize) {
+			return false;
+		}
+		a_position = Point<int>(start.x + Padding, start.y + Padding);
+		shelf = Point<int>(start.x + width, start.y);
+		shelfHeight = std::max(startHeight, height);
+		return true;
+	}
+
+	std::shared_ptr<OwnedSurface> GlyphAtlas::Page::render() const {
+		auto surface = makeSurface({PageSize, PageSize});
+		for (auto&& glyph : glyphs) {
+			auto rendered = renderGlyph(glyph);
+			if (rendered) {
+				SDL_Rect destination{glyph.position.x, glyph.position.y, glyph.size.width, glyph.size.height};
+				SDL_BlitSurface(rendered->get(), nullptr, surface->get(), &destination);
+			}
+		}
+		return surface;
+	}
+
+	std::shared_ptr<OwnedSurface> GlyphAtlas::makeSurface(const Size<int> &a_size) {
+		int bpp;
+		Uint32 Rmask, Gmask, Bmask, Amask;
+		SDL_PixelFormatEnumToMasks(SDL_PIXELFORMAT_ABGR8888, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+		return OwnedSurface::make(SDL_CreateRGBSurface(0, a_size.width, a_size.height, bpp, Rmask, Gmask, Bmask, Amask));
+	}
+
+	//always exactly the glyph's slot size, so nothing bleeds into its neighbours.
+	std::shared_ptr<OwnedSurface> GlyphAtlas::renderGlyph(const Glyph &a_glyph) {
+		auto font = a_glyph.font.lock();
+		if (!font || !font->font) {
+			return nullptr;
+		}
+		auto rendered = OwnedSurface::make(TTF_RenderUTF8_Blended(font->font, a_glyph.character.c_str(), {255, 255, 255, 255}));
+		if (!rendered->get()) {
+			return nullptr;
+		}
+		auto result = makeSurface(a_glyph.size);
+		SDL_SetSurfaceBlendMode(rendered->get(), SDL_BLENDMODE_NONE);
+		SDL_BlitSurface(rendered->get(), nullptr, result->get(), nullptr);
+		SDL_SetSurfaceBlendMode(result->get(), SDL_BLENDMODE_NONE);
+		return result;
+	}
+
+
+
+
 
 	/*************************\
 	| --CharacterDefinition-- |
 	\*************************/
 
-	std::shared_ptr<CharacterDefinition> CharacterDefinition::make(std::shared_ptr<SurfaceTextureDefinition> a_texture, const std::string &a_glyphCharacter, std::shared_ptr<FontDefinition> a_fontDefinition) {
-		return std::shared_ptr<CharacterDefinition>(new CharacterDefinition(a_texture, a_glyphCharacter, a_fontDefinition));
+	std::shared_ptr<CharacterDefinition> CharacterDefinition::make(const GlyphAtlas::Placement &a_placement, const Size<int> &a_size, const std::string &a_glyphCharacter, std::shared_ptr<FontDefinition> a_fontDefinition) {
+		return std::shared_ptr<CharacterDefinition>(new CharacterDefinition(a_placement, a_size, a_glyphCharacter, a_fontDefinition));
 	}
 	
-	CharacterDefinition::CharacterDefinition(std::shared_ptr<SurfaceTextureDefinition> a_texture, const std::string &a_glyphCharacter, std::shared_ptr<FontDefinition> a_fontDefinition):
-		glyphTexture(a_texture),
-		glyphHandle(a_texture->makeHandle()),
+	CharacterDefinition::CharacterDefinition(const GlyphAtlas::Placement &a_placement, const Size<int> &a_size, const std::string &a_glyphCharacter, std::shared_ptr<FontDefinition> a_fontDefinition):
 		glyphCharacter(a_glyphCharacter),
+		placement(a_placement),
+		glyphSize(a_size),
 		fontDefinition(a_fontDefinition){
-
-		glyphHandle->bounds(glyphTexture->surfaceSize());
 	}
 
 	std::string CharacterDefinition::character() const{
 		return glyphCharacter;
 	}
 
-	std::shared_ptr<TextureHandle> CharacterDefinition::texture() const{
-		return glyphHandle;
+	std::shared_ptr<SurfaceTextureDefinition> CharacterDefinition::texture() const{
+		return placement.page;
 	}
 
 	Size<int> CharacterDefinition::characterSize() const{
-		return (glyphTexture) ? glyphTexture->surfaceSize() : Size<int>(0, 0);
-	}
-
-	Size<int> CharacterDefinition::textureSize() const{
-		return (glyphTexture) ? glyphTexture->size() : Size<int>(0, 0);
+		return glyphSize;
 	}
 
 	bool CharacterDefinition::isSoftBreakCharacter() {
@@ -165,14 +263,8 @@ namespace MV {
 	| ---FormattedCharacter-- |
 	\*************************/
 
-	FormattedCharacter::~FormattedCharacter() {
-		if(shape){
-			shape->removeFromParent();
-		}
-	}
-
-	std::shared_ptr<FormattedCharacter> FormattedCharacter::make(const std::shared_ptr<Scene::Node> &parent, const std::string &a_character, const std::shared_ptr<FormattedState> &a_state, bool a_isPassword) {
-		return std::shared_ptr<FormattedCharacter>(new FormattedCharacter(parent, a_character, a_state, a_isPassword));
+	std::shared_ptr<FormattedCharacter> FormattedCharacter::make(FormattedText &a_text, const std::string &a_character, const std::shared_ptr<FormattedState> &a_state, bool a_isPassword) {
+		return std::shared_ptr<FormattedCharacter>(new FormattedCharacter(a_text, a_character, a_state, a_isPassword));
 	}
 
 	Size<> FormattedCharacter::characterSize() const {
@@ -188,8 +280,10 @@ namespace MV {
 	}
 
 	Point<> FormattedCharacter::position(const Point<> &a_newPosition) {
-		basePosition = a_newPosition;
-		shape->silence()->position((basePosition + offsetPosition) * characterScale);
+		if (basePosition != a_newPosition) {
+			basePosition = a_newPosition;
+			text->markChanged();
+		}
 		return basePosition;
 	}
 
@@ -198,8 +292,10 @@ namespace MV {
 	}
 
 	Point<> FormattedCharacter::offset(const Point<> &a_newPosition) {
-		offsetPosition = a_newPosition;
-		shape->silence()->position((basePosition + offsetPosition) * characterScale);
+		if (offsetPosition != a_newPosition) {
+			offsetPosition = a_newPosition;
+			text->markChanged();
+		}
 		return offsetPosition;
 	}
 
@@ -207,7 +303,6 @@ namespace MV {
 		PointPrecision height = character->font()->height();
 		PointPrecision base = character->font()->base();
 		offset({offsetPosition.x, a_baseLine - base});
-		shape->silence()->position((basePosition + offsetPosition) * characterScale);
 		return offsetPosition;
 	}
 
@@ -215,7 +310,6 @@ namespace MV {
 		PointPrecision height = character->font()->height();
 		PointPrecision base = character->font()->base();
 		offset({ a_x, a_baseLine - base });
-		shape->silence()->position((basePosition + offsetPosition) * characterScale);
 		return offsetPosition;
 	}
 
@@ -224,25 +318,19 @@ namespace MV {
 	}
 	void FormattedCharacter::scale(const Scale& a_scale){
 		characterScale = a_scale;
-		shape->silence()->position((basePosition + offsetPosition) * characterScale)->component<Scene::Sprite>()->bounds(cast<PointPrecision>(character->characterSize()) * characterScale);
+		text->markChanged();
 	}
 
 	void FormattedCharacter::applyState(const std::shared_ptr<FormattedState> &a_state, bool a_isPassword) {
 		state = a_state;
 		character = a_isPassword ? a_state->font->characterDefinition(U8_STR("●")) : state->font->characterDefinition(textCharacter);
-		auto silencedShape = shape->silence();
-		auto sprite = shape->component<Scene::Sprite>();
-		sprite->bounds(cast<PointPrecision>(character->characterSize()) * characterScale);
-		sprite->texture(character->texture());
-		sprite->color(state->color);
+		text->markChanged();
 	}
 
 	bool FormattedCharacter::partOfFormat(bool a_isPartOfFormat) {
-		isPartOfFormat = a_isPartOfFormat;
-		if(isPartOfFormat){
-			shape->silence()->hide();
-		} else{
-			shape->silence()->show();
+		if (isPartOfFormat != a_isPartOfFormat) {
+			isPartOfFormat = a_isPartOfFormat;
+			text->markChanged();
 		}
 		return isPartOfFormat;
 	}
@@ -255,24 +343,13 @@ namespace MV {
 		return character->isSoftBreakCharacter();
 	}
 
-	void FormattedCharacter::removeFromParent() {
-		if(shape){
-			shape->removeFromParent();
-		}
-	}
-
-	FormattedCharacter::FormattedCharacter(const std::shared_ptr<Scene::Node> &parent, const std::string &a_character, const std::shared_ptr<FormattedState> &a_state, bool a_isPassword):
+	FormattedCharacter::FormattedCharacter(FormattedText &a_text, const std::string &a_character, const std::shared_ptr<FormattedState> &a_state, bool a_isPassword):
 		textCharacter(a_character),
 		state(a_state),
-		character(a_isPassword ? a_state->font->characterDefinition(U8_STR("●")) : a_state->font->characterDefinition(a_character)) {
+		character(a_isPassword ? a_state->font->characterDefinition(U8_STR("●")) : a_state->font->characterDefinition(a_character)),
+		text(&a_text) {
 
-		shape = parent->silence()->make(guid(character->character()))->
-			attach<Scene::Sprite>()->
-			bounds(cast<PointPrecision>(character->characterSize()))->
-			texture(character->texture())->
-			color(state->color)->
-			shader(MV::PREMULTIPLY_ID)->
-			owner();
+		text->markChanged();
 	}
 
 
@@ -561,9 +638,9 @@ namespace MV {
 		}
 
 		for(size_t i = a_characterIndex; i < characters.size() && i < a_characterIndex + a_totalToRemove; ++i){
-			characters[i]->removeFromParent();
 			result.push_back(characters[i]);
 		}
+		text.markChanged();
 		characters.erase(characters.begin() + a_characterIndex, characters.begin() + a_characterIndex + a_totalToRemove);
 		for (int64_t i = minLineIndex; i <= maxLineIndex; ++i) {
 			text.lines[static_cast<size_t>(i)]->fixVisuals();
@@ -638,8 +715,6 @@ namespace MV {
 		textWrapping(a_wrapping),
 		textJustification(a_justification),
 		minimumTextLineHeight(-1){
-
-		textScene = Scene::Node::make(library->renderer())->serializable(false);
 	}
 
 	PointPrecision FormattedText::width(PointPrecision a_width) {
@@ -705,7 +780,10 @@ namespace MV {
 	}
 
 	void FormattedText::clear() {
-		lines.clear();
+		if (!lines.empty()) {
+			lines.clear();
+			markChanged();
+		}
 	}
 
 	std::shared_ptr<FormattedCharacter> FormattedText::characterRelativeTo(size_t a_lineIndex, size_t a_characterIndex, int64_t a_relativeCharacterIndex) {
@@ -718,7 +796,6 @@ namespace MV {
 	}
 
 	void FormattedText::applyState(const std::shared_ptr<FormattedState> &a_newState, size_t a_newFormatStart, size_t a_newFormatEnd) {
-		auto silenced = scene()->silence();
 		std::shared_ptr<FormattedState> originalState;
 		size_t i = a_newFormatStart;
 		for(auto character = characterForIndex(i); character; ++i, character = characterForIndex(i)){
@@ -792,7 +869,6 @@ namespace MV {
 	}
 
 	void FormattedText::erase(size_t a_startIndex, size_t a_count) {
-		auto silenced = scene()->silence();
 		if(a_count == 0){
 			return;
 		}
@@ -825,8 +901,8 @@ namespace MV {
 
 	void FormattedText::removeLines(size_t a_startIndex, size_t a_count) {
 		if(a_count > 0){
-			auto silenced = scene()->silence();
 			lines.erase(lines.begin() + a_startIndex, lines.begin() + a_startIndex + a_count);
+			markChanged();
 			for(size_t i = a_startIndex; i < lines.size(); ++i){
 				lines[i]->index(i);
 			}
@@ -843,7 +919,6 @@ namespace MV {
 		if(a_characters.empty()){
 			return 0;
 		}
-		auto silenced = scene()->silence();
 		std::shared_ptr<FormattedLine> line;
 		size_t characterInLineIndex;
 		std::tie(line, characterInLineIndex) = lineForCharacterIndex(a_startIndex);
@@ -862,7 +937,7 @@ namespace MV {
 		std::vector<std::shared_ptr<FormattedCharacter>> formattedCharacters;
 		utf8_string utfCharacters(a_characters);
 		for (auto it = utfCharacters.begin(); it != utfCharacters.end();++it) {
-			formattedCharacters.push_back(FormattedCharacter::make(textScene, it.str(), foundState, showAsPassword));
+			formattedCharacters.push_back(FormattedCharacter::make(*this, it.str(), foundState, showAsPassword));
 			++inserted;
 		}
 
@@ -874,7 +949,6 @@ namespace MV {
 		if(a_characters.empty()){
 			return;
 		}
-		auto silenced = scene()->silence();
 		std::shared_ptr<FormattedLine> line;
 		size_t characterInLineIndex;
 		std::tie(line, characterInLineIndex) = lineForCharacterIndex(a_startIndex);
@@ -885,7 +959,6 @@ namespace MV {
 		if(a_characters.empty()){
 			return;
 		}
-		auto silenced = scene()->silence();
 		if(lines.empty()){
 			lines.push_back(FormattedLine::make(*this, lines.size()));
 		}
@@ -897,7 +970,6 @@ namespace MV {
 		if(a_characters.empty()){
 			return 0;
 		}
-		auto silenced = scene()->silence();
 		std::shared_ptr<FormattedState> foundState = defaultState();
 		if(lines.empty()){
 			lines.push_back(FormattedLine::make(*this, lines.size()));
@@ -914,7 +986,7 @@ namespace MV {
 		utf8_string utfCharacters(a_characters);
 		std::shared_ptr<FormattedLine> line = lines.back();
 		for (auto it = utfCharacters.begin(); it != utfCharacters.end(); ++it) {
-			formattedCharacters.push_back(FormattedCharacter::make(textScene, it.str(), foundState, showAsPassword));
+			formattedCharacters.push_back(FormattedCharacter::make(*this, it.str(), foundState, showAsPassword));
 			++inserted;
 		}
 
@@ -929,7 +1001,6 @@ namespace MV {
 	MV::PointPrecision FormattedText::minimumLineHeight(PointPrecision a_minimumLineHeight) {
 		if (!equals(minimumTextLineHeight, a_minimumLineHeight)) {
 			minimumTextLineHeight = a_minimumLineHeight;
-			auto silenced = scene()->silence();
 			for (auto line : lines) {
 				line->minimumLineHeightChanged();
 			}
@@ -939,7 +1010,6 @@ namespace MV {
 
 	void FormattedText::justification(TextJustification a_newJustification) {
 		if(textJustification != a_newJustification){
-			auto silenced = scene()->silence();
 			textJustification = a_newJustification;
 			for(auto &line : lines){
 				line->applyAlignmentAndScale();
@@ -953,7 +1023,6 @@ namespace MV {
 
 	void FormattedText::wrapping(TextWrapMethod a_newWrapping, PointPrecision a_newWidth) {
 		if (textWrapping != a_newWrapping || !equals(textWidth, a_newWidth)) {
-			auto silenced = scene()->silence();
 			textWidth = a_newWidth;
 			textWrapping = a_newWrapping;
 			for (auto&& line : lines) {
@@ -964,7 +1033,6 @@ namespace MV {
 
 	void FormattedText::wrapping(TextWrapMethod a_newWrapping) {
 		if (textWrapping != a_newWrapping) {
-			auto silenced = scene()->silence();
 			textWrapping = a_newWrapping;
 			for (auto&& line : lines) {
 				line->fixVisuals();
@@ -976,8 +1044,4 @@ namespace MV {
 		return textWrapping;
 	}
 
-	std::shared_ptr<Scene::Node> FormattedText::scene() const {
-		return textScene;
-	}
-
 }
\ No newline at end of file
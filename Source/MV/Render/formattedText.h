@@ -6,17 +6,15 @@
 #include <math.h>
 #include <memory>
 #include <map>
+#include <functional>
 #include "MV/Utility/generalUtility.h"
 #include "MV/Utility/services.hpp"
 #include "SDL_ttf.h"
 #include "MV/Render/points.h"
+#include "MV/Render/boxaabb.h"
 #include "cereal/archives/adapters.hpp"
 
 namespace MV {
-	namespace Scene{
-		class Node;
-		class Sprite;
-	}
 	extern const UtfString COLOR_IDENTIFIER;
 	extern const UtfString FONT_IDENTIFIER;
 	extern const UtfString HEIGHT_IDENTIFIER;
@@ -57,10 +55,12 @@ namespace MV {
 
 	class CharacterDefinition;
 	class TextLibrary;
+	class GlyphAtlas;
 	///////////////////////////////////
 	class FontDefinition : public std::enable_shared_from_this<FontDefinition>{
 		friend cereal::access;
 		friend TextLibrary;
+		friend GlyphAtlas;
 		friend std::ostream& operator<<(std::ostream&, const FontDefinition&);
 	public:
 		static std::shared_ptr<FontDefinition> make(TextLibrary &a_library, const std::string &a_identifier, const std::string &a_file, int a_size, FontStyle a_style = FontStyle::NORMAL);
@@ -152,24 +152,78 @@ namespace MV {
 	///////////////////////////////////
 	class SurfaceTextureDefinition;
 	class TextureHandle;
+	struct OwnedSurface;
+	//Packs the glyphs of every font in a TextLibrary into shared pages so a whole block of text draws from one texture.
+	class GlyphAtlas {
+	public:
+		static const int PageSize = 1024;
+		static const int Padding = 1;
+
+		struct Placement {
+			std::shared_ptr<SurfaceTextureDefinition> page; //null for glyphs without any pixels.
+			BoxAABB<int> area;
+			BoxAABB<PointPrecision> percent;
+		};
+
+		GlyphAtlas() {}
+
+		Placement add(const std::shared_ptr<FontDefinition> &a_font, const std::string &a_character, const Size<int> &a_size);
+
+		size_t pageCount() const {
+			return pages.size();
+		}
+	private:
+		GlyphAtlas(const GlyphAtlas &) = delete;
+		GlyphAtlas& operator=(const GlyphAtlas &) = delete;
+
+		struct Glyph {
+			std::weak_ptr<FontDefinition> font;
+			std::string character;
+			Point<int> position;
+			Size<int> size;
+		};
+
+		//glyphs fill shelves left to right, a new shelf starts below the tallest glyph of the last one.
+		struct Page {
+			std::shared_ptr<SurfaceTextureDefinition> texture;
+			std::shared_ptr<TextureHandle> handle; //keeps the page loaded.
+			std::vector<Glyph> glyphs;
+			Point<int> shelf;
+			int shelfHeight = 0;
+
+			bool place(const Size<int> &a_size, Point<int> &a_position);
+			std::shared_ptr<OwnedSurface> render() const;
+		};
+
+		static std::shared_ptr<OwnedSurface> makeSurface(const Size<int> &a_size);
+		static std::shared_ptr<OwnedSurface> renderGlyph(const Glyph &a_glyph);
+
+		std::vector<std::shared_ptr<Page>> pages;
+	};
+
+	///////////////////////////////////
 	class CharacterDefinition {
 	public:
-		static std::shared_ptr<CharacterDefinition> make(std::shared_ptr<SurfaceTextureDefinition> a_texture, const std::string &a_glyphCharacter, std::shared_ptr<FontDefinition> a_fontDefinition);
+		static std::shared_ptr<CharacterDefinition> make(const GlyphAtlas::Placement &a_placement, const Size<int> &a_size, const std::string &a_glyphCharacter, std::shared_ptr<FontDefinition> a_fontDefinition);
 		
 		std::string character() const;
-		std::shared_ptr<TextureHandle> texture() const;
+		//the atlas page this glyph lives on, null for glyphs that draw nothing.
+		std::shared_ptr<SurfaceTextureDefinition> texture() const;
+		//0-1 texture coordinates of the glyph within its page.
+		const BoxAABB<PointPrecision>& textureBounds() const {
+			return placement.percent;
+		}
 		Size<int> characterSize() const;
-		Size<int> textureSize() const;
 
 		bool isSoftBreakCharacter();
 
 		std::shared_ptr<FontDefinition> font() const;
 	private:
-		CharacterDefinition(std::shared_ptr<SurfaceTextureDefinition> a_texture, const std::string &a_glyphCharacter, std::shared_ptr<FontDefinition> a_fontDefinition);
+		CharacterDefinition(const GlyphAtlas::Placement &a_placement, const Size<int> &a_size, const std::string &a_glyphCharacter, std::shared_ptr<FontDefinition> a_fontDefinition);
 
 		std::string glyphCharacter;
-		std::shared_ptr<SurfaceTextureDefinition> glyphTexture;
-		std::shared_ptr<TextureHandle> glyphHandle;
+		GlyphAtlas::Placement placement;
+		Size<int> glyphSize;
 		std::shared_ptr<FontDefinition> fontDefinition;
 	};
 
@@ -185,6 +239,8 @@ namespace MV {
 		std::shared_ptr<FontDefinition> get(const std::string &a_identifier) const;
 
 		Draw2D& renderer(){return render;}
+
+		GlyphAtlas& atlas(){return glyphAtlas;}
 	private:
 		template <class Archive>
 		void serialize(Archive & archive, std::uint32_t const /*version*/){
@@ -205,6 +261,7 @@ namespace MV {
 		}
 
 		std::map<std::string, std::shared_ptr<FontDefinition>> loadedFonts;
+		GlyphAtlas glyphAtlas;
 		SDL_Color white;
 		Draw2D& render;
 	};
@@ -222,11 +279,12 @@ namespace MV {
 	};
 
 	class FormattedLine;
+	class FormattedText;
 	///////////////////////////////////
+	//Layout for one character, drawing is left to whoever builds a mesh from FormattedText::eachVisibleCharacter.
 	class FormattedCharacter{
 	public:
-		~FormattedCharacter();
-		static std::shared_ptr<FormattedCharacter> make(const std::shared_ptr<Scene::Node> &parent, const std::string &a_character, const std::shared_ptr<FormattedState> &a_state, bool a_isPassword);
+		static std::shared_ptr<FormattedCharacter> make(FormattedText &a_text, const std::string &a_character, const std::shared_ptr<FormattedState> &a_state, bool a_isPassword);
 
 		Size<> characterSize() const;
 
@@ -246,23 +304,28 @@ namespace MV {
 		bool partOfFormat() const;
 		bool isSoftBreakCharacter() const;
 
-		void removeFromParent();
+		//top left of the drawn glyph, relative to the text origin.
+		Point<> drawPosition() const {
+			return (basePosition + offsetPosition) * characterScale;
+		}
+		Size<> drawSize() const {
+			return cast<PointPrecision>(character->characterSize()) * characterScale;
+		}
 
 		std::string textCharacter;
 		std::shared_ptr<CharacterDefinition> character;
-		std::shared_ptr<Scene::Node> shape;
 		std::weak_ptr<FormattedLine> line;
 		std::shared_ptr<FormattedState> state;
 
 	private:
+		FormattedText* text;
 		bool isPartOfFormat = false;
 		Point<> basePosition;
 		Point<> offsetPosition;
 		Scale characterScale;
-		FormattedCharacter(const std::shared_ptr<Scene::Node> &parent, const std::string &a_character, const std::shared_ptr<FormattedState> &a_state, bool a_isPassword);
+		FormattedCharacter(FormattedText &a_text, const std::string &a_character, const std::shared_ptr<FormattedState> &a_state, bool a_isPassword);
 	};
 
-	class FormattedText;
 	///////////////////////////////////
 	class FormattedLine : public std::enable_shared_from_this<FormattedLine> {
 		friend FormattedText;
@@ -318,6 +381,7 @@ namespace MV {
 	class FormattedText{
 		friend cereal::access;
 		friend FormattedLine;
+		friend FormattedCharacter;
 	public:
 		FormattedText(const FormattedText& a_rhs);
 		FormattedText(TextLibrary &a_library, const std::string &a_defaultStateIdentifier, PointPrecision a_width, TextWrapMethod a_wrapping = TextWrapMethod::SOFT, TextJustification a_justification = TextJustification::LEFT);
@@ -388,7 +452,28 @@ namespace MV {
 		void wrapping(TextWrapMethod a_newWrapping);
 		TextWrapMethod wrapping() const;
 
-		std::shared_ptr<Scene::Node> scene() const;
+		//calls a_visitor with every character that draws, in order.
+		template <typename Visitor>
+		void eachVisibleCharacter(Visitor &&a_visitor) const {
+			for (auto&& line : lines) {
+				for (auto&& character : line->characters) {
+					if (!character->partOfFormat() && character->character->texture()) {
+						a_visitor(*character);
+					}
+				}
+			}
+		}
+
+		//called once when the layout first changes after the last call to changesHandled().
+		void onChange(std::function<void()> a_onChange) {
+			onChangeCallback = a_onChange;
+		}
+		bool changed() const {
+			return dirtyLayout;
+		}
+		void changesHandled() {
+			dirtyLayout = false;
+		}
 
 		FormattedText& operator=(const FormattedText& a_rhs) {
 			defaultState(a_rhs.defaultStateIdentifier);
@@ -451,13 +536,23 @@ namespace MV {
 
 		mutable TextLibrary *library;
 		TextWrapMethod textWrapping;
+		void markChanged() {
+			if (!dirtyLayout) {
+				dirtyLayout = true;
+				if (onChangeCallback) {
+					onChangeCallback();
+				}
+			}
+		}
+
 		std::vector<std::shared_ptr<FormattedLine>> lines;
-		std::shared_ptr<Scene::Node> textScene;
 		std::string defaultStateIdentifier;
 		std::shared_ptr<FormattedState> cachedDefaultState;
 		PointPrecision textWidth;
 		PointPrecision minimumTextLineHeight;
 		bool showAsPassword = false;
+		bool dirtyLayout = true;
+		std::function<void()> onChangeCallback;
 
 		TextJustification textJustification = TextJustification::LEFT;
 	};
@@ -13,6 +13,14 @@
 #include <utility>
 #include "MV/Render/points.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define MV_MATRIX_SSE 1
+	#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define MV_MATRIX_NEON 1
+	#include <arm_neon.h>
+#endif
+
 namespace MV {
 
 	template<size_t SizeX, size_t SizeY = SizeX>
@@ -174,9 +182,31 @@ namespace MV {
 		return result;
 	}
 
+	//Each result column is the lhs columns weighted by the matching rhs column, 4 wide with SSE or NEON when available.
 	template <>
 	inline Matrix<4, 4> operator*(const Matrix<4, 4>& a_lhs, const Matrix<4, 4>& a_rhs) {
 		Matrix<4, 4> dest(MatrixInitialize::NoFill);
+#if defined(MV_MATRIX_SSE)
+		const __m128 column0 = _mm_loadu_ps(&a_lhs[0]);
+		const __m128 column1 = _mm_loadu_ps(&a_lhs[4]);
+		const __m128 column2 = _mm_loadu_ps(&a_lhs[8]);
+		const __m128 column3 = _mm_loadu_ps(&a_lhs[12]);
+		for (size_t p = 0; p < 4; ++p) {
+			const PointPrecision* weights = &a_rhs[p * 4];
+			_mm_storeu_ps(&dest[p * 4], _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(weights[0])), _mm_mul_ps(column1, _mm_set1_ps(weights[1]))),
+				_mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(weights[2])), _mm_mul_ps(column3, _mm_set1_ps(weights[3])))));
+		}
+#elif defined(MV_MATRIX_NEON)
+		const float32x4_t column0 = vld1q_f32(&a_lhs[0]);
+		const float32x4_t column1 = vld1q_f32(&a_lhs[4]);
+		const float32x4_t column2 = vld1q_f32(&a_lhs[8]);
+		const float32x4_t column3 = vld1q_f32(&a_lhs[12]);
+		for (size_t p = 0; p < 4; ++p) {
+			const PointPrecision* weights = &a_rhs[p * 4];
+			vst1q_f32(&dest[p * 4], vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(column0, weights[0]), column1, weights[1]), column2, weights[2]), column3, weights[3]));
+		}
+#else
 		dest(0, 0) = a_rhs(0, 0) * a_lhs(0, 0) + a_rhs(0, 1) * a_lhs(1, 0) + a_rhs(0, 2) * a_lhs(2, 0) + a_rhs(0, 3) * a_lhs(3, 0);
 		dest(0, 1) = a_rhs(0, 0) * a_lhs(0, 1) + a_rhs(0, 1) * a_lhs(1, 1) + a_rhs(0, 2) * a_lhs(2, 1) + a_rhs(0, 3) * a_lhs(3, 1);
 		dest(0, 2) = a_rhs(0, 0) * a_lhs(0, 2) + a_rhs(0, 1) * a_lhs(1, 2) + a_rhs(0, 2) * a_lhs(2, 2) + a_rhs(0, 3) * a_lhs(3, 2);
@@ -193,6 +223,7 @@ namespace MV {
 		dest(3, 1) = a_rhs(3, 0) * a_lhs(0, 1) + a_rhs(3, 1) * a_lhs(1, 1) + a_rhs(3, 2) * a_lhs(2, 1) + a_rhs(3, 3) * a_lhs(3, 1);
 		dest(3, 2) = a_rhs(3, 0) * a_lhs(0, 2) + a_rhs(3, 1) * a_lhs(1, 2) + a_rhs(3, 2) * a_lhs(2, 2) + a_rhs(3, 3) * a_lhs(3, 2);
 		dest(3, 3) = a_rhs(3, 0) * a_lhs(0, 3) + a_rhs(3, 1) * a_lhs(1, 3) + a_rhs(3, 2) * a_lhs(2, 3) + a_rhs(3, 3) * a_lhs(3, 3);
+#endif
 		return dest;
 	}
 
@@ -231,6 +262,73 @@ namespace MV {
 		};
 	}
 
+	//Homogeneous a_lhs * (x, y, z, 1) for a_count points, the batched form of fullMatrixPointMultiply.
+	inline void fullMatrixPointMultiply(const MV::Matrix<4, 4>& a_lhs, const Point<>* a_points, std::array<PointPrecision, 4>* a_results, size_t a_count) {
+#if defined(MV_MATRIX_SSE)
+		const __m128 column0 = _mm_loadu_ps(&a_lhs[0]);
+		const __m128 column1 = _mm_loadu_ps(&a_lhs[4]);
+		const __m128 column2 = _mm_loadu_ps(&a_lhs[8]);
+		const __m128 column3 = _mm_loadu_ps(&a_lhs[12]);
+		for (size_t i = 0; i < a_count; ++i) {
+			_mm_storeu_ps(a_results[i].data(), _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(a_points[i].x)), _mm_mul_ps(column1, _mm_set1_ps(a_points[i].y))),
+				_mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(a_points[i].z)), column3)));
+		}
+#elif defined(MV_MATRIX_NEON)
+		const float32x4_t column0 = vld1q_f32(&a_lhs[0]);
+		const float32x4_t column1 = vld1q_f32(&a_lhs[4]);
+		const float32x4_t column2 = vld1q_f32(&a_lhs[8]);
+		const float32x4_t column3 = vld1q_f32(&a_lhs[12]);
+		for (size_t i = 0; i < a_count; ++i) {
+			vst1q_f32(a_results[i].data(), vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(column3, column0, a_points[i].x), column1, a_points[i].y), column2, a_points[i].z));
+		}
+#else
+		for (size_t i = 0; i < a_count; ++i) {
+			a_results[i] = fullMatrixPointMultiply(a_lhs, a_points[i]);
+		}
+#endif
+	}
+
+	//Copies a_count points into a_destination with their positions multiplied by a_lhs (a_source may equal a_destination).
+	//Each position is done 4 wide as column0 * x + column1 * y + column2 * z + column3 with SSE or NEON when available.
+	inline void transformPoints(const MV::Matrix<4, 4>& a_lhs, const DrawPoint* a_source, DrawPoint* a_destination, size_t a_count) {
+#if defined(MV_MATRIX_SSE)
+		const __m128 column0 = _mm_loadu_ps(&a_lhs[0]);
+		const __m128 column1 = _mm_loadu_ps(&a_lhs[4]);
+		const __m128 column2 = _mm_loadu_ps(&a_lhs[8]);
+		const __m128 column3 = _mm_loadu_ps(&a_lhs[12]);
+		alignas(16) PointPrecision result[4];
+		for (size_t i = 0; i < a_count; ++i) {
+			const DrawPoint& source = a_source[i];
+			__m128 transformed = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(source.x)), _mm_mul_ps(column1, _mm_set1_ps(source.y))),
+				_mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(source.z)), column3));
+			_mm_store_ps(result, transformed);
+			a_destination[i] = source;
+			a_destination[i].x = result[0]; a_destination[i].y = result[1]; a_destination[i].z = result[2];
+		}
+#elif defined(MV_MATRIX_NEON)
+		const float32x4_t column0 = vld1q_f32(&a_lhs[0]);
+		const float32x4_t column1 = vld1q_f32(&a_lhs[4]);
+		const float32x4_t column2 = vld1q_f32(&a_lhs[8]);
+		const float32x4_t column3 = vld1q_f32(&a_lhs[12]);
+		PointPrecision result[4];
+		for (size_t i = 0; i < a_count; ++i) {
+			const DrawPoint& source = a_source[i];
+			float32x4_t transformed = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(column3, column0, source.x), column1, source.y), column2, source.z);
+			vst1q_f32(result, transformed);
+			a_destination[i] = source;
+			a_destination[i].x = result[0]; a_destination[i].y = result[1]; a_destination[i].z = result[2];
+		}
+#else
+		for (size_t i = 0; i < a_count; ++i) {
+			Point<> transformed = a_lhs * a_source[i].point();
+			a_destination[i] = a_source[i];
+			a_destination[i] = transformed;
+		}
+#endif
+	}
+
 	template<size_t SizeX, size_t SizeY>
 	inline Matrix<SizeX, SizeY> operator*(const Matrix<SizeX, SizeY> &a_left, const PointPrecision &a_right) {
 		Matrix<SizeX, SizeY> result{ a_left };
@@ -485,7 +583,71 @@ namespace MV {
 
 	};
 
+#if defined(MV_MATRIX_SSE)
+	namespace MatrixSSE {
+		//the 2x2 determinants of rows A and B against each pair of columns 1 to 3, in the lane order inverse combines them.
+		template<int A, int B>
+		inline __m128 subFactors(__m128 a_in1, __m128 a_in2, __m128 a_in3) {
+			const __m128 swapA = _mm_shuffle_ps(a_in3, a_in2, _MM_SHUFFLE(A, A, A, A));
+			const __m128 swapB = _mm_shuffle_ps(a_in3, a_in2, _MM_SHUFFLE(B, B, B, B));
+			const __m128 swap00 = _mm_shuffle_ps(a_in2, a_in1, _MM_SHUFFLE(B, B, B, B));
+			const __m128 swap01 = _mm_shuffle_ps(swapA, swapA, _MM_SHUFFLE(2, 0, 0, 0));
+			const __m128 swap02 = _mm_shuffle_ps(swapB, swapB, _MM_SHUFFLE(2, 0, 0, 0));
+			const __m128 swap03 = _mm_shuffle_ps(a_in2, a_in1, _MM_SHUFFLE(A, A, A, A));
+			return _mm_sub_ps(_mm_mul_ps(swap00, swap01), _mm_mul_ps(swap02, swap03));
+		}
+	}
+#endif
+
+	//a_det is set to the reciprocal determinant, or 0 (leaving the result unfilled) when a_in has no inverse.
 	inline TransformMatrix inverse(const Matrix<4, 4> &a_in, float& det) {
+#if defined(MV_MATRIX_SSE)
+		//cofactors by Cramer's rule, 2x2 sub-determinants of the last two columns first, 4 at a time.
+		const __m128 in0 = _mm_loadu_ps(&a_in[0]);
+		const __m128 in1 = _mm_loadu_ps(&a_in[4]);
+		const __m128 in2 = _mm_loadu_ps(&a_in[8]);
+		const __m128 in3 = _mm_loadu_ps(&a_in[12]);
+
+		const __m128 factor0 = MatrixSSE::subFactors<3, 2>(in1, in2, in3);
+		const __m128 factor1 = MatrixSSE::subFactors<3, 1>(in1, in2, in3);
+		const __m128 factor2 = MatrixSSE::subFactors<2, 1>(in1, in2, in3);
+		const __m128 factor3 = MatrixSSE::subFactors<3, 0>(in1, in2, in3);
+		const __m128 factor4 = MatrixSSE::subFactors<2, 0>(in1, in2, in3);
+		const __m128 factor5 = MatrixSSE::subFactors<1, 0>(in1, in2, in3);
+
+		const __m128 signA = _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+		const __m128 signB = _mm_set_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+
+		auto spread = [&](__m128 a_temp) { return _mm_shuffle_ps(a_temp, a_temp, _MM_SHUFFLE(2, 2, 2, 0)); };
+		const __m128 vector0 = spread(_mm_shuffle_ps(in1, in0, _MM_SHUFFLE(0, 0, 0, 0)));
+		const __m128 vector1 = spread(_mm_shuffle_ps(in1, in0, _MM_SHUFFLE(1, 1, 1, 1)));
+		const __m128 vector2 = spread(_mm_shuffle_ps(in1, in0, _MM_SHUFFLE(2, 2, 2, 2)));
+		const __m128 vector3 = spread(_mm_shuffle_ps(in1, in0, _MM_SHUFFLE(3, 3, 3, 3)));
+
+		const __m128 inverse0 = _mm_mul_ps(signB, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vector1, factor0), _mm_mul_ps(vector2, factor1)), _mm_mul_ps(vector3, factor2)));
+		const __m128 inverse1 = _mm_mul_ps(signA, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vector0, factor0), _mm_mul_ps(vector2, factor3)), _mm_mul_ps(vector3, factor4)));
+		const __m128 inverse2 = _mm_mul_ps(signB, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vector0, factor1), _mm_mul_ps(vector1, factor3)), _mm_mul_ps(vector3, factor5)));
+		const __m128 inverse3 = _mm_mul_ps(signA, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vector0, factor2), _mm_mul_ps(vector1, factor4)), _mm_mul_ps(vector2, factor5)));
+
+		const __m128 row0 = _mm_shuffle_ps(inverse0, inverse1, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 row1 = _mm_shuffle_ps(inverse2, inverse3, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 firstRow = _mm_shuffle_ps(row0, row1, _MM_SHUFFLE(2, 0, 2, 0));
+
+		alignas(16) PointPrecision products[4];
+		_mm_store_ps(products, _mm_mul_ps(in0, firstRow));
+		det = (products[0] + products[1]) + (products[2] + products[3]);
+
+		TransformMatrix out(MatrixInitialize::NoFill);
+		if (det != 0) {
+			det = 1 / det;
+			const __m128 scale = _mm_set1_ps(det);
+			_mm_storeu_ps(&out[0], _mm_mul_ps(inverse0, scale));
+			_mm_storeu_ps(&out[4], _mm_mul_ps(inverse1, scale));
+			_mm_storeu_ps(&out[8], _mm_mul_ps(inverse2, scale));
+			_mm_storeu_ps(&out[12], _mm_mul_ps(inverse3, scale));
+		}
+		return out;
+#else
 		float A2323 = a_in(2, 2) * a_in(3, 3) - a_in(2, 3) * a_in(3, 2);
 		float A1323 = a_in(2, 1) * a_in(3, 3) - a_in(2, 3) * a_in(3, 1);
 		float A1223 = a_in(2, 1) * a_in(3, 2) - a_in(2, 2) * a_in(3, 1);
@@ -529,6 +691,7 @@ namespace MV {
 			out(3, 3) = det * (a_in(0, 0) * A1212 - a_in(0, 1) * A0212 + a_in(0, 2) * A0112);
 		}
 		return out;
+#endif
 	}
 
 	inline TransformMatrix inverse(const Matrix<4, 4>& a_in) {
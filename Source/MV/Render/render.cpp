@@ -5,6 +5,7 @@
 #include "MV/Utility/generalUtility.h"
 #include "MV/Utility/stringUtility.h"
 #include "MV/Utility/stopwatch.h"
+#include <cstring>
 
 namespace MV {
 	const std::string DEFAULT_ID = "default";
@@ -98,6 +99,99 @@ namespace MV {
 			{ 0.0f, 0.0f }, { renderer.world().size().width, renderer.world().size().height });
 	}
 
+	void ProjectionDetails::projectScreenRaw(Point<>* a_points, size_t a_count, int32_t a_cameraId, const TransformMatrix &a_modelview, const MV::Point<>& a_viewOffset, const MV::Size<>& a_viewSize) {
+		const auto clipTransform = renderer.cameraProjectionMatrix(a_cameraId) * a_modelview;
+		std::array<std::array<PointPrecision, 4>, BatchSize> clipPoints;
+		for (size_t start = 0; start < a_count; start += BatchSize) {
+			const size_t count = std::min(BatchSize, a_count - start);
+			fullMatrixPointMultiply(clipTransform, a_points + start, clipPoints.data(), count);
+			for (size_t i = 0; i < count; ++i) {
+				const auto &v4Result = clipPoints[i];
+				Point<> &point = a_points[start + i];
+				if (MV::equals(v4Result[3], 0.0f)) {
+					MV::error("projectScreen projection failure, point is exactly at the clip pane.");
+					point = Point<>();
+					continue;
+				}
+				const PointPrecision originalZ = point.z;
+				point.x = ((v4Result[0] / v4Result[3]) * .5f + .5f) * a_viewSize.width + a_viewOffset.x;
+				point.y = a_viewSize.height - ((((v4Result[1] / v4Result[3]) * .5f + .5f) * a_viewSize.height) + a_viewOffset.y);
+				point.z = originalZ;
+			}
+		}
+	}
+
+	void ProjectionDetails::unProjectScreenRaw(Point<>* a_points, size_t a_count, int32_t a_cameraId, const TransformMatrix &a_modelview, const MV::Point<>& a_viewOffset, const MV::Size<>& a_viewSize) {
+		float det;
+		const auto conversionMatrix = inverse(renderer.cameraProjectionMatrix(a_cameraId) * a_modelview, det);
+		if (MV::equals(det, 0.0f)) {
+			MV::error("unProjectScreen failure, point is exactly at the clip pane.");
+			std::fill(a_points, a_points + a_count, Point<>());
+			return;
+		}
+		std::array<Point<>, BatchSize> normalizedPoints;
+		std::array<std::array<PointPrecision, 4>, BatchSize> unprojectedPoints;
+		for (size_t start = 0; start < a_count; start += BatchSize) {
+			const size_t count = std::min(BatchSize, a_count - start);
+			for (size_t i = 0; i < count; ++i) {
+				const Point<> &point = a_points[start + i];
+				normalizedPoints[i].x = ((point.x - a_viewOffset.x) / a_viewSize.width) * 2.0f - 1.0f;
+				normalizedPoints[i].y = (((a_viewSize.height - point.y) - a_viewOffset.y) / a_viewSize.height) * 2.0f - 1.0f;
+				normalizedPoints[i].z = point.z * 2.0f - 1.0f;
+			}
+			fullMatrixPointMultiply(conversionMatrix, normalizedPoints.data(), unprojectedPoints.data(), count);
+			for (size_t i = 0; i < count; ++i) {
+				const auto &v4Result = unprojectedPoints[i];
+				Point<> &point = a_points[start + i];
+				if (MV::equals(v4Result[3], 0.0f)) {
+					MV::error("unProjectScreen	failure, point is exactly at the clip pane.");
+					point = Point<>();
+					continue;
+				}
+				//z is left as it was since we're just 2d.
+				point.x = v4Result[0] / v4Result[3];
+				point.y = v4Result[1] / v4Result[3];
+			}
+		}
+	}
+
+	std::vector<Point<int>> ProjectionDetails::projectScreen(const std::vector<Point<>> &a_points, int32_t a_cameraId, const TransformMatrix &a_modelview) {
+		auto projected = a_points;
+		projectScreenRaw(projected.data(), projected.size(), a_cameraId, a_modelview,
+			{ static_cast<PointPrecision>(viewport[0]), static_cast<PointPrecision>(viewport[1]) },
+			{ static_cast<PointPrecision>(viewport[2]), static_cast<PointPrecision>(viewport[3]) });
+		std::vector<Point<int>> results;
+		results.reserve(projected.size());
+		for (auto&& point : projected) {
+			results.push_back(round<int>(point));
+		}
+		return results;
+	}
+
+	std::vector<Point<>> ProjectionDetails::projectWorld(std::vector<Point<>> a_points, int32_t a_cameraId, const TransformMatrix &a_modelview) {
+		projectScreenRaw(a_points.data(), a_points.size(), a_cameraId, a_modelview,
+			{ 0.0f, 0.0f }, { renderer.world().size().width, renderer.world().size().height });
+		return a_points;
+	}
+
+	std::vector<Point<>> ProjectionDetails::unProjectScreen(const std::vector<Point<int>> &a_points, int32_t a_cameraId, const TransformMatrix &a_modelview) {
+		std::vector<Point<>> results;
+		results.reserve(a_points.size());
+		for (auto&& point : a_points) {
+			results.push_back(cast<PointPrecision>(point));
+		}
+		unProjectScreenRaw(results.data(), results.size(), a_cameraId, a_modelview,
+			{ static_cast<PointPrecision>(viewport[0]), static_cast<PointPrecision>(viewport[1]) },
+			{ static_cast<PointPrecision>(viewport[2]), static_cast<PointPrecision>(viewport[3]) });
+		return results;
+	}
+
+	std::vector<Point<>> ProjectionDetails::unProjectWorld(std::vector<Point<>> a_points, int32_t a_cameraId, const TransformMatrix &a_modelview) {
+		unProjectScreenRaw(a_points.data(), a_points.size(), a_cameraId, a_modelview,
+			{ 0.0f, 0.0f }, { renderer.world().size().width, renderer.world().size().height });
+		return a_points;
+	}
+
 	void checkSDLError(int line)
 	{
 		const char *error = SDL_GetError();
@@ -124,22 +218,22 @@ namespace MV {
 	void glExtensionBlendMode::setBlendFunction(GLenum a_sfactorRGB, GLenum a_dfactorRGB, GLenum a_sfactorAlpha, GLenum a_dfactorAlpha){
 		if (!renderer->headless()) {
 			if (initialized) {
-				glBlendFuncSeparate(a_sfactorRGB, a_dfactorRGB, a_sfactorAlpha, a_dfactorAlpha);
+				renderer->renderState().blendFunction(a_sfactorRGB, a_dfactorRGB, a_sfactorAlpha, a_dfactorAlpha);
 			} else {
-				glBlendFunc(a_sfactorRGB, a_dfactorRGB);
+				renderer->renderState().blendFunction(a_sfactorRGB, a_dfactorRGB, a_sfactorRGB, a_dfactorRGB);
 			}
 		}
 	}
 
 	void glExtensionBlendMode::setBlendFunction(GLenum a_sfactorRGB, GLenum a_dfactorRGB){
 		if (!renderer->headless()) {
-			glBlendFunc(a_sfactorRGB, a_dfactorRGB);
+			renderer->renderState().blendFunction(a_sfactorRGB, a_dfactorRGB, a_sfactorRGB, a_dfactorRGB);
 		}
 	}
 
 	void glExtensionBlendMode::setBlendEquation(GLenum a_rgbBlendFunc, GLenum a_alphaBlendFunc){
-		if(initialized){
-			glBlendEquationSeparate(a_rgbBlendFunc, a_alphaBlendFunc);
+		if(initialized && !renderer->headless()){
+			renderer->renderState().blendEquation(a_rgbBlendFunc, a_alphaBlendFunc);
 		}
 	}
 
@@ -171,6 +265,7 @@ namespace MV {
 
 	void glExtensionFramebufferObject::startUsingFramebuffer(std::weak_ptr<Framebuffer> a_framebuffer, bool a_push){
 		require<ResourceException>(renderer->headless() || (initialized && !a_framebuffer.expired()), "StartUsingFramebuffer failed because the extension could not be loaded");
+		renderer->renderQueue().flush();
 
 		savedClearColor = renderer->backgroundColor();
 		auto sharedFramebuffer = a_framebuffer.lock();
@@ -182,7 +277,7 @@ namespace MV {
 		if (!renderer->headless()) {
 //#ifdef WIN32
         
-			glBindFramebuffer(GL_FRAMEBUFFER, sharedFramebuffer->framebuffer);
+			renderer->renderState().framebuffer(sharedFramebuffer->framebuffer);
 			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sharedFramebuffer->texture, 0);
 			glBindRenderbuffer(GL_RENDERBUFFER, sharedFramebuffer->renderbuffer);
 
@@ -223,12 +318,13 @@ namespace MV {
 
 	void glExtensionFramebufferObject::stopUsingFramebuffer(){
 		require<ResourceException>(renderer->headless() || initialized, "StopUsingFramebuffer failed because the extension could not be loaded");
+		renderer->renderQueue().flush();
 		activeFramebuffers.pop_back();
 		if(!activeFramebuffers.empty()){
 			startUsingFramebuffer(activeFramebuffers.back(), false);
 		} else {
 			if (!renderer->headless()) {
-				glBindFramebuffer(GL_FRAMEBUFFER, originalFramebufferId);
+				renderer->renderState().framebuffer(static_cast<GLuint>(originalFramebufferId));
 				glBindRenderbuffer(GL_RENDERBUFFER, originalRenderbufferId);
 
 				renderer->resetViewport();
@@ -581,7 +677,8 @@ namespace MV {
 		initialized(0),
 		sdlRenderer(nullptr),
 		sdlWindow(*this),
-		mvWorld(*this){
+		mvWorld(*this),
+		ourRenderQueue(*this){
 
 		RUNNING_IN_HEADLESS = false;
 	}
@@ -727,6 +824,8 @@ namespace MV {
 		refreshWorldAndWindowSize();
 
 		if (!headless()) {
+			//whatever the context had before is unknown to us.
+			ourRenderState.invalidate();
 			glClearColor(clearBackgroundColor.R, clearBackgroundColor.G, clearBackgroundColor.B, clearBackgroundColor.A);
 
 			glEnable(GL_BLEND);
@@ -776,6 +875,7 @@ namespace MV {
 	}
 
 	void Draw2D::clearScreen(){
+		ourRenderQueue.flush();
 		updateCameraProjectionMatrices();
 		sdlWindow.refreshContext();
 		if (!headless()) {
@@ -784,6 +884,10 @@ namespace MV {
 	}
 
 	void Draw2D::updateScreen(){
+		ourRenderQueue.flush();
+		ourRenderQueue.endFrame();
+		ourRenderState.endFrame();
+		TextureDefinition::endFrame();
 		sdlWindow.updateScreen();
 	}
 
@@ -807,6 +911,26 @@ namespace MV {
 		return projectIt.unProjectScreen(a_worldPoint, a_cameraId, a_modelview);
 	}
 
+	std::vector<Point<>> Draw2D::worldFromLocal(std::vector<Point<>> a_localPoints, int32_t a_cameraId, const TransformMatrix &a_modelview) const {
+		MV::ProjectionDetails projectIt(*this);
+		return projectIt.projectWorld(std::move(a_localPoints), a_cameraId, a_modelview);
+	}
+
+	std::vector<Point<int>> Draw2D::screenFromLocal(const std::vector<Point<>> &a_localPoints, int32_t a_cameraId, const TransformMatrix &a_modelview) const {
+		MV::ProjectionDetails projectIt(*this);
+		return projectIt.projectScreen(a_localPoints, a_cameraId, a_modelview);
+	}
+
+	std::vector<Point<>> Draw2D::localFromWorld(std::vector<Point<>> a_worldPoints, int32_t a_cameraId, const TransformMatrix &a_modelview) const {
+		MV::ProjectionDetails projectIt(*this);
+		return projectIt.unProjectWorld(std::move(a_worldPoints), a_cameraId, a_modelview);
+	}
+
+	std::vector<Point<>> Draw2D::localFromScreen(const std::vector<Point<int>> &a_screenPoints, int32_t a_cameraId, const TransformMatrix &a_modelview) const {
+		MV::ProjectionDetails projectIt(*this);
+		return projectIt.unProjectScreen(a_screenPoints, a_cameraId, a_modelview);
+	}
+
 	Point<> Draw2D::worldFromScreenRaw(const Point<> &a_screenPoint) const {
 		PointPrecision widthRatio = window().drawableSize().width / world().size().width;
 		PointPrecision heightRatio = window().drawableSize().height / world().size().height;
@@ -892,7 +1016,7 @@ namespace MV {
 		bool makeDefault = shaders.empty();
 		auto programId = loadShaderGetProgramId(a_vertexShaderCode, a_fragmentShaderCode);
 
-		auto emplaceResult = shaders.emplace(std::make_pair(a_id, Shader(a_id, programId, headless())));
+		auto emplaceResult = shaders.emplace(std::make_pair(a_id, Shader(a_id, programId, headless(), ourRenderState)));
 		MV::require<ResourceException>(emplaceResult.second, "Failed to insert shader to map: ", a_id);
 		Shader* shaderPtr = &emplaceResult.first->second;
 
@@ -923,6 +1047,7 @@ namespace MV {
 					std::cerr << "Failed to reload shader: " << e.what() << std::endl;
 				}
 			}
+			ourRenderState.invalidate();
 		}
 	}
 
@@ -979,7 +1104,7 @@ namespace MV {
                 e.append("ShaderID: " + a_id);
                 throw;
             }
-            auto emplaceResult = shaders.emplace(std::make_pair(a_id, Shader(a_id, programId, headless(), a_vertexShaderFilename, a_fragmentShaderFilename)));
+            auto emplaceResult = shaders.emplace(std::make_pair(a_id, Shader(a_id, programId, headless(), ourRenderState, a_vertexShaderFilename, a_fragmentShaderFilename)));
             MV::require<ResourceException>(emplaceResult.second, "Failed to insert shader to map: ", a_id);
             Shader* shaderPtr = &emplaceResult.first->second;
                 
@@ -1113,6 +1238,358 @@ namespace MV {
 		renderer->stopUsingFramebuffer();
 	}
 
+	RenderState* RenderState::active = nullptr;
+
+	RenderState::RenderState() {
+		invalidate();
+		active = this;
+	}
+
+	RenderState::~RenderState() {
+		if (active == this) {
+			active = nullptr;
+		}
+	}
+
+	bool RenderState::changed(GLuint &a_current, GLuint a_requested) {
+		if (a_current == a_requested) {
+			++currentFrame.redundant;
+			return false;
+		}
+		a_current = a_requested;
+		++currentFrame.issued;
+		return true;
+	}
+
+	void RenderState::program(GLuint a_program) {
+		if (changed(currentProgram, a_program)) {
+			glUseProgram(a_program);
+		}
+	}
+
+	void RenderState::activeTexture(GLuint a_unit) {
+		if (changed(currentActiveTexture, a_unit)) {
+			glActiveTexture(GL_TEXTURE0 + a_unit);
+		}
+	}
+
+	void RenderState::texture(GLuint a_unit, GLuint a_texture) {
+		if (a_unit >= MaxTextureUnits) {
+			activeTexture(a_unit);
+			glBindTexture(GL_TEXTURE_2D, a_texture);
+			++currentFrame.issued;
+		} else if (currentTextures[a_unit] == a_texture) {
+			++currentFrame.redundant;
+		} else {
+			activeTexture(a_unit);
+			changed(currentTextures[a_unit], a_texture);
+			glBindTexture(GL_TEXTURE_2D, a_texture);
+		}
+	}
+
+	void RenderState::blendFunction(GLenum a_sourceRGB, GLenum a_destinationRGB, GLenum a_sourceAlpha, GLenum a_destinationAlpha) {
+		if (currentBlendFunction[0] == a_sourceRGB && currentBlendFunction[1] == a_destinationRGB && currentBlendFunction[2] == a_sourceAlpha && currentBlendFunction[3] == a_destinationAlpha) {
+			++currentFrame.redundant;
+			return;
+		}
+		currentBlendFunction[0] = a_sourceRGB; currentBlendFunction[1] = a_destinationRGB;
+		currentBlendFunction[2] = a_sourceAlpha; currentBlendFunction[3] = a_destinationAlpha;
+		++currentFrame.issued;
+		if (a_sourceRGB == a_sourceAlpha && a_destinationRGB == a_destinationAlpha) {
+			glBlendFunc(a_sourceRGB, a_destinationRGB);
+		} else {
+			glBlendFuncSeparate(a_sourceRGB, a_destinationRGB, a_sourceAlpha, a_destinationAlpha);
+		}
+	}
+
+	void RenderState::blendEquation(GLenum a_rgbBlendFunc, GLenum a_alphaBlendFunc) {
+		if (currentBlendEquation[0] == a_rgbBlendFunc && currentBlendEquation[1] == a_alphaBlendFunc) {
+			++currentFrame.redundant;
+			return;
+		}
+		currentBlendEquation[0] = a_rgbBlendFunc;
+		currentBlendEquation[1] = a_alphaBlendFunc;
+		++currentFrame.issued;
+		glBlendEquationSeparate(a_rgbBlendFunc, a_alphaBlendFunc);
+	}
+
+	void RenderState::vertexArray(GLuint a_vertexArray) {
+		if (changed(currentVertexArray, a_vertexArray)) {
+			glBindVertexArrayDefault(a_vertexArray);
+		}
+	}
+
+	void RenderState::framebuffer(GLuint a_framebuffer) {
+		if (changed(currentFramebuffer, a_framebuffer)) {
+			glBindFramebuffer(GL_FRAMEBUFFER, a_framebuffer);
+		}
+	}
+
+	void RenderState::invalidate() {
+		currentProgram = currentActiveTexture = currentVertexArray = currentFramebuffer = Unknown;
+		std::fill(std::begin(currentTextures), std::end(currentTextures), Unknown);
+		std::fill(std::begin(currentBlendFunction), std::end(currentBlendFunction), Unknown);
+		std::fill(std::begin(currentBlendEquation), std::end(currentBlendEquation), Unknown);
+	}
+
+	void RenderState::endFrame() {
+		lastFrame = currentFrame;
+		currentFrame = Statistics();
+	}
+
+	void RenderState::textureBound(GLuint a_texture) {
+		if (active && active->currentActiveTexture < MaxTextureUnits) {
+			active->currentTextures[active->currentActiveTexture] = a_texture;
+		} else if (active) {
+			std::fill(std::begin(active->currentTextures), std::end(active->currentTextures), Unknown);
+		}
+	}
+
+	void RenderState::textureDeleted(GLuint a_texture) {
+		if (active) {
+			//GL falls back to texture 0 on every unit the deleted name was bound to.
+			std::replace(std::begin(active->currentTextures), std::end(active->currentTextures), a_texture, static_cast<GLuint>(0));
+		}
+	}
+
+	void RenderState::vertexArrayDeleted(GLuint a_vertexArray) {
+		if (active && active->currentVertexArray == a_vertexArray) {
+			active->currentVertexArray = 0;
+		}
+	}
+
+	DrawBuffer::~DrawBuffer() {
+		release();
+	}
+
+	void DrawBuffer::release() {
+		if (vertexArrayId != 0) {
+			RenderState::vertexArrayDeleted(vertexArrayId);
+			glDeleteVertexArraysDefault(1, &vertexArrayId);
+			glDeleteBuffers(1, &vertexBufferId);
+			glDeleteBuffers(1, &indexBufferId);
+			vertexArrayId = vertexBufferId = indexBufferId = 0;
+			vertexCapacity = indexCapacity = 0;
+			vertexWrittenEnd = indexWrittenEnd = 0;
+		}
+	}
+
+	void DrawBuffer::initialize(RenderState &a_state) {
+		if (vertexArrayId == 0) {
+			glGenVertexArraysDefault(1, &vertexArrayId);
+			glGenBuffers(1, &vertexBufferId);
+			glGenBuffers(1, &indexBufferId);
+
+			a_state.vertexArray(vertexArrayId);
+			glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
+
+			glEnableVertexAttribArray(0);
+			glEnableVertexAttribArray(1);
+			glEnableVertexAttribArray(2);
+
+			auto structSize = static_cast<GLsizei>(sizeof(DrawPoint));
+			auto positionOffset = static_cast<size_t>(offsetof(DrawPoint, x));
+			auto textureOffset = static_cast<size_t>(offsetof(DrawPoint, textureX));
+			auto colorOffset = static_cast<size_t>(offsetof(DrawPoint, R));
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)positionOffset); //Point
+			glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)textureOffset); //UV
+			glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, structSize, (GLvoid*)colorOffset); //Color
+		}
+	}
+
+	template <typename T>
+	void DrawBuffer::upload(RenderState &a_state, GLenum a_target, GLuint a_bufferId, size_t &a_capacity, size_t &a_writtenEnd, const std::vector<T> &a_values, size_t a_begin, size_t a_end) {
+		initialize(a_state);
+		a_state.vertexArray(vertexArrayId);
+		glBindBuffer(a_target, a_bufferId);
+		auto usage = isStreaming ? GL_STREAM_DRAW : GL_STATIC_DRAW;
+		if (a_values.size() > a_capacity) {
+			//streaming buffers tend to grow (particles, skeletons), leave room so we don't reallocate every frame.
+			a_capacity = isStreaming ? a_values.size() + a_values.size() / 2 : a_values.size();
+			glBufferData(a_target, a_capacity * sizeof(T), nullptr, usage);
+			a_begin = 0;
+			a_end = a_values.size();
+			a_writtenEnd = 0;
+		} else if (isStreaming && a_begin == 0) {
+			//orphan, the driver hands back fresh storage rather than syncing with draws that still read the old contents.
+			glBufferData(a_target, a_capacity * sizeof(T), nullptr, usage);
+			a_writtenEnd = 0;
+		}
+		if (a_end > a_begin) {
+#ifndef HAVE_OPENGLES
+			if (isStreaming && a_begin > 0 && a_begin >= a_writtenEnd) {
+				//appending past everything written since the orphan, nothing in flight can be reading this range.
+				if (void* mapped = glMapBufferRange(a_target, a_begin * sizeof(T), (a_end - a_begin) * sizeof(T), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT)) {
+					std::memcpy(mapped, &a_values[a_begin], (a_end - a_begin) * sizeof(T));
+					glUnmapBuffer(a_target);
+					a_writtenEnd = a_end;
+					uploadedSinceDraw = true;
+					return;
+				}
+			}
+#endif
+			glBufferSubData(a_target, a_begin * sizeof(T), (a_end - a_begin) * sizeof(T), &a_values[a_begin]);
+			a_writtenEnd = std::max(a_writtenEnd, a_end);
+		}
+		uploadedSinceDraw = true;
+	}
+
+	void DrawBuffer::points(RenderState &a_state, const std::vector<DrawPoint> &a_points, size_t a_begin, size_t a_end) {
+		upload(a_state, GL_ARRAY_BUFFER, vertexBufferId, vertexCapacity, vertexWrittenEnd, a_points, a_begin, a_end);
+	}
+
+	void DrawBuffer::indices(RenderState &a_state, const std::vector<GLuint> &a_indices, size_t a_begin, size_t a_end) {
+		upload(a_state, GL_ELEMENT_ARRAY_BUFFER, indexBufferId, indexCapacity, indexWrittenEnd, a_indices, a_begin, a_end);
+	}
+
+	void DrawBuffer::bind(RenderState &a_state) {
+		initialize(a_state);
+		a_state.vertexArray(vertexArrayId);
+	}
+
+	void DrawBuffer::draw(GLenum a_drawType, size_t a_indexCount, size_t a_firstIndex) {
+		glDrawElements(a_drawType, static_cast<GLsizei>(a_indexCount), GL_UNSIGNED_INT, (GLvoid*)(a_firstIndex * sizeof(GLuint)));
+		drawsWithUploads = uploadedSinceDraw ? drawsWithUploads + 1 : 0;
+		isStreaming = drawsWithUploads >= StreamAfterDraws;
+		uploadedSinceDraw = false;
+	}
+
+	RenderQueue& RenderQueue::enabled(bool a_enabled) {
+		if (!a_enabled) {
+			flush();
+		}
+		isEnabled = a_enabled;
+		return *this;
+	}
+
+	void RenderQueue::push(const State &a_state, const TransformMatrix &a_worldTransform, const std::vector<DrawPoint> &a_points, const std::vector<GLuint> &a_indices) {
+		if (a_points.empty() || a_indices.empty()) {
+			return;
+		}
+		//World bounds from the 8 transformed corners of the local bounds, conservative under rotation which is all the overlap test needs.
+		Point<> localMinimum = a_points[0].point(), localMaximum = a_points[0].point();
+		for (auto&& point : a_points) {
+			localMinimum.x = std::min(localMinimum.x, point.x); localMinimum.y = std::min(localMinimum.y, point.y); localMinimum.z = std::min(localMinimum.z, point.z);
+			localMaximum.x = std::max(localMaximum.x, point.x); localMaximum.y = std::max(localMaximum.y, point.y); localMaximum.z = std::max(localMaximum.z, point.z);
+		}
+		Point<> minimum, maximum;
+		for (int corner = 0; corner < 8; ++corner) {
+			auto transformed = a_worldTransform * Point<>(
+				(corner & 1) ? localMaximum.x : localMinimum.x,
+				(corner & 2) ? localMaximum.y : localMinimum.y,
+				(corner & 4) ? localMaximum.z : localMinimum.z);
+			if (corner == 0) {
+				minimum = maximum = transformed;
+			} else {
+				minimum.x = std::min(minimum.x, transformed.x); minimum.y = std::min(minimum.y, transformed.y);
+				maximum.x = std::max(maximum.x, transformed.x); maximum.y = std::max(maximum.y, transformed.y);
+			}
+		}
+
+		//Walk back over recent batches, we can join a matching one as long as nothing drawn after it overlaps us.
+		Batch* target = nullptr;
+		size_t searchEnd = activeBatches > MergeLookBehind ? activeBatches - MergeLookBehind : 0;
+		for (size_t i = activeBatches; i-- > searchEnd;) {
+			if (batches[i].state == a_state) {
+				target = &batches[i];
+				break;
+			} else if (batches[i].overlaps(a_state.cameraId, minimum, maximum)) {
+				break;
+			}
+		}
+
+		if (!target) {
+			if (activeBatches == batches.size()) {
+				batches.emplace_back();
+			}
+			target = &batches[activeBatches++];
+			target->state = a_state;
+			target->points.clear();
+			target->indices.clear();
+			target->minimum = minimum;
+			target->maximum = maximum;
+		} else {
+			target->minimum.x = std::min(minimum.x, target->minimum.x); target->minimum.y = std::min(minimum.y, target->minimum.y);
+			target->maximum.x = std::max(maximum.x, target->maximum.x); target->maximum.y = std::max(maximum.y, target->maximum.y);
+		}
+
+		auto indexOffset = static_cast<GLuint>(target->points.size());
+		target->points.resize(target->points.size() + a_points.size());
+		transformPoints(a_worldTransform, &a_points[0], &target->points[indexOffset], a_points.size());
+		for (auto&& index : a_indices) {
+			target->indices.push_back(index + indexOffset);
+		}
+
+		++currentFrame.commands;
+		currentFrame.vertices += a_points.size();
+	}
+
+	void RenderQueue::flush() {
+		if (activeBatches == 0) {
+			return;
+		}
+		currentFrame.batches += activeBatches;
+		if (!renderer.headless()) {
+			uploadPoints.clear();
+			uploadIndices.clear();
+			for (size_t i = 0; i < activeBatches; ++i) {
+				auto indexOffset = static_cast<GLuint>(uploadPoints.size());
+				uploadPoints.insert(uploadPoints.end(), batches[i].points.begin(), batches[i].points.end());
+				for (auto&& index : batches[i].indices) {
+					uploadIndices.push_back(index + indexOffset);
+				}
+			}
+
+			auto& state = renderer.renderState();
+			buffer.points(state, uploadPoints);
+			buffer.indices(state, uploadIndices);
+			buffer.bind(state);
+
+			Shader* activeShader = nullptr;
+			//a program keeps its uniforms, so each shader needs the projection for a camera once per flush.
+			shaderCameras.clear();
+			size_t indexStart = 0;
+			for (size_t i = 0; i < activeBatches; ++i) {
+				auto& batch = batches[i];
+				if (batch.state.shader != activeShader) {
+					activeShader = batch.state.shader;
+					activeShader->use();
+				}
+				if (batch.state.defaultBlend) {
+					renderer.defaultBlendFunction();
+				} else {
+					renderer.setBlendFunction(batch.state.blendSource, batch.state.blendDestination);
+				}
+				for (size_t textureIndex = 0; textureIndex < batch.state.textures.size(); ++textureIndex) {
+					activeShader->set(ShaderUniform::texture(textureIndex), batch.state.textures[textureIndex], static_cast<GLuint>(textureIndex), textureIndex == 0);
+				}
+				auto shaderCamera = std::find_if(shaderCameras.begin(), shaderCameras.end(), [&](const std::pair<Shader*, int32_t> &a_item) { return a_item.first == activeShader; });
+				if (shaderCamera == shaderCameras.end() || shaderCamera->second != batch.state.cameraId) {
+					activeShader->set(Uniforms::transformation, renderer.cameraProjectionMatrix(batch.state.cameraId));
+					++currentFrame.transformUploads;
+					if (shaderCamera == shaderCameras.end()) {
+						shaderCameras.emplace_back(activeShader, batch.state.cameraId);
+					} else {
+						shaderCamera->second = batch.state.cameraId;
+					}
+				}
+
+				buffer.draw(GL_TRIANGLES, batch.indices.size(), indexStart);
+				indexStart += batch.indices.size();
+			}
+		}
+		for (size_t i = 0; i < activeBatches; ++i) {
+			batches[i].state.textures.clear();
+		}
+		activeBatches = 0;
+	}
+
+	void RenderQueue::endFrame() {
+		lastFrame = currentFrame;
+		currentFrame = Statistics();
+	}
+
 	glExtensions::glExtensions(Draw2D *a_renderer) :
 		renderer(a_renderer),
 		glExtensionBlendMode(a_renderer),
@@ -1136,61 +1613,112 @@ namespace MV {
 		return SharedTextures::white()->texture()->textureId();
 	}
 
-	bool Shader::set(const std::string &a_variableName, GLuint a_texture, GLuint a_textureBindIndex, bool a_errorIfNotPresent /*= true*/) {
-		if (!headless) {
-			GLuint offset = variableOffset(a_variableName);
-			if (offset >= 0) {
-				auto textureId = (a_texture != 0) ?
-					a_texture :
-					getDefaultTextureId();
-
-				glActiveTexture(GL_TEXTURE0 + a_textureBindIndex);
-				glUniform1i(offset, a_textureBindIndex);
-				glBindTexture(GL_TEXTURE_2D, textureId);
-				return true;
-			} else if (a_errorIfNotPresent) {
-				std::cerr << "Warning: Shader has no variable: " << a_variableName << std::endl;
-			}
+	namespace {
+		struct UniformRegistry {
+			std::unordered_map<std::string, size_t> ids;
+			std::vector<std::string> names;
+			std::vector<ShaderUniform> textures;
+		};
+		//function local so uniforms interned during static initialization find it constructed.
+		UniformRegistry& uniformRegistry() {
+			static UniformRegistry registry;
+			return registry;
 		}
-		return false;
 	}
 
-	bool Shader::set(const std::string &a_variableName, const std::shared_ptr<TextureDefinition> &a_texture, GLuint a_textureBindIndex, bool a_errorIfNotPresent /*= true*/) {
+	ShaderUniform::ShaderUniform(const std::string &a_name) {
+		auto& registry = uniformRegistry();
+		auto found = registry.ids.find(a_name);
+		if (found != registry.ids.end()) {
+			index = found->second;
+		} else {
+			index = registry.names.size();
+			registry.names.push_back(a_name);
+			registry.ids.emplace(a_name, index);
+		}
+	}
+
+	const std::string& ShaderUniform::name() const {
+		return uniformRegistry().names[index];
+	}
+
+	const ShaderUniform& ShaderUniform::texture(size_t a_index) {
+		auto& textures = uniformRegistry().textures;
+		while (textures.size() <= a_index) {
+			textures.push_back(ShaderUniform("texture" + std::to_string(textures.size())));
+		}
+		return textures[a_index];
+	}
+
+	namespace Uniforms {
+		const ShaderUniform time("time");
+		const ShaderUniform alpha("alpha");
+		const ShaderUniform uvMin("uvMin");
+		const ShaderUniform uvMax("uvMax");
+		const ShaderUniform transformation("transformation");
+	}
+
+	bool Shader::setValues(const ShaderUniform &a_uniform, const GLfloat *a_values, size_t a_count, bool a_errorIfNotPresent) {
 		if (!headless) {
-			GLuint offset = variableOffset(a_variableName);
-			if (offset >= 0) {
-				auto textureId = (a_texture != nullptr) ?
-					a_texture->textureId() :
-					getDefaultTextureId();
-
-				glActiveTexture(GL_TEXTURE0 + a_textureBindIndex);
-				glUniform1i(offset, a_textureBindIndex);
-				glBindTexture(GL_TEXTURE_2D, textureId);
+			auto& cached = uniform(a_uniform);
+			if (cached.location >= 0) {
+				//the program keeps its uniforms between draws, only upload what changed.
+				if (cached.count != a_count || std::memcmp(cached.values, a_values, a_count * sizeof(GLfloat)) != 0) {
+					cached.count = a_count;
+					std::memcpy(cached.values, a_values, a_count * sizeof(GLfloat));
+					state->program(programId);
+					if (a_count == 1) {
+						glUniform1fv(cached.location, 1, a_values);
+					} else if (a_count == 2) {
+						glUniform2fv(cached.location, 1, a_values);
+					} else if (a_count == 3) {
+						glUniform3fv(cached.location, 1, a_values);
+					} else {
+						glUniformMatrix4fv(cached.location, 1, GL_FALSE, a_values);
+					}
+				}
 				return true;
 			} else if (a_errorIfNotPresent) {
-				std::cerr << "Warning: Shader has no variable: " << a_variableName << std::endl;
+				std::cerr << "Warning: Shader has no variable: " << a_uniform.name() << std::endl;
 			}
 		}
 		return false;
 	}
 
-	bool Shader::set(const std::string &a_variableName, const std::shared_ptr<TextureHandle> &a_value, GLuint a_textureBindIndex, bool a_errorIfNotPresent /*= true*/) {
+	bool Shader::setSampler(const ShaderUniform &a_uniform, GLuint a_texture, GLuint a_textureBindIndex, bool a_errorIfNotPresent) {
 		if (!headless) {
-			GLuint offset = variableOffset(a_variableName);
-			if (offset >= 0) {
-				auto textureId = (a_value != nullptr && a_value->texture() != nullptr) ?
-					a_value->texture()->textureId() :
-					getDefaultTextureId();
-
-				glActiveTexture(GL_TEXTURE0 + a_textureBindIndex);
-				glUniform1i(offset, a_textureBindIndex);
-				glBindTexture(GL_TEXTURE_2D, textureId);
+			auto& cached = uniform(a_uniform);
+			if (cached.location >= 0) {
+				if (cached.sampler != static_cast<GLint>(a_textureBindIndex)) {
+					cached.sampler = static_cast<GLint>(a_textureBindIndex);
+					state->program(programId);
+					glUniform1i(cached.location, cached.sampler);
+				}
+				state->texture(a_textureBindIndex, (a_texture != 0) ? a_texture : getDefaultTextureId());
 				return true;
 			} else if (a_errorIfNotPresent) {
-				std::cerr << "Warning: Shader has no variable: " << a_variableName << std::endl;
+				std::cerr << "Warning: Shader has no variable: " << a_uniform.name() << std::endl;
 			}
 		}
 		return false;
 	}
 
+	bool Shader::set(const ShaderUniform &a_uniform, GLuint a_texture, GLuint a_textureBindIndex, bool a_errorIfNotPresent /*= true*/) {
+		return setSampler(a_uniform, a_texture, a_textureBindIndex, a_errorIfNotPresent);
+	}
+
+	bool Shader::set(const ShaderUniform &a_uniform, const std::shared_ptr<TextureDefinition> &a_texture, GLuint a_textureBindIndex, bool a_errorIfNotPresent /*= true*/) {
+		if (a_texture) {
+			a_texture->drawn();
+		}
+		return setSampler(a_uniform, a_texture != nullptr ? a_texture->textureId() : 0, a_textureBindIndex, a_errorIfNotPresent);
+	}
+
+	bool Shader::set(const ShaderUniform &a_uniform, const std::shared_ptr<TextureHandle> &a_value, GLuint a_textureBindIndex, bool a_errorIfNotPresent /*= true*/) {
+		if (a_value && a_value->texture()) {
+			a_value->texture()->drawn();
+		}
+		return setSampler(a_uniform, (a_value != nullptr && a_value->texture() != nullptr) ? a_value->texture()->textureId() : 0, a_textureBindIndex, a_errorIfNotPresent);
+	}
+
 }
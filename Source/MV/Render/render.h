@@ -69,6 +69,17 @@
 	#define GL_DEPTH_COMPONENT_DEFAULT GL_DEPTH_COMPONENT16
 #endif
 
+#ifdef HAVE_OPENGLES
+	//ES2 headers only expose vertex array objects through OES_vertex_array_object.
+	#define glGenVertexArraysDefault glGenVertexArraysOES
+	#define glBindVertexArrayDefault glBindVertexArrayOES
+	#define glDeleteVertexArraysDefault glDeleteVertexArraysOES
+#else
+	#define glGenVertexArraysDefault glGenVertexArrays
+	#define glBindVertexArrayDefault glBindVertexArray
+	#define glDeleteVertexArraysDefault glDeleteVertexArrays
+#endif
+
 #include <string>
 #include <iostream>
 
@@ -213,10 +224,21 @@ namespace MV {
 		Point<> unProjectScreen(const Point<int> &a_point, int32_t a_cameraId, const TransformMatrix &a_modelview);
 		Point<> unProjectWorld(const Point<> &a_point, int32_t a_cameraId, const TransformMatrix &a_modelview);
 
+		//batched forms combine the camera and modelview (and invert it when unprojecting) once for every point.
+		std::vector<Point<int>> projectScreen(const std::vector<Point<>> &a_points, int32_t a_cameraId, const TransformMatrix &a_modelview);
+		std::vector<Point<>> projectWorld(std::vector<Point<>> a_points, int32_t a_cameraId, const TransformMatrix &a_modelview);
+		std::vector<Point<>> unProjectScreen(const std::vector<Point<int>> &a_points, int32_t a_cameraId, const TransformMatrix &a_modelview);
+		std::vector<Point<>> unProjectWorld(std::vector<Point<>> a_points, int32_t a_cameraId, const TransformMatrix &a_modelview);
+
 		const Draw2D &renderer;
 	private:
+		//points transformed per fullMatrixPointMultiply call, sized to keep the homogeneous results on the stack.
+		static constexpr size_t BatchSize = 64;
+
 		inline Point<> projectScreenRaw(const Point<> &a_point, int32_t a_cameraId, const TransformMatrix &a_modelview, const MV::Point<> &a_viewOffset, const MV::Size<> &a_viewSize);
 		inline Point<> unProjectScreenRaw(const Point<> &a_point, int32_t a_cameraId, const TransformMatrix &a_modelview, const MV::Point<>& a_viewOffset, const MV::Size<>& a_viewSize);
+		void projectScreenRaw(Point<>* a_points, size_t a_count, int32_t a_cameraId, const TransformMatrix &a_modelview, const MV::Point<> &a_viewOffset, const MV::Size<> &a_viewSize);
+		void unProjectScreenRaw(Point<>* a_points, size_t a_count, int32_t a_cameraId, const TransformMatrix &a_modelview, const MV::Point<>& a_viewOffset, const MV::Size<>& a_viewSize);
 	};
 
 	class RenderWorld {
@@ -292,15 +314,101 @@ namespace MV {
 		Draw2D &renderer;
 	};
 
+	//Shadows the GL state changed per draw so redundant changes never reach the driver.
+	//Enabled vertex attributes are recorded in each DrawBuffer's vertex array, so tracking that binding covers them.
+	//Code binding GL state behind our back must tell us (textureBound/textureDeleted) or call invalidate().
+	class RenderState {
+	public:
+		struct Statistics {
+			size_t issued = 0;
+			size_t redundant = 0;
+		};
+
+		static const GLuint MaxTextureUnits = 16;
+
+		RenderState();
+		~RenderState();
+		RenderState(const RenderState &) = delete;
+		RenderState& operator=(const RenderState &) = delete;
+
+		void program(GLuint a_program);
+		void texture(GLuint a_unit, GLuint a_texture);
+		void blendFunction(GLenum a_sourceRGB, GLenum a_destinationRGB, GLenum a_sourceAlpha, GLenum a_destinationAlpha);
+		void blendEquation(GLenum a_rgbBlendFunc, GLenum a_alphaBlendFunc);
+		void vertexArray(GLuint a_vertexArray);
+		void framebuffer(GLuint a_framebuffer);
+
+		//forget everything, the next request for each piece of state is issued.
+		void invalidate();
+
+		//rolls the running totals over into statistics(), Draw2D::updateScreen calls this.
+		void endFrame();
+
+		const Statistics& statistics() const {
+			return lastFrame;
+		}
+
+		//texture loading binds to whatever unit is active and deleted names get reused, both have to reach the cache.
+		static void textureBound(GLuint a_texture);
+		static void textureDeleted(GLuint a_texture);
+		static void vertexArrayDeleted(GLuint a_vertexArray);
+	private:
+		static const GLuint Unknown = static_cast<GLuint>(-1);
+
+		bool changed(GLuint &a_current, GLuint a_requested);
+		void activeTexture(GLuint a_unit);
+
+		GLuint currentProgram = Unknown;
+		GLuint currentActiveTexture = Unknown;
+		GLuint currentTextures[MaxTextureUnits];
+		GLuint currentBlendFunction[4];
+		GLuint currentBlendEquation[2];
+		GLuint currentVertexArray = Unknown;
+		GLuint currentFramebuffer = Unknown;
+
+		Statistics currentFrame;
+		Statistics lastFrame;
+
+		//there is one GL context, this is the cache tracking it.
+		static RenderState* active;
+	};
+
+	//An interned uniform name. Resolve it once and hand it to Shader::set so the draw loop never hashes strings,
+	//each Shader maps the id to its own location and skips uploads of unchanged values.
+	class ShaderUniform {
+	public:
+		explicit ShaderUniform(const std::string &a_name);
+
+		size_t id() const {
+			return index;
+		}
+		const std::string& name() const;
+
+		//"texture0", "texture1"... by bind index.
+		static const ShaderUniform& texture(size_t a_index);
+	private:
+		size_t index;
+	};
+
+	//uniforms the engine itself sets on every draw.
+	namespace Uniforms {
+		extern const ShaderUniform time;
+		extern const ShaderUniform alpha;
+		extern const ShaderUniform uvMin;
+		extern const ShaderUniform uvMax;
+		extern const ShaderUniform transformation;
+	}
+
 	class TextureDefinition;
 	class TextureHandle;
 	class Shader {
 		friend Draw2D;
 	public:
-		Shader(const std::string &a_stringId, GLuint a_id, bool a_headless, const std::string &a_vertexFile = "", const std::string &a_fragmentFile = "") :
+		Shader(const std::string &a_stringId, GLuint a_id, bool a_headless, RenderState &a_state, const std::string &a_vertexFile = "", const std::string &a_fragmentFile = "") :
 			stringId(a_stringId),
 			programId(a_id),
 			headless(a_headless),
+			state(&a_state),
 			vertexShaderFile(a_vertexFile),
 			fragmentShaderFile(a_fragmentFile){
 
@@ -313,73 +421,68 @@ namespace MV {
 
 		inline void use(){
 			if (!headless) {
-				glUseProgram(programId);
+				state->program(programId);
 			}
 		}
 
-		bool set(const std::string &a_variableName, GLuint a_texture, GLuint a_textureBindIndex = 0, bool a_errorIfNotPresent = true);
-		bool set(const std::string &a_variableName, const std::shared_ptr<TextureDefinition> &a_texture, GLuint a_textureBindIndex, bool a_errorIfNotPresent = true);
-		bool set(const std::string &a_variableName, const std::shared_ptr<TextureHandle> &a_value, GLuint a_textureBindIndex, bool a_errorIfNotPresent = true);
+		bool set(const ShaderUniform &a_uniform, GLuint a_texture, GLuint a_textureBindIndex = 0, bool a_errorIfNotPresent = true);
+		bool set(const ShaderUniform &a_uniform, const std::shared_ptr<TextureDefinition> &a_texture, GLuint a_textureBindIndex, bool a_errorIfNotPresent = true);
+		bool set(const ShaderUniform &a_uniform, const std::shared_ptr<TextureHandle> &a_value, GLuint a_textureBindIndex, bool a_errorIfNotPresent = true);
 
-		inline bool set(std::string a_variableName, PointPrecision a_value, bool a_errorIfNotPresent = true) {
-			if (!headless) {
-				GLint offset = variableOffset(a_variableName);
-				if (offset >= 0) {
-					glUniform1fv(offset, 1, &a_value);
-					return true;
-				} else if (a_errorIfNotPresent) {
-					std::cerr << "Warning: Shader has no variable: " << a_variableName << std::endl;
-				}
-			}
-			return false;
+		inline bool set(const ShaderUniform &a_uniform, PointPrecision a_value, bool a_errorIfNotPresent = true) {
+			return setValues(a_uniform, &a_value, 1, a_errorIfNotPresent);
+		}
+		inline bool setVec2(const ShaderUniform &a_uniform, const Point<PointPrecision> &a_point, bool a_errorIfNotPresent = true) {
+			return setValues(a_uniform, &a_point.x, 2, a_errorIfNotPresent);
+		}
+		inline bool setVec3(const ShaderUniform &a_uniform, const Point<PointPrecision> &a_point, bool a_errorIfNotPresent = true) {
+			return setValues(a_uniform, &a_point.x, 3, a_errorIfNotPresent);
+		}
+		inline bool set(const ShaderUniform &a_uniform, const TransformMatrix &a_matrix, bool a_errorIfNotPresent = true) {
+			return setValues(a_uniform, &((a_matrix.getMatrixArray())[0]), 16, a_errorIfNotPresent);
 		}
 
+		//string versions intern the name on every call, prefer holding on to a ShaderUniform in anything called per draw.
+		inline bool set(const std::string &a_variableName, GLuint a_texture, GLuint a_textureBindIndex = 0, bool a_errorIfNotPresent = true) {
+			return set(ShaderUniform(a_variableName), a_texture, a_textureBindIndex, a_errorIfNotPresent);
+		}
+		inline bool set(const std::string &a_variableName, const std::shared_ptr<TextureDefinition> &a_texture, GLuint a_textureBindIndex, bool a_errorIfNotPresent = true) {
+			return set(ShaderUniform(a_variableName), a_texture, a_textureBindIndex, a_errorIfNotPresent);
+		}
+		inline bool set(const std::string &a_variableName, const std::shared_ptr<TextureHandle> &a_value, GLuint a_textureBindIndex, bool a_errorIfNotPresent = true) {
+			return set(ShaderUniform(a_variableName), a_value, a_textureBindIndex, a_errorIfNotPresent);
+		}
+		inline bool set(const std::string &a_variableName, PointPrecision a_value, bool a_errorIfNotPresent = true) {
+			return set(ShaderUniform(a_variableName), a_value, a_errorIfNotPresent);
+		}
 		inline bool setVec2(const std::string &a_variableName, const Point<PointPrecision> &a_point, bool a_errorIfNotPresent = true) {
-			if (!headless) {
-				GLint offset = variableOffset(a_variableName);
-				if (offset >= 0) {
-					glUniform2fv(offset, 1, &a_point.x);
-					return true;
-				} else if (a_errorIfNotPresent) {
-					std::cerr << "Warning: Shader has no variable: " << a_variableName << std::endl;
-				}
-			}
-			return false;
+			return setVec2(ShaderUniform(a_variableName), a_point, a_errorIfNotPresent);
 		}
 		inline bool setVec3(const std::string &a_variableName, const Point<PointPrecision> &a_point, bool a_errorIfNotPresent = true) {
-			if (!headless) {
-				GLint offset = variableOffset(a_variableName);
-				if (offset >= 0) {
-					glUniform3fv(offset, 1, &a_point.x);
-					return true;
-				} else if (a_errorIfNotPresent) {
-					std::cerr << "Warning: Shader has no variable: " << a_variableName << std::endl;
-				}
-			}
-			return false;
+			return setVec3(ShaderUniform(a_variableName), a_point, a_errorIfNotPresent);
 		}
-
 		inline bool set(const std::string &a_variableName, const TransformMatrix &a_matrix, bool a_errorIfNotPresent = true) {
-			if (!headless) {
-				GLint offset = variableOffset(a_variableName);
-				if (offset >= 0) {
-					const GLfloat *mat = &((a_matrix.getMatrixArray())[0]);
-					glUniformMatrix4fv(offset, 1, GL_FALSE, mat);
-					return true;
-				} else if (a_errorIfNotPresent) {
-					std::cerr << "Warning: Shader has no variable: " << a_variableName << std::endl;
-				}
-			}
-			return false;
+			return set(ShaderUniform(a_variableName), a_matrix, a_errorIfNotPresent);
 		}
 
-		inline bool has(std::string a_variableName) {
-			return variableOffset(a_variableName) >= 0;
+		inline bool has(const ShaderUniform &a_uniform) {
+			return uniform(a_uniform).location >= 0;
+		}
+		inline bool has(const std::string &a_variableName) {
+			return has(ShaderUniform(a_variableName));
+		}
+
+		//false when the program reads uniforms that change per drawable (time, alpha, uvMin/uvMax), those can't share a draw call.
+		bool batchable() const {
+			return !perDrawableUniforms;
 		}
 	private:
 		GLuint getDefaultTextureId() const;
 
 		void initialize() {
+			perDrawableUniforms = false;
+			//a relinked program starts with fresh locations and default values.
+			uniforms.clear();
 			if (!headless) {
 				variables.clear();
 				if (!glIsProgram(programId)) {
@@ -398,20 +501,41 @@ namespace MV {
 						std::cout << "Shader Uniform: [" << name << "] = " << location << std::endl;
 						variables[name] = location;
 					}
+					perDrawableUniforms = variables.count("time") || variables.count("alpha") || variables.count("uvMin") || variables.count("uvMax");
 					std::cout << "_" << std::endl;
 				}
 			}
 		}
 
+		static const GLint UnresolvedLocation = -2;
+		//Location and last uploaded value of one uniform in this program, indexed by ShaderUniform::id().
+		struct CachedUniform {
+			GLint location = UnresolvedLocation;
+			GLint sampler = -1;
+			size_t count = 0;
+			GLfloat values[16];
+		};
+
+		CachedUniform& uniform(const ShaderUniform &a_uniform) {
+			if (a_uniform.id() >= uniforms.size()) {
+				uniforms.resize(a_uniform.id() + 1);
+			}
+			auto& result = uniforms[a_uniform.id()];
+			if (result.location == UnresolvedLocation) {
+				result.location = headless ? -1 : variableOffset(a_uniform.name());
+			}
+			return result;
+		}
+
+		bool setValues(const ShaderUniform &a_uniform, const GLfloat *a_values, size_t a_count, bool a_errorIfNotPresent);
+		bool setSampler(const ShaderUniform &a_uniform, GLuint a_texture, GLuint a_textureBindIndex, bool a_errorIfNotPresent);
+
 		inline GLint variableOffset(const std::string &a_variableName){
 			auto found = variables.find(a_variableName);
 			if(found != variables.end()){
 				return found->second;
 			} else {
-				auto foundLocation = glGetUniformLocation(programId, a_variableName.c_str());
-				//might be -1 if missing, this is fine, avoid calling glGetUniformLocation next time.
-				variables[a_variableName] = foundLocation;
-				return foundLocation;
+				return glGetUniformLocation(programId, a_variableName.c_str());
 			}
 		}
 		std::string stringId;
@@ -419,7 +543,150 @@ namespace MV {
 		std::string fragmentShaderFile;
 		GLuint programId;
 		std::unordered_map<std::string, GLuint> variables;
+		std::vector<CachedUniform> uniforms;
 		bool headless;
+		RenderState* state;
+		bool perDrawableUniforms = false;
+	};
+
+	//A vertex array object with its own DrawPoint vertex buffer and index buffer, attribute setup is recorded once in the vertex array.
+	//Buffers rewritten on most draws switch to GL_STREAM_DRAW and orphan their storage instead of waiting on draws still in flight.
+	class DrawBuffer {
+	public:
+		//consecutive draws with fresh uploads before we treat the buffer as streaming.
+		static const int StreamAfterDraws = 3;
+
+		DrawBuffer() {}
+		DrawBuffer(const DrawBuffer &) = delete;
+		DrawBuffer& operator=(const DrawBuffer &) = delete;
+		~DrawBuffer();
+
+		//uploads a_points[a_begin, a_end), or all of a_points if they no longer fit the allocated storage.
+		void points(RenderState &a_state, const std::vector<DrawPoint> &a_points, size_t a_begin, size_t a_end);
+		void points(RenderState &a_state, const std::vector<DrawPoint> &a_points) {
+			points(a_state, a_points, 0, a_points.size());
+		}
+
+		void indices(RenderState &a_state, const std::vector<GLuint> &a_indices, size_t a_begin, size_t a_end);
+		void indices(RenderState &a_state, const std::vector<GLuint> &a_indices) {
+			indices(a_state, a_indices, 0, a_indices.size());
+		}
+
+		//the vertex array stays bound after drawing, the next bind of the same buffer is free.
+		void bind(RenderState &a_state);
+
+		void draw(GLenum a_drawType, size_t a_indexCount, size_t a_firstIndex = 0);
+
+		bool streaming() const {
+			return isStreaming;
+		}
+
+		void release();
+	private:
+		void initialize(RenderState &a_state);
+		template <typename T>
+		void upload(RenderState &a_state, GLenum a_target, GLuint a_bufferId, size_t &a_capacity, size_t &a_writtenEnd, const std::vector<T> &a_values, size_t a_begin, size_t a_end);
+
+		GLuint vertexArrayId = 0;
+		GLuint vertexBufferId = 0;
+		GLuint indexBufferId = 0;
+		size_t vertexCapacity = 0;
+		size_t indexCapacity = 0;
+		//end of what's been written since the storage was last orphaned, anything past it is safe to write unsynchronized.
+		size_t vertexWrittenEnd = 0;
+		size_t indexWrittenEnd = 0;
+
+		bool uploadedSinceDraw = false;
+		int drawsWithUploads = 0;
+		bool isStreaming = false;
+	};
+
+	//Collects draws for the current render target and merges the ones sharing state into as few draw calls as possible.
+	//Vertices are moved to world space on the CPU as they're queued, so the only uniform left is one projection per camera.
+	class RenderQueue {
+	public:
+		struct Statistics {
+			size_t commands = 0;
+			size_t batches = 0;
+			size_t vertices = 0;
+			size_t transformUploads = 0;
+		};
+
+		//Everything a batched draw depends on, textures bind to texture0...textureN in order.
+		struct State {
+			Shader* shader = nullptr;
+			std::vector<std::shared_ptr<TextureDefinition>> textures;
+			bool defaultBlend = true;
+			GLenum blendSource = GL_ONE;
+			GLenum blendDestination = GL_ONE_MINUS_SRC_ALPHA;
+			int32_t cameraId = 0;
+
+			bool operator==(const State &a_other) const {
+				return shader == a_other.shader && cameraId == a_other.cameraId && defaultBlend == a_other.defaultBlend &&
+					(defaultBlend || (blendSource == a_other.blendSource && blendDestination == a_other.blendDestination)) &&
+					textures == a_other.textures;
+			}
+			bool operator!=(const State &a_other) const {
+				return !(*this == a_other);
+			}
+		};
+
+		//how many pending batches a draw may jump ahead of to join an earlier batch with the same state.
+		static const size_t MergeLookBehind = 8;
+
+		RenderQueue(Draw2D &a_renderer) :
+			renderer(a_renderer) {
+		}
+
+		bool enabled() const {
+			return isEnabled;
+		}
+		RenderQueue& enabled(bool a_enabled);
+
+		//a_points are local to a_worldTransform, a_indices are GL_TRIANGLES indices into a_points.
+		void push(const State &a_state, const TransformMatrix &a_worldTransform, const std::vector<DrawPoint> &a_points, const std::vector<GLuint> &a_indices);
+
+		//draws everything pending. Call before anything draws outside of the queue or changes the render target, stencil, or cameras.
+		void flush();
+
+		bool empty() const {
+			return activeBatches == 0;
+		}
+
+		//rolls the running totals over into statistics(), Draw2D::updateScreen calls this.
+		void endFrame();
+
+		//totals for the last completed frame.
+		const Statistics& statistics() const {
+			return lastFrame;
+		}
+	private:
+		struct Batch {
+			State state;
+			std::vector<DrawPoint> points;
+			std::vector<GLuint> indices;
+			Point<> minimum;
+			Point<> maximum;
+
+			bool overlaps(int32_t a_cameraId, const Point<> &a_minimum, const Point<> &a_maximum) const {
+				return state.cameraId != a_cameraId ||
+					!(a_maximum.x < minimum.x || a_minimum.x > maximum.x || a_maximum.y < minimum.y || a_minimum.y > maximum.y);
+			}
+		};
+
+		Draw2D &renderer;
+		bool isEnabled = true;
+
+		std::vector<Batch> batches;
+		size_t activeBatches = 0;
+		std::vector<std::pair<Shader*, int32_t>> shaderCameras;
+
+		std::vector<DrawPoint> uploadPoints;
+		std::vector<GLuint> uploadIndices;
+		DrawBuffer buffer;
+
+		Statistics currentFrame;
+		Statistics lastFrame;
 	};
 
 	//If attempting to make multiple instances of Draw2D bear in mind it modifies global state in the
@@ -486,9 +753,19 @@ namespace MV {
 			require<ResourceException>(!initialized, "Renderer: Failed to make headless because we're already initialized!");
 			isHeadless = true;
 			RUNNING_IN_HEADLESS = true;
+			//servers draw headless every frame, batching there is opt in (ie: for counting batches in tests).
+			ourRenderQueue.enabled(false);
 			return *this;
 		}
 
+		RenderQueue& renderQueue() {
+			return ourRenderQueue;
+		}
+
+		RenderState& renderState() {
+			return ourRenderState;
+		}
+
 		//call for every event to handle window actions correctly
 		bool handleEvent(const SDL_Event &event);
 
@@ -506,6 +783,12 @@ namespace MV {
 		Point<> localFromWorld(const Point<> &a_worldPoint, int32_t a_cameraId, const TransformMatrix &a_modelview) const;
 		Point<> localFromScreen(const Point<int> &a_screenPoint, int32_t a_cameraId, const TransformMatrix &a_modelview) const;
 
+		std::vector<Point<>> worldFromLocal(std::vector<Point<>> a_localPoints, int32_t a_cameraId, const TransformMatrix &a_modelview) const;
+		std::vector<Point<int>> screenFromLocal(const std::vector<Point<>> &a_localPoints, int32_t a_cameraId, const TransformMatrix &a_modelview) const;
+
+		std::vector<Point<>> localFromWorld(std::vector<Point<>> a_worldPoints, int32_t a_cameraId, const TransformMatrix &a_modelview) const;
+		std::vector<Point<>> localFromScreen(const std::vector<Point<int>> &a_screenPoints, int32_t a_cameraId, const TransformMatrix &a_modelview) const;
+
 		Point<> screenFromWorldRaw(const Point<> &a_worldPoint) const;
 		Point<int> screenFromWorld(const Point<> &a_worldPoint) const;
 
@@ -571,6 +854,10 @@ namespace MV {
 		std::unordered_map<std::string, Shader> shaders;
 		Shader* defaultShaderPtr = nullptr;
 
+		//declared before anything owning a DrawBuffer so it outlives them.
+		RenderState ourRenderState;
+		RenderQueue ourRenderQueue;
+
 		bool isHeadless = false;
 
 		static bool firstInitializationSDL;
@@ -272,8 +272,9 @@ namespace MV {
 	Script::Registrar<SharedTextures> _hookSharedTextures([](chaiscript::ChaiScript& a_script, const MV::Services& a_services) {
 		a_script.add(chaiscript::user_type<SharedTextures>(), "SharedTextures");
 
-		a_script.add(chaiscript::fun(&SharedTextures::assemblePacks), "assemblePacks");
-		a_script.add(chaiscript::fun(&SharedTextures::assemblePack), "assemblePack");
+		a_script.add(chaiscript::fun(static_cast<void(SharedTextures::*)(const std::string&, Draw2D*)>(&SharedTextures::assemblePacks)), "assemblePacks");
+		a_script.add(chaiscript::fun(static_cast<std::shared_ptr<TexturePack>(SharedTextures::*)(const std::string&, Draw2D*)>(&SharedTextures::assemblePack)), "assemblePack");
+		a_script.add(chaiscript::fun(&SharedTextures::bakePacks), "bakePacks");
 		a_script.add(chaiscript::fun(&SharedTextures::white), "white");
 		a_script.add(chaiscript::fun(&SharedTextures::file), "file");
 		a_script.add(chaiscript::fun(&SharedTextures::dynamic), "dynamic");
@@ -282,6 +283,9 @@ namespace MV {
 		a_script.add(chaiscript::fun(&SharedTextures::fileId), "fileId");
 		a_script.add(chaiscript::fun(&SharedTextures::fileIds), "fileIds");
 		a_script.add(chaiscript::fun(&SharedTextures::packIds), "packIds");
+		a_script.add(chaiscript::fun(static_cast<void(SharedTextures::*)(size_t)>(&SharedTextures::residencyBudget)), "residencyBudget");
+		a_script.add(chaiscript::fun(static_cast<size_t(SharedTextures::*)() const>(&SharedTextures::residencyBudget)), "residencyBudget");
+		a_script.add(chaiscript::fun(&SharedTextures::residentBytes), "residentBytes");
 
 		a_script.add(chaiscript::fun([](SharedTextures& a_self, const std::string& a_name, Draw2D* a_renderer) {return a_self.pack(a_name, a_renderer); }), "pack");
 		a_script.add(chaiscript::fun([](SharedTextures& a_self, const std::string& a_name) {return a_self.pack(a_name); }), "pack");
@@ -1,6 +1,7 @@
 #include "sharedTextures.h"
 #include <algorithm>
 #include "MV/Utility/generalUtility.h"
+#include "MV/Utility/mappedFile.h"
 #include "MV/Utility/stringUtility.h"
 
 #include "MV/Utility/stopwatch.h"
@@ -40,6 +41,7 @@ namespace MV {
 		auto foundDefinition = fileDefinitions.find(identifier);
 		if(foundDefinition == fileDefinitions.end()){
 			std::shared_ptr<FileTextureDefinition> newDefinition = FileTextureDefinition::make(a_filename, true, a_repeat, a_pixel);
+			newDefinition->textures = this;
 			fileDefinitions[identifier] = newDefinition;
 			return newDefinition;
 		} else{
@@ -47,6 +49,72 @@ namespace MV {
 		}
 	}
 
+	void SharedTextures::stream(ThreadPool* a_pool) {
+		textureStreamer = a_pool ? std::make_unique<TextureStreamer>(*a_pool) : nullptr;
+	}
+
+	size_t SharedTextures::uploadStreamed(double a_budget) {
+		return textureStreamer ? textureStreamer->upload(a_budget) : 0;
+	}
+
+	size_t SharedTextures::residentBytes() const {
+		size_t total = 0;
+		auto add = [&](const auto &a_definitions) {
+			for (auto&& definition : a_definitions) {
+				if (definition.second->loaded()) {
+					total += static_cast<size_t>(definition.second->size().area()) * 4;
+				}
+			}
+		};
+		add(fileDefinitions);
+		add(surfaceDefinitions);
+		return total;
+	}
+
+	size_t SharedTextures::trim() {
+		if (maximumResidentBytes == 0) {
+			return 0;
+		}
+		struct Candidate {
+			TextureDefinition* texture;
+			size_t bytes;
+			bool referenced;
+			int64_t lastDrawn;
+		};
+		std::vector<Candidate> candidates;
+		size_t total = 0;
+		auto add = [&](const auto &a_definitions) {
+			for (auto&& definition : a_definitions) {
+				if (definition.second->loaded()) {
+					candidates.push_back({ definition.second.get(), static_cast<size_t>(definition.second->size().area()) * 4, definition.second->referenced(), definition.second->lastDrawn() });
+					total += candidates.back().bytes;
+				}
+			}
+		};
+		add(fileDefinitions);
+		add(surfaceDefinitions);
+		if (total <= maximumResidentBytes) {
+			return 0;
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate &a_lhs, const Candidate &a_rhs) {
+			return std::tie(a_lhs.referenced, a_lhs.lastDrawn) < std::tie(a_rhs.referenced, a_rhs.lastDrawn);
+		});
+		size_t evicted = 0;
+		auto frame = TextureDefinition::frame();
+		for (auto&& candidate : candidates) {
+			if (total <= maximumResidentBytes) {
+				break;
+			}
+			if (frame - candidate.lastDrawn >= MinimumIdleFrames) {
+				candidate.texture->evict();
+				total -= candidate.bytes;
+				++evicted;
+			}
+		}
+		return evicted;
+	}
+
 	void SharedTextures::files(const std::string &a_rootDirectory, bool a_repeat, bool a_pixel) {
 		path directory(a_rootDirectory);
 		if (exists(directory)) {
@@ -106,11 +174,27 @@ namespace MV {
 	}
 
 	void SharedTextures::assemblePacks(const std::string &a_rootDirectory, Draw2D* a_renderer) {
+		assemblePacks(a_rootDirectory, a_renderer, true);
+	}
+
+	void SharedTextures::bakePacks(const std::string &a_rootDirectory, Draw2D* a_renderer) {
+		assemblePacks(a_rootDirectory, a_renderer, false);
+	}
+
+	std::shared_ptr<TexturePack> SharedTextures::assemblePack(const std::string &a_packPath, Draw2D* a_renderer) {
+		return assemblePack(a_packPath, a_renderer, true);
+	}
+
+	void SharedTextures::assemblePacks(const std::string &a_rootDirectory, Draw2D* a_renderer, bool a_useBaked) {
 		path directory(a_rootDirectory);
 		if(exists(directory)){
 			for(auto&& atlas = directory_iterator(directory); atlas != directory_iterator();++atlas){
 				if(is_directory(*atlas)){
-					assemblePack(atlas->path().string(), a_renderer);
+					assemblePack(atlas->path().string(), a_renderer, a_useBaked);
+				} else if (a_useBaked && atlas->path().extension() == manifestExtension && !exists(path(atlas->path()).replace_extension(""))) {
+					if (!loadBakedPack(atlas->path().string(), {}, a_renderer)) {
+						MV::error("Texture Pack Manifest Unreadable: [", atlas->path().string(), "]");
+					}
 				}
 			}
 		}
@@ -146,11 +230,24 @@ namespace MV {
 		return packItems;
 	}
 
-	std::shared_ptr<TexturePack> SharedTextures::assemblePack(const std::string &a_packPath, Draw2D* a_renderer) {
+	std::shared_ptr<TexturePack> SharedTextures::assemblePack(const std::string &a_packPath, Draw2D* a_renderer, bool a_useBaked) {
 		Stopwatch timer;
 		timer.start();
 
-		std::vector<PackItem> packItems = getSortedPackItems(getImagesInFolder(a_packPath));
+		auto combinedSavePath = a_packPath;
+		if(a_packPath.back() == '\\' || a_packPath.back() == '/'){
+			combinedSavePath.pop_back();
+		}
+
+		auto imagePaths = getImagesInFolder(a_packPath);
+		if (a_useBaked && !imagePaths.empty()) {
+			if (auto bakedPack = loadBakedPack(combinedSavePath + manifestExtension, imagePaths, a_renderer)) {
+				MV::info("Texture Pack Loaded [", a_packPath, "]: ", timer.stop());
+				return bakedPack;
+			}
+		}
+
+		std::vector<PackItem> packItems = getSortedPackItems(imagePaths);
 		if (packItems.empty()) {
 			MV::error("Texture Pack Directory Is Empty: [", a_packPath, "]");
 			return {};
@@ -160,14 +257,63 @@ namespace MV {
 		for (auto&& packItem : packItems) {
 			newPack->add(packItem.id, packItem.texture, packItem.sliceBounds);
 		}
-		auto combinedSavePath = a_packPath;
-		if(a_packPath.back() == '\\' || a_packPath.back() == '/'){
-			combinedSavePath.pop_back();
+		newPack->consolidate(combinedSavePath + ".png", this);
+
+		std::ofstream manifestFile(combinedSavePath + manifestExtension, std::ios::out | std::ios::binary | std::ios::trunc);
+		manifestFile << toBinaryString(newPack->manifest(newestWriteTime(imagePaths)));
+		if (!manifestFile) {
+			MV::warning("Failed to write texture pack manifest [", combinedSavePath + manifestExtension, "]");
 		}
-		combinedSavePath += ".png";
-		newPack->consolidate(combinedSavePath, this);
 		MV::info("Texture Pack Saved [", a_packPath, "]: ", timer.stop());
 
 		return newPack;
 	}
+
+	std::shared_ptr<TexturePack> SharedTextures::loadBakedPack(const std::string &a_manifestPath, const std::vector<std::string> &a_imagePaths, Draw2D* a_renderer) {
+		MappedFile manifestFile(a_manifestPath);
+		if (manifestFile.empty()) {
+			return {};
+		}
+
+		TexturePack::Manifest manifest;
+		try {
+			manifest = fromBinaryData<TexturePack::Manifest>(manifestFile.data(), manifestFile.size());
+		} catch (std::exception &e) {
+			MV::warning("Discarding texture pack manifest [", a_manifestPath, "]: ", e.what());
+			return {};
+		}
+		if (manifest.version != TexturePack::Manifest::CurrentVersion) {
+			return {};
+		}
+
+		if (!a_imagePaths.empty()) {
+			if (manifest.shapes.size() != a_imagePaths.size() || newestWriteTime(a_imagePaths) > manifest.newestSource || !exists(path(manifest.page))) {
+				return {};
+			}
+			for (auto&& imagePath : a_imagePaths) {
+				auto imageId = path(imagePath).filename().string();
+				if (std::none_of(manifest.shapes.begin(), manifest.shapes.end(), [&](const TexturePack::Manifest::Shape &a_shape) { return a_shape.id == imageId; })) {
+					return {};
+				}
+			}
+		}
+
+		auto bakedPack = TexturePack::make(manifest, a_renderer, this);
+		texturePacks[manifest.id] = bakedPack;
+		return bakedPack;
+	}
+
+	int64_t SharedTextures::newestWriteTime(const std::vector<std::string> &a_imagePaths) {
+		int64_t newest = 0;
+		for (auto&& imagePath : a_imagePaths) {
+			for (auto&& sourcePath : { path(imagePath), path(imagePath).replace_extension("slc") }) {
+				boost::system::error_code errorCode;
+				auto writeTime = last_write_time(sourcePath, errorCode);
+				if (!errorCode) {
+					newest = std::max(newest, static_cast<int64_t>(writeTime));
+				}
+			}
+		}
+		return newest;
+	}
 }
@@ -11,6 +11,7 @@
 #include <boost/filesystem.hpp>
 
 #include "texturePacker.h"
+#include "textureStreamer.h"
 
 #include "MV/Serialization/serialize.h"
 
@@ -44,9 +45,40 @@ namespace MV {
 		std::vector<std::pair<std::string, bool>> fileIds() const;
 		std::vector<std::string> packIds() const;
 
+		//Each pack directory is packed and consolidated into <pack>.png with a <pack>.atlas manifest beside it.
+		//Packs whose manifest is newer than every source image load from the manifest instead of repacking.
+		//Manifests without a source directory (shipped builds) are always loaded.
 		void assemblePacks(const std::string &a_rootDirectory, Draw2D* a_renderer);
 		std::shared_ptr<TexturePack> assemblePack(const std::string &a_packPath, Draw2D* a_renderer);
 
+		//asset build step, repacks every pack and rewrites its manifest regardless of timestamps.
+		void bakePacks(const std::string &a_rootDirectory, Draw2D* a_renderer);
+
+		inline static const std::string manifestExtension = ".atlas";
+
+		//File textures that already know their size (ie: deserialized scenes) decode on a_pool and show a placeholder until uploaded.
+		//Call uploadStreamed once a frame on the render thread to land them. nullptr turns streaming back off.
+		void stream(ThreadPool* a_pool);
+		TextureStreamer* streamer() const {
+			return textureStreamer.get();
+		}
+		size_t uploadStreamed(double a_budget = TextureStreamer::DefaultUploadBudget);
+
+		//textures drawn this recently are in use and never evicted, even over budget.
+		static constexpr int64_t MinimumIdleFrames = 2;
+
+		//Once resident file and surface textures pass a_bytes, trim evicts them: unreferenced ones first, then least recently drawn.
+		//Evicted textures keep their handles and load again the next time they're drawn. 0 disables the budget.
+		void residencyBudget(size_t a_bytes) {
+			maximumResidentBytes = a_bytes;
+		}
+		size_t residencyBudget() const {
+			return maximumResidentBytes;
+		}
+		size_t residentBytes() const;
+		//call once a frame after drawing, returns the number of textures evicted.
+		size_t trim();
+
 		template <class Archive>
 		void serialize(Archive & archive, std::uint32_t const /*version*/){
 			archive(CEREAL_NVP(texturePacks), CEREAL_NVP(fileDefinitions), CEREAL_NVP(dynamicDefinitions), CEREAL_NVP(surfaceDefinitions));
@@ -69,10 +101,19 @@ namespace MV {
 		std::vector<std::string> getImagesInFolder(const std::string& a_packPath) const;
 		std::vector<SharedTextures::PackItem> getSortedPackItems(std::vector<std::string> imagePaths) const;
 
+		void assemblePacks(const std::string &a_rootDirectory, Draw2D* a_renderer, bool a_useBaked);
+		std::shared_ptr<TexturePack> assemblePack(const std::string &a_packPath, Draw2D* a_renderer, bool a_useBaked);
+		//null when the manifest is missing, unreadable, or older than a_imagePaths. Empty a_imagePaths skips the age check.
+		std::shared_ptr<TexturePack> loadBakedPack(const std::string &a_manifestPath, const std::vector<std::string> &a_imagePaths, Draw2D* a_renderer);
+		static int64_t newestWriteTime(const std::vector<std::string> &a_imagePaths);
+
 		std::map<std::string, std::shared_ptr<TexturePack>> texturePacks;
 		std::map<std::string, std::shared_ptr<FileTextureDefinition>> fileDefinitions;
 		std::map<std::string, std::shared_ptr<DynamicTextureDefinition>> dynamicDefinitions;
 		std::map<std::string, std::shared_ptr<SurfaceTextureDefinition>> surfaceDefinitions;
+
+		std::unique_ptr<TextureStreamer> textureStreamer;
+		size_t maximumResidentBytes = 0;
 	};
 }
 
@@ -4,6 +4,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 #include "sharedTextures.h"
 
@@ -30,6 +31,18 @@ namespace MV{
 		return std::shared_ptr<TexturePack>(new TexturePack(a_id, a_renderer, Color(0.0f, 0.0f, 0.0f, 0.0f), Size<int>(std::numeric_limits<int>::max(), std::numeric_limits<int>::max())));
 	}
 
+	std::shared_ptr<MV::TexturePack> TexturePack::make(const Manifest &a_manifest, MV::Draw2D* a_renderer, SharedTextures *a_shared) {
+		auto result = std::shared_ptr<TexturePack>(new TexturePack(a_manifest.id, a_renderer));
+		for (auto&& shape : a_manifest.shapes) {
+			result->shapes.push_back({ shape.id, shape.bounds, shape.slice, nullptr });
+			result->updateContainers(shape.bounds);
+		}
+		result->contentExtent = a_manifest.contentExtent;
+		result->consolidatedTexture = a_shared->file(a_manifest.page);
+		result->dirty = false;
+		return result;
+	}
+
 	bool TexturePack::add(const std::string &a_id, const std::shared_ptr<TextureDefinition> &a_shape, PointPrecision a_scale) {
 		return add(a_id, a_shape, MV::BoxAABB<float>(), a_scale);
 	}
@@ -282,6 +295,19 @@ namespace MV{
 		}
 	}
 
+	TexturePack::Manifest TexturePack::manifest(int64_t a_newestSource) const {
+		require<ResourceException>(consolidatedTexture, "TexturePack::manifest requires a consolidated pack: [", id, "]");
+		Manifest result;
+		result.id = id;
+		result.page = consolidatedTexture->name();
+		result.newestSource = a_newestSource;
+		result.contentExtent = contentExtent;
+		for (auto&& shape : shapes) {
+			result.shapes.push_back({ shape.id, shape.bounds, shape.slice });
+		}
+		return result;
+	}
+
 	std::vector<std::string> TexturePack::handleIds() const {
 		std::vector<std::string> keys;
 		std::transform(shapes.begin(), shapes.end(), std::back_inserter(keys), [](const ShapeDefinition &shape){
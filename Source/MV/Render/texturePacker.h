@@ -35,11 +35,44 @@ namespace MV {
 			}
 		};
 
+		//A consolidated pack's layout, saved beside its page image so later launches can skip packing entirely.
+		struct Manifest {
+			static const uint32_t CurrentVersion = 1;
+
+			struct Shape {
+				std::string id;
+				BoxAABB<int> bounds;
+				BoxAABB<float> slice;
+
+				template <class Archive>
+				void serialize(Archive & archive) {
+					archive(CEREAL_NVP(id), CEREAL_NVP(bounds), CEREAL_NVP(slice));
+				}
+			};
+
+			uint32_t version = CurrentVersion;
+			std::string id;
+			std::string page;
+			int64_t newestSource = 0; //write time of the newest source image when this was baked.
+			Size<int> contentExtent;
+			std::vector<Shape> shapes;
+
+			template <class Archive>
+			void serialize(Archive & archive) {
+				archive(CEREAL_NVP(version));
+				if (version == CurrentVersion) {
+					archive(CEREAL_NVP(id), CEREAL_NVP(page), CEREAL_NVP(newestSource), CEREAL_NVP(contentExtent), CEREAL_NVP(shapes));
+				}
+			}
+		};
+
 
 		static std::shared_ptr<TexturePack> make(const std::string &a_id, MV::Draw2D* a_renderer, const Color &a_color, const Size<int> &a_maximumExtent);
 		static std::shared_ptr<TexturePack> make(const std::string &a_id, MV::Draw2D* a_renderer, const Color &a_color);
 		static std::shared_ptr<TexturePack> make(const std::string &a_id, MV::Draw2D* a_renderer, const Size<int> &a_maximumExtent);
 		static std::shared_ptr<TexturePack> make(const std::string &a_id, MV::Draw2D* a_renderer);
+		//restores a baked pack, its page only loads once a handle is first requested.
+		static std::shared_ptr<TexturePack> make(const Manifest &a_manifest, MV::Draw2D* a_renderer, SharedTextures *a_shared);
 
 		bool add(const std::string &a_id, const std::shared_ptr<TextureDefinition> &a_shape, PointPrecision a_scale = 1.0f);
 		bool add(const std::string &a_id, const std::shared_ptr<TextureDefinition> &a_shape, const MV::BoxAABB<float> &a_slice, PointPrecision a_scale = 1.0f);
@@ -77,6 +110,8 @@ namespace MV {
 		}
 
 		void consolidate(const std::string &a_fileName, SharedTextures *a_shared);
+		//only valid after consolidate.
+		Manifest manifest(int64_t a_newestSource) const;
 
 		std::string identifier() const{
 			return id;
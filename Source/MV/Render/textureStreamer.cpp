@@ -0,0 +1,213 @@
+#include "textureStreamer.h"
+#include <algorithm>
+#include <chrono>
+#include <SDL_image.h>
+#include "MV/Utility/generalUtility.h"
+
+namespace MV {
+
+	TextureStreamer::TextureStreamer(ThreadPool& a_pool) :
+		pool(a_pool),
+		state(std::make_shared<State>()) {
+	}
+
+	TextureStreamer::~TextureStreamer() {
+		std::scoped_lock guard(state->lock);
+		state->queued.clear();
+		state->decoded.clear();
+	}
+
+	uint64_t TextureStreamer::request(const std::shared_ptr<FileTextureDefinition> &a_definition, const TextureParameters &a_parameters) {
+		auto newRequest = std::make_shared<Request>();
+		newRequest->ticket = nextTicket++;
+		newRequest->parameters = a_parameters;
+		newRequest->definition = a_definition;
+		newRequest->priority = a_definition->lastDrawn();
+		{
+			std::scoped_lock guard(state->lock);
+			state->queued.push_back(newRequest);
+		}
+		//jobs don't own a request, each decodes whichever queued request is most visible when it runs.
+		auto sharedState = state;
+		pool.task([sharedState]() { sharedState->decodeNext(); });
+		return newRequest->ticket;
+	}
+
+	size_t TextureStreamer::upload(double a_budget) {
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::shared_ptr<Request>> ready;
+		{
+			std::scoped_lock guard(state->lock);
+			auto abandoned = [&](const std::shared_ptr<Request> &a_request) {
+				auto definition = a_request->definition.lock();
+				if (!definition || definition->streamTicket != a_request->ticket) {
+					return true;
+				}
+				a_request->priority = definition->lastDrawn();
+				return false;
+			};
+			state->queued.erase(std::remove_if(state->queued.begin(), state->queued.end(), abandoned), state->queued.end());
+			for (auto&& request : state->decoded) {
+				if (abandoned(request)) {
+					request->failed = true;
+				}
+			}
+			std::swap(ready, state->decoded);
+		}
+		std::stable_sort(ready.begin(), ready.end(), [](const std::shared_ptr<Request> &a_lhs, const std::shared_ptr<Request> &a_rhs) {
+			return a_lhs->priority > a_rhs->priority;
+		});
+
+		size_t uploaded = 0;
+		auto current = ready.begin();
+		for (; current != ready.end(); ++current) {
+			if (uploaded > 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= a_budget) {
+				break;
+			}
+			uploadRequest(**current);
+			if (!(*current)->failed) {
+				++uploaded;
+			}
+		}
+
+		if (current != ready.end()) {
+			std::scoped_lock guard(state->lock);
+			state->decoded.insert(state->decoded.begin(), current, ready.end());
+		}
+		return uploaded;
+	}
+
+	size_t TextureStreamer::pending() const {
+		std::scoped_lock guard(state->lock);
+		return state->queued.size() + state->decoding.size() + state->decoded.size();
+	}
+
+	std::unique_ptr<LoadedTexture> TextureStreamer::placeholder() {
+		static const TextureParameters parameters{ "*TextureStreamer::placeholder*", false, false, true };
+		return std::make_unique<LoadedTexture>(parameters, []() {
+			auto results = std::make_unique<LoadedTextureData>();
+			results->size = Size<int>(1, 1);
+			results->originalSize = Size<int>(1, 1);
+			const uint32_t transparent = 0;
+			uploadTexturePixels(results->textureId, results->size, GL_RGBA, GL_RGBA, &transparent, parameters);
+			return results;
+		});
+	}
+
+	void TextureStreamer::uploadRequest(Request &a_request) {
+		auto definition = a_request.definition.lock();
+		if (!definition || definition->streamTicket != a_request.ticket) {
+			a_request.failed = true;
+		} else if (a_request.failed) {
+			definition->finishStreaming(a_request.ticket, nullptr);
+		} else {
+			auto loadedTexture = std::make_unique<LoadedTexture>(a_request.parameters, [&]() {
+				auto results = std::make_unique<LoadedTextureData>();
+				results->size = a_request.size;
+				results->originalSize = a_request.originalSize;
+				uploadTexturePixels(results->textureId, a_request.size, GL_RGBA, GL_RGBA, a_request.pixels.data(), a_request.parameters);
+				return results;
+			});
+			definition->finishStreaming(a_request.ticket, std::move(loadedTexture));
+		}
+		state->releaseBuffer(std::move(a_request.pixels));
+	}
+
+	/*****************************\
+	| ---TextureStreamer::State--- |
+	\*****************************/
+
+	void TextureStreamer::State::decodeNext() {
+		std::shared_ptr<Request> request;
+		{
+			std::scoped_lock guard(lock);
+			auto best = std::max_element(queued.begin(), queued.end(), [](const std::shared_ptr<Request> &a_lhs, const std::shared_ptr<Request> &a_rhs) {
+				return a_lhs->priority < a_rhs->priority;
+			});
+			if (best == queued.end()) {
+				return;
+			}
+			request = *best;
+			queued.erase(best);
+			decoding.push_back(request);
+		}
+
+		decode(*request);
+
+		std::scoped_lock guard(lock);
+		decoding.erase(std::remove(decoding.begin(), decoding.end(), request), decoding.end());
+		request->decoded = true;
+		decoded.push_back(request);
+	}
+
+	void TextureStreamer::State::decode(Request &a_request) {
+		const auto &path = a_request.parameters.path;
+		MV::info("Streaming Image: ", path);
+		SDL_RWops* sdlIO = sdlFileHandle(path);
+		if (!sdlIO) {
+			MV::warning("Failed to stream image [", path, "]");
+			a_request.failed = true;
+			return;
+		}
+		SDL_Surface *img = IMG_Load_RW(sdlIO, 1);
+		if (!img) {
+			MV::error("Failed to stream image [", path, "] [", SDL_GetError(), "]");
+			a_request.failed = true;
+			return;
+		}
+		auto source = OwnedSurface::make(img);
+
+		a_request.originalSize = Size<int>(img->w, img->h);
+		a_request.size = a_request.parameters.powerTwo ? Size<int>(roundUpPowerOfTwo(img->w), roundUpPowerOfTwo(img->h)) : a_request.originalSize;
+		a_request.pixels = acquireBuffer(static_cast<size_t>(a_request.size.width) * a_request.size.height * 4);
+
+		//blit straight into the pooled buffer in the same ABGR layout convertToPowerOfTwoSurface produces.
+		int bpp;
+		Uint32 Rmask, Gmask, Bmask, Amask;
+		SDL_PixelFormatEnumToMasks(SDL_PIXELFORMAT_ABGR8888, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+		auto target = OwnedSurface::make(SDL_CreateRGBSurfaceFrom(a_request.pixels.data(), a_request.size.width, a_request.size.height, bpp, a_request.size.width * 4, Rmask, Gmask, Bmask, Amask));
+
+		SDL_SetSurfaceBlendMode(img, SDL_BLENDMODE_NONE);
+		if (!target->get() || SDL_BlitSurface(img, 0, target->get(), 0) != 0) {
+			MV::error("Failed to convert streamed image [", path, "] [", SDL_GetError(), "]");
+			a_request.failed = true;
+		}
+	}
+
+	std::vector<uint8_t> TextureStreamer::State::acquireBuffer(size_t a_bytes) {
+		std::vector<uint8_t> result;
+		{
+			std::scoped_lock guard(lock);
+			auto best = freeBuffers.end();
+			for (auto buffer = freeBuffers.begin(); buffer != freeBuffers.end(); ++buffer) {
+				if (buffer->capacity() >= a_bytes && (best == freeBuffers.end() || buffer->capacity() < best->capacity())) {
+					best = buffer;
+				}
+			}
+			if (best != freeBuffers.end()) {
+				result = std::move(*best);
+				freeBuffers.erase(best);
+			}
+		}
+		//power of two padding must stay transparent, so reused buffers are cleared too.
+		result.assign(a_bytes, 0);
+		return result;
+	}
+
+	void TextureStreamer::State::releaseBuffer(std::vector<uint8_t> &&a_buffer) {
+		if (a_buffer.capacity() == 0) {
+			return;
+		}
+		std::scoped_lock guard(lock);
+		if (freeBuffers.size() < MaxPooledBuffers) {
+			freeBuffers.push_back(std::move(a_buffer));
+		} else {
+			auto smallest = std::min_element(freeBuffers.begin(), freeBuffers.end(), [](const std::vector<uint8_t> &a_lhs, const std::vector<uint8_t> &a_rhs) {
+				return a_lhs.capacity() < a_rhs.capacity();
+			});
+			if (smallest->capacity() < a_buffer.capacity()) {
+				*smallest = std::move(a_buffer);
+			}
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#ifndef _MV_TEXTURESTREAMER_H_
+#define _MV_TEXTURESTREAMER_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <string>
+
+#include "textures.h"
+#include "MV/Utility/threadPool.hpp"
+
+namespace MV {
+	//Decodes file textures on a thread pool and uploads them to GL from the render thread a few at a time.
+	//Requested textures show placeholder() until their upload lands, then fire onReload like a normal load.
+	class TextureStreamer {
+	public:
+		//seconds of upload work allowed per call to upload().
+		static constexpr double DefaultUploadBudget = 0.002;
+		//decoded pixel buffers kept around for reuse between requests.
+		static constexpr size_t MaxPooledBuffers = 8;
+
+		TextureStreamer(ThreadPool& a_pool);
+		~TextureStreamer();
+
+		//returns a ticket identifying this request, a_definition must pass it back through finishStreaming.
+		uint64_t request(const std::shared_ptr<FileTextureDefinition> &a_definition, const TextureParameters &a_parameters);
+
+		//render thread only. Uploads decoded textures, most recently drawn first, until a_budget seconds have elapsed.
+		//Always uploads at least one so a large texture cannot stall forever. Returns the number uploaded.
+		size_t upload(double a_budget = DefaultUploadBudget);
+
+		//requests still decoding or waiting for upload.
+		size_t pending() const;
+
+		//a shared transparent 1x1 texture standing in for textures that haven't streamed in yet.
+		static std::unique_ptr<LoadedTexture> placeholder();
+
+	private:
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+		struct Request {
+			uint64_t ticket = 0;
+			TextureParameters parameters;
+			std::weak_ptr<FileTextureDefinition> definition;
+			//the definition's last drawn frame, refreshed on the render thread each upload().
+			int64_t priority = 0;
+
+			bool decoded = false;
+			bool failed = false;
+			std::vector<uint8_t> pixels;
+			Size<int> size;
+			Size<int> originalSize;
+		};
+
+		//shared with queued pool jobs so they can outlive the streamer.
+		struct State {
+			void decodeNext();
+			void decode(Request &a_request);
+
+			std::vector<uint8_t> acquireBuffer(size_t a_bytes);
+			void releaseBuffer(std::vector<uint8_t> &&a_buffer);
+
+			mutable std::mutex lock;
+			std::vector<std::shared_ptr<Request>> queued;
+			std::vector<std::shared_ptr<Request>> decoding;
+			std::vector<std::shared_ptr<Request>> decoded;
+			std::vector<std::vector<uint8_t>> freeBuffers;
+		};
+
+		void uploadRequest(Request &a_request);
+
+		ThreadPool& pool;
+		std::shared_ptr<State> state;
+		uint64_t nextTicket = 1;
+	};
+}
+
+#endif
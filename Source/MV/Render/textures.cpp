@@ -6,6 +6,7 @@
 #include "MV/Utility/generalUtility.h"
 #include "MV/Render/points.h"
 #include "sharedTextures.h"
+#include "textureStreamer.h"
 
 #ifndef GL_BGR
 	#define GL_BGR 0x80E0
@@ -17,6 +18,7 @@
 
 #include "cereal/archives/json.hpp"
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 CEREAL_REGISTER_TYPE(MV::TextureDefinition);
 CEREAL_REGISTER_TYPE(MV::FileTextureDefinition);
@@ -162,17 +164,22 @@ namespace MV {
 		results->size.height = surfaceToWorkWith->get()->h;
 
 		if (!RUNNING_IN_HEADLESS) {
-			glBindTexture(GL_TEXTURE_2D, results->textureId);
+			uploadTexturePixels(results->textureId, results->size, getInternalTextureFormat(surfaceToWorkWith->get()), getTextureFormat(surfaceToWorkWith->get()), surfaceToWorkWith->get()->pixels, a_parameters);
+		}
+		return results;
+	}
 
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (a_parameters.pixel) ? GL_NEAREST : GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (a_parameters.pixel) ? GL_NEAREST : GL_LINEAR);
+	void uploadTexturePixels(GLuint a_textureId, const Size<int> &a_size, GLenum a_internalFormat, GLenum a_format, const void* a_pixels, const TextureParameters &a_parameters) {
+		glBindTexture(GL_TEXTURE_2D, a_textureId);
+		RenderState::textureBound(a_textureId);
 
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (a_parameters.repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (a_parameters.repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (a_parameters.pixel) ? GL_NEAREST : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (a_parameters.pixel) ? GL_NEAREST : GL_LINEAR);
 
-			glTexImage2D(GL_TEXTURE_2D, 0, getInternalTextureFormat(surfaceToWorkWith->get()), surfaceToWorkWith->get()->w, surfaceToWorkWith->get()->h, 0, getTextureFormat(surfaceToWorkWith->get()), GL_UNSIGNED_BYTE, surfaceToWorkWith->get()->pixels);
-		}
-		return results;
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (a_parameters.repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (a_parameters.repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+
+		glTexImage2D(GL_TEXTURE_2D, 0, a_internalFormat, a_size.width, a_size.height, 0, a_format, GL_UNSIGNED_BYTE, a_pixels);
 	}
 
 	/*************************\
@@ -187,6 +194,7 @@ namespace MV {
 
 	void TextureDefinition::load() {
 		if (!loaded() && !RUNNING_IN_HEADLESS) {
+			wasEvicted = false;
 			reloadImplementation();
 			if (isShared) {
 				onReloadAction(shared_from_this());
@@ -203,16 +211,16 @@ namespace MV {
 	}
 
 	Size<int> TextureDefinition::size() const {
-		require<ResourceException>(loaded(), "size:: The texture hasn't actually loaded yet.  You may need to create a handle to implicitly force a texture load.");
+		require<ResourceException>(loaded() || wasEvicted, "size:: The texture hasn't actually loaded yet.  You may need to create a handle to implicitly force a texture load.");
 		return textureSize;
 	}
 
 	void TextureDefinition::cleanupOpenglTexture() {
-		loadedTexture.release();
+		loadedTexture.reset();
 	}
 
 	Size<int> TextureDefinition::size() {
-		if (!loaded()) {
+		if (!loaded() && !wasEvicted) {
 			load();
 			auto ourSize = textureSize;
 			cleanupOpenglTexture();
@@ -223,12 +231,12 @@ namespace MV {
 	}
 
 	Size<int> TextureDefinition::contentSize() const {
-		require<ResourceException>(loaded(), "contentSize:: The texture hasn't actually loaded yet.  You may need to create a handle to implicitly force a texture load.");
+		require<ResourceException>(loaded() || wasEvicted, "contentSize:: The texture hasn't actually loaded yet.  You may need to create a handle to implicitly force a texture load.");
 		return desiredSize;
 	}
 
 	Size<int> TextureDefinition::contentSize() {
-		if (!loaded()) {
+		if (!loaded() && !wasEvicted) {
 			load();
 			auto ourSize = desiredSize;
 			cleanupOpenglTexture();
@@ -243,9 +251,21 @@ namespace MV {
 	}
 
 	void TextureDefinition::unload() {
+		wasEvicted = false;
 		cleanupOpenglTexture();
 	}
 
+	void TextureDefinition::evict() {
+		if (loaded()) {
+			cleanupOpenglTexture();
+			wasEvicted = true;
+		}
+	}
+
+	bool TextureDefinition::referenced() const {
+		return std::any_of(handles.begin(), handles.end(), [](const std::weak_ptr<TextureHandle> &a_handle) { return !a_handle.expired(); });
+	}
+
 	void TextureDefinition::unload(TextureHandle* toRemove) {
 		handles.erase(std::remove_if(handles.begin(), handles.end(), [&](const std::weak_ptr<TextureHandle> &value) {return value.expired() || &(*value.lock()) == toRemove; }), handles.end());
 		if (handles.empty()) {
@@ -317,6 +337,7 @@ namespace MV {
 		if (RUNNING_IN_HEADLESS) { return; }
 
 		if (loaded()) {
+			cleanupOpenglTexture();
 			load();
 		}
 	}
@@ -327,7 +348,16 @@ namespace MV {
 	\*****************************/
 
 	void FileTextureDefinition::reloadImplementation() {
-		loadedTexture = std::make_unique<LoadedTexture>(TextureParameters{ textureName, powerTwo, repeat, pixel });
+		TextureParameters parameters{ textureName, powerTwo, repeat, pixel };
+		//only stream when our size is already known (ie: deserialized), anything asking for it now needs the real texture.
+		auto streamer = textures ? textures->streamer() : nullptr;
+		if (streamer && isShared && textureSize.area() > 0 && !LoadedTexture::cached(parameters)) {
+			streamTicket = streamer->request(std::static_pointer_cast<FileTextureDefinition>(shared_from_this()), parameters);
+			loadedTexture = TextureStreamer::placeholder();
+			return;
+		}
+
+		loadedTexture = std::make_unique<LoadedTexture>(parameters);
 		if (loadedTexture->id() != 0) {
 			textureSize = loadedTexture->data().size;
 			desiredSize = loadedTexture->data().originalSize;
@@ -336,6 +366,26 @@ namespace MV {
 		}
 	}
 
+	void FileTextureDefinition::cleanupOpenglTexture() {
+		streamTicket = 0;
+		TextureDefinition::cleanupOpenglTexture();
+	}
+
+	void FileTextureDefinition::finishStreaming(uint64_t a_ticket, std::unique_ptr<LoadedTexture> a_loadedTexture) {
+		if (a_ticket == 0 || a_ticket != streamTicket) {
+			return;
+		}
+		streamTicket = 0;
+		if (a_loadedTexture && a_loadedTexture->id() != 0) {
+			loadedTexture = std::move(a_loadedTexture);
+			textureSize = loadedTexture->data().size;
+			desiredSize = loadedTexture->data().originalSize;
+		} else {
+			loadedTexture.reset();
+		}
+		onReloadAction(shared_from_this());
+	}
+
 	/********************************\
 	| ---DynamicTextureDefinition--- |
 	\********************************/
@@ -355,6 +405,7 @@ namespace MV {
 		memset(pixels.data(), backgroundColor.hex(), pixels.size() * sizeof(unsigned char));
 		
 		glBindTexture(GL_TEXTURE_2D, loadedTexture->id());			// Bind The Texture
+		RenderState::textureBound(loadedTexture->id());
 		// Build Texture Using Information In data
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -393,6 +444,16 @@ namespace MV {
 		return generatedSurfaceSize;
 	}
 
+	void SurfaceTextureDefinition::updateRegion(const std::shared_ptr<OwnedSurface> &a_surface, const Point<int> &a_position) {
+		if (!loaded() || a_surface == nullptr || a_surface->get() == nullptr) {
+			return;
+		}
+		auto converted = convertToBGRSurface(a_surface);
+		glBindTexture(GL_TEXTURE_2D, textureId());
+		RenderState::textureBound(textureId());
+		glTexSubImage2D(GL_TEXTURE_2D, 0, a_position.x, a_position.y, converted->get()->w, converted->get()->h, getTextureFormat(converted->get()), GL_UNSIGNED_BYTE, converted->get()->pixels);
+	}
+
 
 	/*********************\
 	| ---TextureHandle--- |
@@ -17,6 +17,7 @@
 
 namespace MV {
 	class SharedTextures;
+	class TextureStreamer;
 	class TextureHandle;
 	struct LoadedTextureData;
 	struct TextureParameters;
@@ -54,6 +55,8 @@ namespace MV {
 	std::shared_ptr<OwnedSurface> convertToPowerOfTwoSurface(const std::shared_ptr<OwnedSurface> &a_img);
 	std::shared_ptr<OwnedSurface> convertToBGRSurface(const std::shared_ptr<OwnedSurface> &a_img);
 	std::unique_ptr<LoadedTextureData> loadTextureFromSurface(const std::shared_ptr<OwnedSurface> &img, const TextureParameters &file);
+	//binds a_textureId and uploads a_pixels with the filtering and wrapping a_parameters asks for.
+	void uploadTexturePixels(GLuint a_textureId, const Size<int> &a_size, GLenum a_internalFormat, GLenum a_format, const void* a_pixels, const TextureParameters &a_parameters);
 
 	//required to allow forward declared MV::SharedTextures
 	MV::SharedTextures* getSharedTextureFromServices(MV::Services& a_services);
@@ -131,6 +134,7 @@ namespace MV {
 		}
 		~OpenGlTextureId() {
 			if (textureId != 0) {
+				RenderState::textureDeleted(textureId);
 				glDeleteTextures(1, &textureId);
 			}
 		}
@@ -173,19 +177,22 @@ namespace MV {
 
 	class LoadedTexture {
 	public:
-		LoadedTexture(const TextureParameters& a_parameters) {
+		LoadedTexture(const TextureParameters& a_parameters) :
+			LoadedTexture(a_parameters, [&]() { return loadFile(a_parameters); }) {
+		}
+		//shares an already loaded texture matching a_parameters, or adopts the result of a_create (ie: a streamed upload).
+		LoadedTexture(const TextureParameters& a_parameters, const std::function<std::unique_ptr<LoadedTextureData>()> &a_create) {
 			if (a_parameters.cleared) {
 				locallyOwnedParametersValue = std::make_unique<TextureParameters>(a_parameters);
 				locallyOwnedDataValue = std::make_unique<LoadedTextureData>();
 			} else {
 				std::scoped_lock guard(lock);
 				auto found = globalLookup.find(a_parameters);
-				if (found != globalLookup.end()) {
-					++found->second->useCount;
-				} else {
+				if (found == globalLookup.end()) {
 					bool success = false;
-					std::tie(found, success) = globalLookup.insert({ a_parameters, std::move(loadFile(a_parameters)) });
+					std::tie(found, success) = globalLookup.insert({ a_parameters, a_create() });
 				}
+				++found->second->useCount;
 				dataValue = found->second.get();
 				parametersValue = &found->first;
 			}
@@ -193,14 +200,27 @@ namespace MV {
 		LoadedTexture(std::unique_ptr<LoadedTextureData> a_locallyOwnedDataValue) :
 			locallyOwnedDataValue(a_locallyOwnedDataValue.release()){
 		}
-		LoadedTexture(LoadedTexture&&) = default;
+		LoadedTexture(LoadedTexture&& a_rhs) :
+			dataValue(a_rhs.dataValue),
+			parametersValue(a_rhs.parametersValue),
+			locallyOwnedDataValue(std::move(a_rhs.locallyOwnedDataValue)),
+			locallyOwnedParametersValue(std::move(a_rhs.locallyOwnedParametersValue)) {
+			a_rhs.dataValue = nullptr;
+			a_rhs.parametersValue = nullptr;
+		}
 		~LoadedTexture() {
-			if (--dataValue->useCount == 0) {
+			if (dataValue && --dataValue->useCount == 0) {
 				std::scoped_lock guard(lock);
 				globalLookup.erase(parameters());
 			}
 		}
 
+		//true if a texture matching a_parameters is already resident and can be shared without loading.
+		static bool cached(const TextureParameters& a_parameters) {
+			std::scoped_lock guard(lock);
+			return globalLookup.find(a_parameters) != globalLookup.end();
+		}
+
 		const TextureParameters& parameters() const {
 			return locallyOwnedParametersValue ? *locallyOwnedParametersValue : *parametersValue;
 		}
@@ -217,8 +237,8 @@ namespace MV {
 		std::unique_ptr<LoadedTextureData> loadFile(const TextureParameters& a_parameters);
 		//static void releaseFile(const TextureParameters& a_parameters);
 		
-		LoadedTextureData* dataValue;
-		const TextureParameters* parametersValue;
+		LoadedTextureData* dataValue = nullptr;
+		const TextureParameters* parametersValue = nullptr;
 		std::unique_ptr<LoadedTextureData> locallyOwnedDataValue;
 		std::unique_ptr<TextureParameters> locallyOwnedParametersValue;
 		static std::mutex lock;
@@ -262,8 +282,33 @@ namespace MV {
 
 		void reload();
 
+		//releases the GPU texture but keeps handles and sizes, the next draw loads it again.
+		void evict();
+		bool evicted() const {
+			return wasEvicted;
+		}
+		//true while any handle into this texture is alive.
+		bool referenced() const;
+
 		void save(const std::string &a_fileName);
 
+		//Shader marks textures as they are bound, Draw2D::updateScreen ends the frame.
+		void drawn() {
+			lastDrawnFrame = currentFrame.load();
+			if (wasEvicted) {
+				load();
+			}
+		}
+		int64_t lastDrawn() const {
+			return lastDrawnFrame;
+		}
+		static int64_t frame() {
+			return currentFrame;
+		}
+		static void endFrame() {
+			++currentFrame;
+		}
+
 	protected:
 		virtual void cleanupOpenglTexture();
 		TextureDefinition(const std::string &a_name, bool a_isShared = true);
@@ -277,6 +322,10 @@ namespace MV {
 		bool isShared;
 
 	private:
+		std::atomic<int64_t> lastDrawnFrame = 0;
+		bool wasEvicted = false;
+		inline static std::atomic<int64_t> currentFrame = 0;
+
 		template <class Archive>
 		void serialize(Archive & archive, std::uint32_t const version){
 			archive(
@@ -299,6 +348,8 @@ namespace MV {
 
 	class FileTextureDefinition : public TextureDefinition {
 		friend cereal::access;
+		friend SharedTextures;
+		friend TextureStreamer;
 	public:
 		static std::shared_ptr<FileTextureDefinition> make(const std::string &a_filename, bool a_powerTwo = true, bool a_repeat = false, bool a_pixel = false){
 			return std::shared_ptr<FileTextureDefinition>(new FileTextureDefinition(a_filename, a_powerTwo, a_repeat, a_pixel));
@@ -316,8 +367,12 @@ namespace MV {
 		}
 
 		void reloadImplementation() override;
+		void cleanupOpenglTexture() override;
 
 	private:
+		//installs a texture streamed in by TextureStreamer, ignored if a_ticket was cancelled by an unload since.
+		//a null a_loadedTexture means the decode failed and the placeholder is dropped.
+		void finishStreaming(uint64_t a_ticket, std::unique_ptr<LoadedTexture> a_loadedTexture);
 
 		template <class Archive>
 		void serialize(Archive & archive, std::uint32_t const /*version*/){
@@ -340,6 +395,7 @@ namespace MV {
 		}
 
 		SharedTextures *textures = nullptr;
+		uint64_t streamTicket = 0;
 		bool powerTwo;
 		bool repeat;
 		bool pixel;
@@ -390,6 +446,9 @@ namespace MV {
 
 		Size<int> surfaceSize() const;
 
+		//copies a_surface into the loaded texture at a_position without regenerating the whole surface.
+		void updateRegion(const std::shared_ptr<OwnedSurface> &a_surface, const Point<int> &a_position);
+
 		void setSurfaceGenerator(std::function<std::shared_ptr<OwnedSurface> ()> a_surfaceGenerator){
 			surfaceGenerator = a_surfaceGenerator;
 			if(!handles.empty()){
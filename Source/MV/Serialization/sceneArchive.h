@@ -0,0 +1,265 @@
+#ifndef _MV_SCENEARCHIVE_H_
+#define _MV_SCENEARCHIVE_H_
+
+#include "cereal/cereal.hpp"
+#include "cereal/archives/portable_binary.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MV {
+	//Binary layout for scenes and prefabs, little endian throughout:
+	//	header: magic, format version, string count, string table bytes, payload bytes
+	//	string table: the end offset of each string, then the characters of every string back to back
+	//	payload: cereal records, with each std::string written as a string table index and container sizes as varints
+	//Node ids, component ids, shader ids and asset paths repeat all through a scene, here each is stored once.
+	struct SceneArchiveHeader {
+		//"MVSN" when read as little endian bytes.
+		static constexpr uint32_t Magic = 0x4E53564D;
+		static constexpr uint32_t CurrentVersion = 1;
+		static constexpr size_t Bytes = 24;
+	};
+
+	namespace SceneArchiveDetail {
+		template <size_t DataSize>
+		inline void toLittleEndian(void* a_data, size_t a_bytes) {
+			if (DataSize > 1 && !cereal::portable_binary_detail::is_little_endian()) {
+				auto* bytes = static_cast<std::uint8_t*>(a_data);
+				for (size_t i = 0; i < a_bytes; i += DataSize) {
+					cereal::portable_binary_detail::swap_bytes<DataSize>(bytes + i);
+				}
+			}
+		}
+
+		template <typename T>
+		inline void append(std::ostream &a_stream, T a_value) {
+			toLittleEndian<sizeof(T)>(&a_value, sizeof(T));
+			a_stream.write(reinterpret_cast<const char*>(&a_value), sizeof(T));
+		}
+
+		template <typename T>
+		inline T read(const char* a_data) {
+			T result;
+			std::memcpy(&result, a_data, sizeof(T));
+			toLittleEndian<sizeof(T)>(&result, sizeof(T));
+			return result;
+		}
+	}
+
+	//true if a_data starts with a scene archive header this build can read.
+	inline bool isSceneArchive(const char* a_data, size_t a_size) {
+		return a_size >= SceneArchiveHeader::Bytes &&
+			SceneArchiveDetail::read<uint32_t>(a_data) == SceneArchiveHeader::Magic &&
+			SceneArchiveDetail::read<uint32_t>(a_data + 4) <= SceneArchiveHeader::CurrentVersion;
+	}
+
+	class SceneOutputArchive : public cereal::OutputArchive<SceneOutputArchive, cereal::AllowEmptyClassElision> {
+	public:
+		SceneOutputArchive(std::ostream &a_stream) :
+			cereal::OutputArchive<SceneOutputArchive, cereal::AllowEmptyClassElision>(this),
+			stream(a_stream) {
+		}
+
+		//the header and string table need every string first, so nothing reaches the stream until we're destroyed.
+		~SceneOutputArchive() CEREAL_NOEXCEPT {
+			using SceneArchiveDetail::append;
+			append<uint32_t>(stream, SceneArchiveHeader::Magic);
+			append<uint32_t>(stream, SceneArchiveHeader::CurrentVersion);
+			append<uint32_t>(stream, static_cast<uint32_t>(strings.size()));
+			append<uint32_t>(stream, static_cast<uint32_t>(stringBytes));
+			append<uint64_t>(stream, static_cast<uint64_t>(payload.size()));
+			uint32_t offset = 0;
+			for (auto&& value : strings) {
+				offset += static_cast<uint32_t>(value->size());
+				append<uint32_t>(stream, offset);
+			}
+			for (auto&& value : strings) {
+				stream.write(value->data(), static_cast<std::streamsize>(value->size()));
+			}
+			stream.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+		}
+
+		template <std::size_t DataSize>
+		void saveBinary(const void* a_data, std::size_t a_size) {
+			auto offset = payload.size();
+			payload.append(static_cast<const char*>(a_data), a_size);
+			SceneArchiveDetail::toLittleEndian<DataSize>(&payload[offset], a_size);
+		}
+
+		//7 bits per byte, high bit set while more follow. Sizes and string indices are almost always a single byte.
+		void saveVarint(uint64_t a_value) {
+			while (a_value >= 0x80) {
+				payload.push_back(static_cast<char>((a_value & 0x7F) | 0x80));
+				a_value >>= 7;
+			}
+			payload.push_back(static_cast<char>(a_value));
+		}
+
+		void saveString(const std::string &a_value) {
+			auto found = stringIndices.find(a_value);
+			if (found == stringIndices.end()) {
+				if (stringBytes + a_value.size() > std::numeric_limits<uint32_t>::max()) {
+					throw cereal::Exception("Scene archive string table exceeds 4GB.");
+				}
+				found = stringIndices.emplace(a_value, static_cast<uint32_t>(strings.size())).first;
+				strings.push_back(&found->first);
+				stringBytes += a_value.size();
+			}
+			saveVarint(found->second);
+		}
+
+	private:
+		std::ostream &stream;
+		std::string payload;
+		//keys are stable, strings points into them in table order.
+		std::unordered_map<std::string, uint32_t> stringIndices;
+		std::vector<const std::string*> strings;
+		size_t stringBytes = 0;
+	};
+
+	class SceneInputArchive : public cereal::InputArchive<SceneInputArchive, cereal::AllowEmptyClassElision> {
+	public:
+		//reads straight out of a_data, which must stay alive and unchanged for the life of the archive.
+		SceneInputArchive(const char* a_data, size_t a_size) :
+			cereal::InputArchive<SceneInputArchive, cereal::AllowEmptyClassElision>(this) {
+
+			using SceneArchiveDetail::read;
+			if (a_size < SceneArchiveHeader::Bytes || read<uint32_t>(a_data) != SceneArchiveHeader::Magic) {
+				throw cereal::Exception("Data is not a scene archive.");
+			}
+			fileVersion = read<uint32_t>(a_data + 4);
+			if (fileVersion > SceneArchiveHeader::CurrentVersion) {
+				throw cereal::Exception("Scene archive version " + std::to_string(fileVersion) + " is newer than this build supports (" + std::to_string(SceneArchiveHeader::CurrentVersion) + ").");
+			}
+			stringCount = read<uint32_t>(a_data + 8);
+			stringBytes = read<uint32_t>(a_data + 12);
+			uint64_t payloadBytes = read<uint64_t>(a_data + 16);
+
+			uint64_t remaining = a_size - SceneArchiveHeader::Bytes;
+			uint64_t tableBytes = static_cast<uint64_t>(stringCount) * sizeof(uint32_t) + stringBytes;
+			if (tableBytes > remaining || payloadBytes > remaining - tableBytes) {
+				throw cereal::Exception("Scene archive is truncated.");
+			}
+			offsets = a_data + SceneArchiveHeader::Bytes;
+			characters = offsets + static_cast<size_t>(stringCount) * sizeof(uint32_t);
+			cursor = characters + stringBytes;
+			end = cursor + payloadBytes;
+		}
+
+		template <std::size_t DataSize>
+		void loadBinary(void* a_data, std::size_t a_size) {
+			requireBytes(a_size);
+			std::memcpy(a_data, cursor, a_size);
+			cursor += a_size;
+			SceneArchiveDetail::toLittleEndian<DataSize>(a_data, a_size);
+		}
+
+		uint64_t loadVarint() {
+			uint64_t result = 0;
+			for (int shift = 0; shift < 64; shift += 7) {
+				requireBytes(1);
+				auto byte = static_cast<uint8_t>(*cursor++);
+				result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if (!(byte & 0x80)) {
+					return result;
+				}
+			}
+			throw cereal::Exception("Scene archive contains a malformed varint.");
+		}
+
+		void loadString(std::string &a_value) {
+			auto index = loadVarint();
+			if (index >= stringCount) {
+				throw cereal::Exception("Scene archive string index " + std::to_string(index) + " is out of range.");
+			}
+			uint32_t first = index == 0 ? 0 : SceneArchiveDetail::read<uint32_t>(offsets + (index - 1) * sizeof(uint32_t));
+			uint32_t last = SceneArchiveDetail::read<uint32_t>(offsets + index * sizeof(uint32_t));
+			if (first > last || last > stringBytes) {
+				throw cereal::Exception("Scene archive string table is corrupt.");
+			}
+			a_value.assign(characters + first, last - first);
+		}
+
+		uint32_t version() const {
+			return fileVersion;
+		}
+
+	private:
+		void requireBytes(size_t a_size) const {
+			if (static_cast<size_t>(end - cursor) < a_size) {
+				throw cereal::Exception("Failed to read " + std::to_string(a_size) + " bytes from scene archive, " + std::to_string(end - cursor) + " remain.");
+			}
+		}
+
+		const char* offsets = nullptr;
+		const char* characters = nullptr;
+		const char* cursor = nullptr;
+		const char* end = nullptr;
+		uint32_t stringCount = 0;
+		uint32_t stringBytes = 0;
+		uint32_t fileVersion = 0;
+	};
+
+	template <class T> inline
+	typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+	CEREAL_SAVE_FUNCTION_NAME(SceneOutputArchive &a_archive, T const &a_value) {
+		static_assert(!std::is_floating_point<T>::value || std::numeric_limits<T>::is_iec559, "Scene archives only support IEEE 754 floating point");
+		a_archive.template saveBinary<sizeof(T)>(std::addressof(a_value), sizeof(T));
+	}
+
+	template <class T> inline
+	typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+	CEREAL_LOAD_FUNCTION_NAME(SceneInputArchive &a_archive, T &a_value) {
+		static_assert(!std::is_floating_point<T>::value || std::numeric_limits<T>::is_iec559, "Scene archives only support IEEE 754 floating point");
+		a_archive.template loadBinary<sizeof(T)>(std::addressof(a_value), sizeof(T));
+	}
+
+	template <class Archive, class T> inline
+	CEREAL_ARCHIVE_RESTRICT(SceneInputArchive, SceneOutputArchive)
+	CEREAL_SERIALIZE_FUNCTION_NAME(Archive &a_archive, cereal::NameValuePair<T> &a_value) {
+		a_archive(a_value.value);
+	}
+
+	template <class T> inline
+	void CEREAL_SAVE_FUNCTION_NAME(SceneOutputArchive &a_archive, cereal::SizeTag<T> const &a_tag) {
+		a_archive.saveVarint(static_cast<uint64_t>(a_tag.size));
+	}
+
+	template <class T> inline
+	void CEREAL_LOAD_FUNCTION_NAME(SceneInputArchive &a_archive, cereal::SizeTag<T> &a_tag) {
+		a_tag.size = static_cast<typename std::remove_reference<T>::type>(a_archive.loadVarint());
+	}
+
+	template <class T> inline
+	void CEREAL_SAVE_FUNCTION_NAME(SceneOutputArchive &a_archive, cereal::BinaryData<T> const &a_data) {
+		typedef typename std::remove_pointer<T>::type ElementType;
+		a_archive.template saveBinary<sizeof(ElementType)>(a_data.data, static_cast<std::size_t>(a_data.size));
+	}
+
+	template <class T> inline
+	void CEREAL_LOAD_FUNCTION_NAME(SceneInputArchive &a_archive, cereal::BinaryData<T> &a_data) {
+		typedef typename std::remove_pointer<T>::type ElementType;
+		a_archive.template loadBinary<sizeof(ElementType)>(a_data.data, static_cast<std::size_t>(a_data.size));
+	}
+
+	//preferred over cereal's generic string serialization, which would write the characters inline.
+	inline void CEREAL_SAVE_FUNCTION_NAME(SceneOutputArchive &a_archive, std::string const &a_value) {
+		a_archive.saveString(a_value);
+	}
+
+	inline void CEREAL_LOAD_FUNCTION_NAME(SceneInputArchive &a_archive, std::string &a_value) {
+		a_archive.loadString(a_value);
+	}
+}
+
+CEREAL_REGISTER_ARCHIVE(MV::SceneOutputArchive)
+CEREAL_REGISTER_ARCHIVE(MV::SceneInputArchive)
+
+CEREAL_SETUP_ARCHIVE_TRAITS(MV::SceneInputArchive, MV::SceneOutputArchive)
+
+#endif
@@ -17,6 +17,7 @@
 
 #include "cereal/archives/portable_binary.hpp"
 #include "cereal/archives/json.hpp"
+#include "MV/Serialization/sceneArchive.h"
 
 #include "cereal/details/traits.hpp"
 
@@ -27,6 +28,15 @@
 
 namespace MV {
 
+	//Read only stream buffer over memory owned elsewhere, lets cereal's stream based archives read mapped files in place.
+	class MemoryInputBuffer : public std::streambuf {
+	public:
+		MemoryInputBuffer(const char* a_data, size_t a_size) {
+			char* begin = const_cast<char*>(a_data);
+			setg(begin, begin, begin + a_size);
+		}
+	};
+
 	inline std::string cerealEncodeWrapper(std::string const& unencoded_string) {
 		return cereal::base64::encode(reinterpret_cast<const unsigned char *>(unencoded_string.c_str()), unencoded_string.size());
 	}
@@ -76,6 +86,45 @@ namespace MV {
 		input(result);
 		return result;
 	}
+
+	template <typename T>
+	T fromBinaryData(const char* a_data, size_t a_size) {
+		MemoryInputBuffer buffer(a_data, a_size);
+		std::istream messageStream(&buffer);
+		cereal::PortableBinaryInputArchive input(messageStream);
+		T result;
+		input(result);
+		return result;
+	}
+
+	template <typename T>
+	T fromBinaryData(const char* a_data, size_t a_size, MV::Services& a_services) {
+		MemoryInputBuffer buffer(a_data, a_size);
+		std::istream messageStream(&buffer);
+		cereal::UserDataAdapter<MV::Services, cereal::PortableBinaryInputArchive> input(a_services, messageStream);
+		T result;
+		input(result);
+		return result;
+	}
+
+	template <typename T>
+	std::string toSceneArchive(const T& a_input) {
+		std::ostringstream messageStream(std::ios_base::out | std::ios_base::binary);
+		{
+			SceneOutputArchive output(messageStream);
+			output(a_input);
+		}
+		return messageStream.str();
+	}
+
+	//a_data must be a whole scene archive, see isSceneArchive.
+	template <typename T>
+	T fromSceneArchive(const char* a_data, size_t a_size, MV::Services& a_services) {
+		cereal::UserDataAdapter<MV::Services, SceneInputArchive> input(a_services, a_data, a_size);
+		T result;
+		input(result);
+		return result;
+	}
     
     template <typename T>
     T fromBase64(const std::string &a_input) {
@@ -138,6 +187,16 @@ namespace MV {
 		return result;
 	}
 
+	template <typename T>
+	T fromJsonData(const char* a_data, size_t a_size, MV::Services& a_services) {
+		MemoryInputBuffer buffer(a_data, a_size);
+		std::istream messageStream(&buffer);
+		cereal::UserDataAdapter<MV::Services, cereal::JSONInputArchive> input(a_services, messageStream);
+		T result;
+		input(result);
+		return result;
+	}
+
 }
 
 #endif
@@ -174,6 +174,18 @@ namespace MV {
 #endif
 	}
 
+	std::string filePathInSearchPaths(const std::string& a_path) {
+		if (a_path.empty()) {
+			return {};
+		}
+		std::string userPrefPath = playerPreferencesPath() + a_path;
+#if defined(__ANDROID__) || defined(__APPLE__)
+		return fileExistsAbsolute(userPrefPath) ? userPrefPath : fileExistsAbsolute(a_path) ? a_path : std::string();
+#else
+		return fileExistsAbsolute(a_path) ? a_path : fileExistsAbsolute(userPrefPath) ? userPrefPath : fileExistsAbsolute("Assets/" + a_path) ? "Assets/" + a_path : std::string();
+#endif
+	}
+
 	SDL_RWops* sdlFileHandle(const std::string& a_path) {
 		if (a_path.empty()) {
 			return {};
@@ -10,6 +10,7 @@
 #include <numeric>
 #include <stdint.h>
 #include <random>
+#include <limits>
 #include <array>
 #include <type_traits>
 #include <mutex>
@@ -307,6 +308,8 @@ namespace MV {
 
 	bool fileExistsAbsolute(const std::string& a_path);
 	bool fileExistsInSearchPaths(const std::string& a_path);
+	//the first existing path fileContents would open for a_path, blank if there isn't one.
+	std::string filePathInSearchPaths(const std::string& a_path);
 	bool writeToFile(const std::string& a_path, const std::string& a_contents);
 	bool deleteFile(const std::string& a_path);
 	time_t lastFileWriteTime(const std::string& a_path);
@@ -498,6 +501,69 @@ namespace MV {
 		friend int64_t randomInteger(int64_t, int64_t);
 	};
 
+	//Same sequence for a given seed on every platform and standard library (std distributions are implementation
+	//defined), use for simulation code that has to agree between machines. splitmix64 with integer only range mapping.
+	class DeterministicRandom {
+	public:
+		DeterministicRandom(uint64_t a_seed = 0) {
+			seed(a_seed);
+		}
+
+		uint64_t seed() const {
+			return generatorSeed;
+		}
+		DeterministicRandom& seed(uint64_t a_seed) {
+			generatorSeed = a_seed;
+			generatorState = a_seed;
+			return *this;
+		}
+
+		//Changes with every number drawn, useful for checksums and saving mid-sequence.
+		uint64_t state() const {
+			return generatorState;
+		}
+		DeterministicRandom& state(uint64_t a_state) {
+			generatorState = a_state;
+			return *this;
+		}
+
+		uint64_t next() {
+			uint64_t result = (generatorState += 0x9E3779B97F4A7C15ull);
+			result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ull;
+			result = (result ^ (result >> 27)) * 0x94D049BB133111EBull;
+			return result ^ (result >> 31);
+		}
+
+		//Inclusive of both ends.
+		int64_t integer(int64_t a_min, int64_t a_max) {
+			if (a_max <= a_min) {
+				return a_min;
+			}
+			uint64_t range = static_cast<uint64_t>(a_max) - static_cast<uint64_t>(a_min) + 1;
+			if (range == 0) {
+				return static_cast<int64_t>(next());
+			}
+			uint64_t limit = std::numeric_limits<uint64_t>::max() - (std::numeric_limits<uint64_t>::max() % range);
+			uint64_t value;
+			do {
+				value = next();
+			} while (value >= limit);
+			return static_cast<int64_t>(static_cast<uint64_t>(a_min) + (value % range));
+		}
+
+		double number(double a_min, double a_max) {
+			return a_min + (a_max - a_min) * (static_cast<double>(next() >> 11) / static_cast<double>(1ull << 53));
+		}
+
+		float number(float a_min, float a_max) {
+			return a_min + (a_max - a_min) * (static_cast<float>(next() >> 40) / static_cast<float>(1ull << 24));
+		}
+
+	private:
+		uint64_t generatorSeed = 0;
+		uint64_t generatorState = 0;
+	};
+
 	template<typename T>
 	void randomShuffle(T collection) {
 		return Random::global()->shuffle(collection);
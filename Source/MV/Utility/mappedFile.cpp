@@ -0,0 +1,82 @@
+#include "mappedFile.h"
+#include "generalUtility.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#elif !defined(__ANDROID__) && !defined(__APPLE__)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace MV {
+
+	MappedFile::MappedFile(const std::string &a_path) {
+#if defined(__ANDROID__) || defined(__APPLE__)
+		readContents(a_path);
+#else
+		auto path = filePathInSearchPaths(a_path);
+		if (path.empty()) {
+			return;
+		}
+	#if defined(_WIN32)
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return;
+		}
+		LARGE_INTEGER fileSize;
+		HANDLE fileMapping = nullptr;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+			fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+		//the mapping keeps the file open on its own.
+		CloseHandle(file);
+		if (!fileMapping) {
+			return;
+		}
+		mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(fileMapping);
+		if (mapping) {
+			bytes = static_cast<const char*>(mapping);
+			length = static_cast<size_t>(fileSize.QuadPart);
+		}
+	#else
+		int file = open(path.c_str(), O_RDONLY);
+		if (file < 0) {
+			return;
+		}
+		struct stat status;
+		if (fstat(file, &status) == 0 && status.st_size > 0) {
+			void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			if (view != MAP_FAILED) {
+				mapping = view;
+				bytes = static_cast<const char*>(view);
+				length = static_cast<size_t>(status.st_size);
+			}
+		}
+		close(file);
+	#endif
+		if (!mapping) {
+			//mapping can fail on unusual file systems, a plain read still works there.
+			readContents(a_path);
+		}
+#endif
+	}
+
+	MappedFile::~MappedFile() {
+		if (mapping) {
+#if defined(_WIN32)
+			UnmapViewOfFile(mapping);
+#elif !defined(__ANDROID__) && !defined(__APPLE__)
+			munmap(mapping, length);
+#endif
+		}
+	}
+
+	void MappedFile::readContents(const std::string &a_path) {
+		contents = fileContents(a_path);
+		bytes = contents.data();
+		length = contents.size();
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef _MV_MAPPEDFILE_H_
+#define _MV_MAPPEDFILE_H_
+
+#include <string>
+
+namespace MV {
+	//Read only view of a whole file, found through the same search paths as fileContents. Desktop builds map the file
+	//into memory so it is paged in as it is read, Android and Apple builds read through SDL into a buffer instead since
+	//packaged assets there aren't plain files.
+	class MappedFile {
+	public:
+		//empty() if the file is missing or can't be opened.
+		explicit MappedFile(const std::string &a_path);
+		~MappedFile();
+
+		const char* data() const {
+			return bytes;
+		}
+		size_t size() const {
+			return length;
+		}
+		bool empty() const {
+			return length == 0;
+		}
+
+	private:
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		void readContents(const std::string &a_path);
+
+		const char* bytes = nullptr;
+		size_t length = 0;
+		std::string contents;
+		void* mapping = nullptr;
+	};
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include "objectPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace MV {
+	namespace {
+		std::mutex& registryLock() {
+			static std::mutex* lock = new std::mutex();
+			return *lock;
+		}
+
+		std::vector<BlockPool*>& registry() {
+			static std::vector<BlockPool*>* pools = new std::vector<BlockPool*>();
+			return *pools;
+		}
+
+		//typeid names are already readable with MSVC, GCC and Clang mangle them.
+		std::string readableTypeName(const std::string &a_name) {
+#ifdef __GNUG__
+			int status = 0;
+			std::unique_ptr<char, void(*)(void*)> demangled(abi::__cxa_demangle(a_name.c_str(), nullptr, nullptr, &status), std::free);
+			if (status == 0 && demangled) {
+				return demangled.get();
+			}
+#endif
+			return a_name;
+		}
+	}
+
+	BlockPool::BlockPool(const std::string &a_typeName, const std::string &a_suffix, size_t a_blockSize, size_t a_alignment) :
+		name(readableTypeName(a_typeName) + a_suffix),
+		alignment(std::max(a_alignment, alignof(FreeBlock))) {
+		//every block has to hold a free list link and keep the next block aligned.
+		blockSize = std::max(a_blockSize, sizeof(FreeBlock));
+		blockSize = (blockSize + alignment - 1) / alignment * alignment;
+
+		std::lock_guard<std::mutex> guard(registryLock());
+		registry().push_back(this);
+	}
+
+	void* BlockPool::allocate() {
+		std::lock_guard<std::mutex> guard(lock);
+		void* result;
+		if (freeBlocks) {
+			result = freeBlocks;
+			freeBlocks = freeBlocks->next;
+			++recycled;
+		} else {
+			if (unusedBlocks == 0) {
+				grow();
+			}
+			result = unused;
+			unused += blockSize;
+			--unusedBlocks;
+		}
+		++allocations;
+		peak = std::max(peak, ++live);
+		return result;
+	}
+
+	void BlockPool::deallocate(void* a_block) {
+		if (!a_block) {
+			return;
+		}
+		std::lock_guard<std::mutex> guard(lock);
+		auto* block = static_cast<FreeBlock*>(a_block);
+		block->next = freeBlocks;
+		freeBlocks = block;
+		--live;
+	}
+
+	void BlockPool::grow() {
+		//padded so the first block can be aligned past what new[] guarantees.
+		const size_t bytes = blockSize * BlocksPerChunk + alignment;
+		chunks.push_back(std::make_unique<char[]>(bytes));
+		auto address = reinterpret_cast<std::uintptr_t>(chunks.back().get());
+		address = (address + alignment - 1) / alignment * alignment;
+		unused = reinterpret_cast<char*>(address);
+		unusedBlocks = BlocksPerChunk;
+	}
+
+	PoolStatistics BlockPool::statistics() const {
+		std::lock_guard<std::mutex> guard(lock);
+		PoolStatistics result;
+		result.name = name;
+		result.blockSize = blockSize;
+		result.live = live;
+		result.peak = peak;
+		result.allocations = allocations;
+		result.recycled = recycled;
+		result.chunks = chunks.size();
+		return result;
+	}
+
+	std::vector<PoolStatistics> poolStatistics() {
+		std::lock_guard<std::mutex> guard(registryLock());
+		std::vector<PoolStatistics> results;
+		results.reserve(registry().size());
+		for (auto&& pool : registry()) {
+			results.push_back(pool->statistics());
+		}
+		return results;
+	}
+}
@@ -0,0 +1,140 @@
+#ifndef _MV_OBJECTPOOL_H_
+#define _MV_OBJECTPOOL_H_
+
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <type_traits>
+#include <vector>
+
+namespace MV {
+	struct PoolStatistics {
+		std::string name;
+		size_t blockSize = 0;
+		//blocks handed out right now, and the most ever out at once.
+		size_t live = 0;
+		size_t peak = 0;
+		size_t allocations = 0;
+		//allocations served from a previously freed block rather than fresh chunk memory.
+		size_t recycled = 0;
+		size_t chunks = 0;
+	};
+
+	//Fixed size blocks carved out of larger chunks and recycled through a free list. Chunks are kept for the life of
+	//the program, so a long session settles into reusing the same memory instead of fragmenting the heap.
+	class BlockPool {
+	public:
+		static constexpr size_t BlocksPerChunk = 64;
+
+		//a_typeName is a typeid name, the pool is reported as its readable form followed by a_suffix.
+		BlockPool(const std::string &a_typeName, const std::string &a_suffix, size_t a_blockSize, size_t a_alignment);
+
+		void* allocate();
+		void deallocate(void* a_block);
+
+		PoolStatistics statistics() const;
+	private:
+		BlockPool(const BlockPool&) = delete;
+		BlockPool& operator=(const BlockPool&) = delete;
+
+		void grow();
+
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		mutable std::mutex lock;
+		std::string name;
+		size_t blockSize;
+		size_t alignment;
+		FreeBlock* freeBlocks = nullptr;
+		//blocks at the end of the newest chunk that have never been handed out.
+		char* unused = nullptr;
+		size_t unusedBlocks = 0;
+		std::vector<std::unique_ptr<char[]>> chunks;
+
+		size_t live = 0;
+		size_t peak = 0;
+		size_t allocations = 0;
+		size_t recycled = 0;
+	};
+
+	//every pool created so far, for profiling overlays and logs.
+	std::vector<PoolStatistics> poolStatistics();
+
+	//Standard allocator drawing single objects from a BlockPool per (T, Tag), usable with std::allocate_shared or the
+	//allocator argument of std::shared_ptr. Rebinding keeps the Tag, so a shared_ptr's control block gets a pool of its own
+	//named after the object it manages. Arrays fall back to the global heap.
+	template <typename T, typename Tag = T>
+	class PoolAllocator {
+	public:
+		typedef T value_type;
+
+		template <typename U>
+		struct rebind {
+			typedef PoolAllocator<U, Tag> other;
+		};
+
+		PoolAllocator() noexcept {}
+		template <typename U>
+		PoolAllocator(const PoolAllocator<U, Tag>&) noexcept {}
+
+		T* allocate(size_t a_count) {
+			if (a_count == 1) {
+				return static_cast<T*>(pool().allocate());
+			}
+			return static_cast<T*>(::operator new(a_count * sizeof(T)));
+		}
+
+		void deallocate(T* a_memory, size_t a_count) noexcept {
+			if (a_count == 1) {
+				pool().deallocate(a_memory);
+			} else {
+				::operator delete(a_memory);
+			}
+		}
+
+		static BlockPool& pool() {
+			//never destroyed, objects released during static destruction still have somewhere to go.
+			static BlockPool* instance = new BlockPool(typeid(Tag).name(), std::is_same<T, Tag>::value ? "" : " (control block)", sizeof(T), alignof(T));
+			return *instance;
+		}
+
+		template <typename U>
+		bool operator==(const PoolAllocator<U, Tag>&) const noexcept {
+			return true;
+		}
+		template <typename U>
+		bool operator!=(const PoolAllocator<U, Tag>&) const noexcept {
+			return false;
+		}
+	};
+
+	template <typename T>
+	struct PoolDeleter {
+		void operator()(T* a_object) const {
+			a_object->~T();
+			PoolAllocator<T>().deallocate(a_object, 1);
+		}
+	};
+
+	//For types whose constructor the caller can reach but std::allocate_shared can't: a_construct placement news a T into
+	//the memory it is given. The object and its control block both come from T's pools.
+	template <typename T, typename F>
+	std::shared_ptr<T> makePooled(const F &a_construct) {
+		PoolAllocator<T> allocator;
+		T* memory = allocator.allocate(1);
+		T* object = nullptr;
+		try {
+			object = a_construct(static_cast<void*>(memory));
+		} catch (...) {
+			allocator.deallocate(memory, 1);
+			throw;
+		}
+		return std::shared_ptr<T>(object, PoolDeleter<T>(), allocator);
+	}
+}
+
+#endif
@@ -2,9 +2,11 @@
 #define __MV_SIGNAL_H__
 
 #include <memory>
+#include <atomic>
 #include <utility>
 #include <functional>
 #include <vector>
+#include <array>
 #include <set>
 #include <string>
 #include <map>
@@ -18,9 +20,13 @@
 
 namespace MV {
 
+	template <typename T>
+	class Signal;
+
 	template <typename T>
 	class Receiver {
 		friend cereal::access;
+		friend Signal<T>;
 	public:
 		typedef std::function<T> FunctionType;
 		typedef std::shared_ptr<Receiver<T>> SharedType;
@@ -228,11 +234,15 @@ namespace MV {
 		MV::Script*scriptEnginePointer = nullptr;
 
 		int64_t id;
-		static int64_t uniqueId;
+		//atomic so nodes can be made from concurrent scene updates.
+		static std::atomic<int64_t> uniqueId;
+
+		//index of this receiver in the last Signal it was connected to, lets disconnect skip the search.
+		size_t signalSlot = 0;
 	};
 
 	template <typename T>
-	int64_t Receiver<T>::uniqueId = 0;
+	std::atomic<int64_t> Receiver<T>::uniqueId{ 0 };
 
 	template <typename T>
 	class Signal {
@@ -243,75 +253,126 @@ namespace MV {
 		typedef std::shared_ptr<Receiver<T>> SharedReceiverType;
 		typedef std::weak_ptr<Receiver<T>> WeakReceiverType;
 
+		//observers stored without allocating, most signals have none and very few have more than this.
+		static constexpr size_t InlineObservers = 2;
+
+		Signal() = default;
+		Signal(Signal<T> &&a_rhs) {
+			*this = std::move(a_rhs);
+		}
+		Signal(const Signal<T> &a_rhs) {
+			*this = a_rhs;
+		}
+		//the moved from signal is left empty, its count would otherwise point past observers it no longer has.
+		Signal<T>& operator=(Signal<T> &&a_rhs) {
+			if (this != &a_rhs) {
+				inlineObservers = std::move(a_rhs.inlineObservers);
+				overflowObservers = std::move(a_rhs.overflowObservers);
+				observerCount = a_rhs.observerCount;
+				needsCompaction = a_rhs.needsCompaction;
+				isBlocked = a_rhs.isBlocked;
+				calledWhileBlocked = a_rhs.calledWhileBlocked;
+				scriptEnginePointer = a_rhs.scriptEnginePointer;
+				details = std::move(a_rhs.details);
+
+				a_rhs.overflowObservers.clear();
+				a_rhs.observerCount = 0;
+				a_rhs.needsCompaction = false;
+				a_rhs.callDepth = 0;
+			}
+			return *this;
+		}
+		Signal<T>& operator=(const Signal<T> &a_rhs) {
+			if (this != &a_rhs) {
+				inlineObservers = a_rhs.inlineObservers;
+				overflowObservers = a_rhs.overflowObservers;
+				observerCount = a_rhs.observerCount;
+				needsCompaction = a_rhs.needsCompaction;
+				isBlocked = a_rhs.isBlocked;
+				calledWhileBlocked = a_rhs.calledWhileBlocked;
+				scriptEnginePointer = a_rhs.scriptEnginePointer;
+				details = a_rhs.details ? std::make_unique<Details>(*a_rhs.details) : nullptr;
+			}
+			return *this;
+		}
+
 		//No protection against duplicates.
 		[[nodiscard]]
 		std::shared_ptr<Receiver<T>> connect(std::function<T> a_callback){
 			auto signal = Receiver<T>::make(a_callback);
-			observers.insert(signal);
+			add(signal);
 			return signal;
 		}
 		[[nodiscard]]
 		std::shared_ptr<Receiver<T>> connect(const std::string &a_callback) {
-			auto signal = Receiver<T>::make(a_callback, scriptEnginePointer, orderedParameterNames);
-			observers.insert(signal);
+			auto signal = Receiver<T>::make(a_callback, scriptEnginePointer, details ? details->orderedParameterNames : nullptr);
+			add(signal);
 			return signal;
 		}
 
 		//Duplicate Receivers will not be added. If std::function ever becomes comparable this can all be much safer.
 		bool connect(std::shared_ptr<Receiver<T>> a_value){
-			observers.insert(a_value);
+			if (a_value && find(a_value) == observerCount) {
+				add(a_value);
+			}
 			return true;
 		}
 
 		//Add owned connections. Note: these should be disconnected via ID instead of by the receiver.
 		std::shared_ptr<Receiver<T>> connect(const std::string &a_id, std::function<T> a_callback) {
-			return ownedConnections[a_id] = connect(a_callback);
+			return ownedDetails().ownedConnections[a_id] = connect(a_callback);
 		}
 		std::shared_ptr<Receiver<T>> connect(const std::string &a_id, const std::string &a_scriptCallback) {
-			return ownedConnections[a_id] = connect(a_scriptCallback);
+			return ownedDetails().ownedConnections[a_id] = connect(a_scriptCallback);
 		}
 
 		std::shared_ptr<Receiver<T>> connection(const std::string &a_id) {
-			auto foundConnection = ownedConnections.find(a_id);
-			if (foundConnection != ownedConnections.end()) {
-				return foundConnection->second;
+			if (details) {
+				auto foundConnection = details->ownedConnections.find(a_id);
+				if (foundConnection != details->ownedConnections.end()) {
+					return foundConnection->second;
+				}
 			}
 			return SharedReceiverType();
 		}
 
 		void disconnect(std::shared_ptr<Receiver<T>> a_value){
 			if(a_value){
-				if(!inCall){
-					observers.erase(a_value);
-				} else {
-					disconnectQueue.insert(a_value);
+				auto index = find(a_value);
+				if (index < observerCount) {
+					remove(index);
 				}
 			}
 		}
 
 		bool connected(const std::string &a_id) {
-			return ownedConnections.find(a_id) != ownedConnections.end();
+			return details && details->ownedConnections.find(a_id) != details->ownedConnections.end();
 		}
 
 		void disconnect(const std::string &a_id) {
-			auto connectionToRemove = ownedConnections.find(a_id);
-			if (connectionToRemove != ownedConnections.end()) {
-				disconnect(connectionToRemove->second);
-				ownedConnections.erase(connectionToRemove);
+			if (details) {
+				auto connectionToRemove = details->ownedConnections.find(a_id);
+				if (connectionToRemove != details->ownedConnections.end()) {
+					disconnect(connectionToRemove->second);
+					details->ownedConnections.erase(connectionToRemove);
+				}
 			}
 		}
 
 		void clearObservers(){
-			ownedConnections.clear();
-			if (!inCall) {
-				observers.clear();
-			}else{
-				disconnectQueue.clear();
-				for (auto&& observer : observers) {
-					if (auto lockedObserver = observer.lock()) {
-						disconnectQueue.insert(lockedObserver);
-					}
+			if (details) {
+				details->ownedConnections.clear();
+			}
+			if (callDepth == 0) {
+				inlineObservers = {};
+				overflowObservers.clear();
+				observerCount = 0;
+				needsCompaction = false;
+			} else {
+				for (size_t i = 0; i < observerCount; ++i) {
+					observer(i).reset();
 				}
+				needsCompaction = true;
 			}
 		}
 
@@ -339,85 +400,58 @@ namespace MV {
 			return isBlocked != 0;
 		}
 
+		bool empty() const {
+			return observerCount == 0;
+		}
+
 		template <typename ...Arg>
 		void operator()(Arg &&... a_parameters){
-			if (!blocked()) {
-				inCall = true;
-				SCOPE_EXIT{
-					inCall = false;
-					for (auto&& i : disconnectQueue) {
-						observers.erase(i);
-					}
-					disconnectQueue.clear();
-				};
-
-				for (auto i = observers.begin(); !observers.empty() && i != observers.end();) {
-					if (auto lockedI = i->lock()) {
-						auto next = i;
-						++next;
-						lockedI->notify(std::forward<Arg>(a_parameters)...);
-						i = next;
-					} else {
-						observers.erase(i++);
-					}
-				}
+			if (observerCount == 0 && isBlocked == 0) {
+				return;
 			}
+			dispatch([&](Receiver<T> &a_receiver) { a_receiver.notify(std::forward<Arg>(a_parameters)...); });
 
 			if (blocked()) {
 				calledWhileBlocked = true;
-				if (blockedCallback) {
-					blockedCallback(std::forward<Arg>(a_parameters)...);
+				if (details && details->blockedCallback) {
+					details->blockedCallback(std::forward<Arg>(a_parameters)...);
 				}
 			}
 		}
 
 		template <typename ...Arg>
 		void operator()(){
-			if (!blocked()) {
-				inCall = true;
-				SCOPE_EXIT{
-					inCall = false;
-					for (auto&& i : disconnectQueue) {
-						observers.erase(i);
-					}
-					disconnectQueue.clear();
-				};
-
-				for (auto i = observers.begin(); i != observers.end();) {
-					if (auto lockedI = i->lock()) {
-						auto next = i;
-						++next;
-						lockedI->notify();
-						i = next;
-					} else {
-						observers.erase(i++);
-					}
-				}
+			if (observerCount == 0 && isBlocked == 0) {
+				return;
 			}
+			dispatch([&](Receiver<T> &a_receiver) { a_receiver.notify(); });
 
 			if (blocked()){
 				calledWhileBlocked = true;
-				if (blockedCallback) {
-					blockedCallback();
+				if (details && details->blockedCallback) {
+					details->blockedCallback();
 				}
 			}
 		}
 
 		size_t cullDeadObservers(){
-			for(auto i = observers.begin();!observers.empty() && i != observers.end();) {
-				if(i->expired()) {
-					observers.erase(i++);
-				} else {
-					++i;
+			if (callDepth == 0) {
+				compact();
+				return observerCount;
+			}
+			size_t live = 0;
+			for (size_t i = 0; i < observerCount; ++i) {
+				if (!observer(i).expired()) {
+					++live;
 				}
 			}
-			return observers.size();
+			return live;
 		}
 
 		Signal<T>& scriptEngine(MV::Script *a_scriptEngine) {
 			scriptEnginePointer = a_scriptEngine;
-			for (auto&& observer : observers) {
-				if (auto lockedObserver = observer.lock()) {
+			for (size_t i = 0; i < observerCount; ++i) {
+				if (auto lockedObserver = observer(i).lock()) {
 					lockedObserver->scriptEngine(a_scriptEngine);
 				}
 			}
@@ -429,33 +463,151 @@ namespace MV {
 
 		//Supplied to the Receivers which are spawned.
 		Signal<T>& parameterNames(const std::vector<std::string> &a_orderedParameterNames){
-			orderedParameterNames = a_orderedParameterNames.empty() ? nullptr : std::make_shared<std::vector<std::string>>(a_orderedParameterNames);
+			if (details || !a_orderedParameterNames.empty()) {
+				ownedDetails().orderedParameterNames = a_orderedParameterNames.empty() ? nullptr : std::make_shared<std::vector<std::string>>(a_orderedParameterNames);
+			}
 			return *this;
 		}
 
 		std::vector<std::string> parameterNames() const{
-			return orderedParameterNames ? *orderedParameterNames : std::vector<std::string>();
+			return (details && details->orderedParameterNames) ? *details->orderedParameterNames : std::vector<std::string>();
 		}
 
 		bool hasParameterNames() const{
-			return !orderedParameterNames->empty();
+			return details && details->orderedParameterNames && !details->orderedParameterNames->empty();
 		}
 
 	private:
+		//rarely used state lives behind one pointer so unobserved signals stay small.
+		struct Details {
+			std::map<std::string, SharedReceiverType> ownedConnections;
+			std::shared_ptr<std::vector<std::string>> orderedParameterNames;
+			std::function<T> blockedCallback;
+		};
+
+		Details& ownedDetails() {
+			if (!details) {
+				details = std::make_unique<Details>();
+			}
+			return *details;
+		}
+
+		WeakReceiverType& observer(size_t a_index) {
+			return a_index < InlineObservers ? inlineObservers[a_index] : overflowObservers[a_index - InlineObservers];
+		}
+		const WeakReceiverType& observer(size_t a_index) const {
+			return a_index < InlineObservers ? inlineObservers[a_index] : overflowObservers[a_index - InlineObservers];
+		}
+
+		static bool sameReceiver(const WeakReceiverType &a_lhs, const SharedReceiverType &a_rhs) {
+			return !a_lhs.owner_before(a_rhs) && !a_rhs.owner_before(a_lhs);
+		}
+
+		void add(const SharedReceiverType &a_value) {
+			a_value->signalSlot = observerCount;
+			if (observerCount < InlineObservers) {
+				inlineObservers[observerCount] = a_value;
+			} else {
+				overflowObservers.push_back(a_value);
+			}
+			++observerCount;
+		}
+
+		//the receiver remembers where it was added, only a receiver shared between signals falls back to a search.
+		size_t find(const SharedReceiverType &a_value) const {
+			if (a_value->signalSlot < observerCount && sameReceiver(observer(a_value->signalSlot), a_value)) {
+				return a_value->signalSlot;
+			}
+			for (size_t i = 0; i < observerCount; ++i) {
+				if (sameReceiver(observer(i), a_value)) {
+					return i;
+				}
+			}
+			return observerCount;
+		}
+
+		//swaps the last observer into a_index, while dispatching the slot is only emptied so indices stay put.
+		void remove(size_t a_index) {
+			if (callDepth > 0) {
+				observer(a_index).reset();
+				needsCompaction = true;
+				return;
+			}
+			size_t last = observerCount - 1;
+			if (a_index != last) {
+				observer(a_index) = std::move(observer(last));
+				if (auto moved = observer(a_index).lock()) {
+					moved->signalSlot = a_index;
+				}
+			}
+			popObserver();
+		}
+
+		void popObserver() {
+			--observerCount;
+			if (observerCount < InlineObservers) {
+				inlineObservers[observerCount].reset();
+			} else {
+				overflowObservers.pop_back();
+			}
+		}
+
+		void compact() {
+			needsCompaction = false;
+			size_t kept = 0;
+			for (size_t i = 0; i < observerCount; ++i) {
+				if (auto lockedObserver = observer(i).lock()) {
+					lockedObserver->signalSlot = kept;
+					if (kept != i) {
+						observer(kept) = std::move(observer(i));
+					}
+					++kept;
+				}
+			}
+			while (observerCount > kept) {
+				popObserver();
+			}
+		}
+
+		template <typename Notify>
+		void dispatch(Notify &&a_notify) {
+			if (!blocked()) {
+				++callDepth;
+				SCOPE_EXIT{
+					if (--callDepth == 0 && needsCompaction) {
+						compact();
+					}
+				};
+
+				//observers connected during the call are not notified until the next one.
+				for (size_t i = 0, end = observerCount; i < end; ++i) {
+					if (auto lockedI = observer(i).lock()) {
+						a_notify(*lockedI);
+					} else {
+						needsCompaction = true;
+					}
+				}
+			}
+		}
+
 		template <class Archive>
 		void save(Archive & archive, std::uint32_t const /*version*/) const {
 			std::vector< std::shared_ptr<Receiver<T>> > scriptObservers;
 			std::map<std::string, std::shared_ptr<Receiver<T>>> ownedScriptObservers;
-			for (auto&& observer : observers) {
-				if (!observer.expired() && observer.lock()->hasScript()) {
-					scriptObservers.emplace_back(observer);
+			for (size_t i = 0; i < observerCount; ++i) {
+				auto lockedObserver = observer(i).lock();
+				if (lockedObserver && lockedObserver->hasScript()) {
+					scriptObservers.emplace_back(lockedObserver);
 				}
 			}
-			for (auto&& observerKV : ownedConnections) {
-				if (observerKV.second->hasScript()) {
-					ownedScriptObservers[observerKV.first] = observerKV.second;
+			if (details) {
+				for (auto&& observerKV : details->ownedConnections) {
+					if (observerKV.second->hasScript()) {
+						ownedScriptObservers[observerKV.first] = observerKV.second;
+					}
 				}
 			}
+			std::shared_ptr<std::vector<std::string>> orderedParameterNames = details ? details->orderedParameterNames : nullptr;
 			archive(
 				cereal::make_nvp("parameterNames", orderedParameterNames),
 				cereal::make_nvp("observers", scriptObservers),
@@ -467,34 +619,36 @@ namespace MV {
 		void load(Archive & archive, std::uint32_t const /*version*/) {
 			std::vector< std::shared_ptr<Receiver<T>> > scriptObservers;
 			std::map<std::string, std::shared_ptr<Receiver<T>>> ownedScriptObservers;
+			std::shared_ptr<std::vector<std::string>> orderedParameterNames;
 			archive(
 				cereal::make_nvp("parameterNames", orderedParameterNames),
 				cereal::make_nvp("observers", scriptObservers),
 				cereal::make_nvp("ownedObservers", ownedScriptObservers)
 			);
+			if (orderedParameterNames) {
+				ownedDetails().orderedParameterNames = orderedParameterNames;
+			}
 			for (auto&& scriptObserver : scriptObservers) {
-				observers.insert(scriptObserver);
+				connect(scriptObserver);
 			}
 			for (auto&& ownedScriptObserver : ownedScriptObservers) {
-				ownedConnections[ownedScriptObserver.first] = ownedScriptObserver.second;
+				ownedDetails().ownedConnections[ownedScriptObserver.first] = ownedScriptObserver.second;
 			}
 			MV::Services& services = cereal::get_user_data<MV::Services>(archive);
 			scriptEnginePointer = services.get<MV::Script>(false);
 		}
 
-		std::set< std::weak_ptr< Receiver<T> >, std::owner_less<std::weak_ptr<Receiver<T>>> > observers;
-
-		bool inCall = false;
-		int isBlocked = 0;
-		std::function<T> blockedCallback;
-		std::set< std::shared_ptr<Receiver<T>> > disconnectQueue;
+		std::array<WeakReceiverType, InlineObservers> inlineObservers;
+		std::vector<WeakReceiverType> overflowObservers;
+		uint32_t observerCount = 0;
+		uint16_t callDepth = 0;
+		bool needsCompaction = false;
 		bool calledWhileBlocked = false;
-
-		std::shared_ptr<std::vector<std::string>> orderedParameterNames;
+		int isBlocked = 0;
 
 		MV::Script *scriptEnginePointer = nullptr;
 
-		std::map<std::string, SharedReceiverType> ownedConnections;
+		std::unique_ptr<Details> details;
 	};
 
 	//Can be used as a public SignalRegister member for connecting signals to a private Signal member.
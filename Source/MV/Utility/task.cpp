@@ -8,6 +8,7 @@
 #include "cereal/types/polymorphic.hpp"
 
 #include "cereal/archives/portable_binary.hpp"
+#include "MV/Serialization/sceneArchive.h"
 #include "cereal/archives/json.hpp"
 
 CEREAL_REGISTER_TYPE(MV::BasicAction);
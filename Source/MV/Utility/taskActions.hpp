@@ -2,6 +2,7 @@
 #define _MV_TASK_ACTIONS_H_
 
 #include "task.h"
+#include "MV/Serialization/sceneArchive.h"
 
 namespace MV {
 	class BlockForSeconds : public ActionBase {
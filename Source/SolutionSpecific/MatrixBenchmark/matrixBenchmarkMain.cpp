@@ -0,0 +1,239 @@
+#include "MV/Render/matrix.hpp"
+#include "MV/Utility/stopwatch.h"
+
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_inverse.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+//Usage:
+//	MatrixBenchmark [-iterations N] [-points N] [-seed N]
+//Times TransformMatrix multiply, inverse and batched point transforms against GLM and a plain scalar loop.
+//Every case also checks its results against the scalar reference so a broken SIMD path can't look fast.
+
+namespace {
+	struct Options {
+		int iterations = 1000000;
+		size_t points = 4096;
+		uint32_t seed = 1337;
+	};
+
+	//keeps the optimizer from discarding benchmark loops whose results are otherwise unused.
+	volatile float sink = 0.0f;
+
+	MV::TransformMatrix randomMatrix(std::mt19937 &a_random) {
+		std::uniform_real_distribution<float> value(.2f, 5.0f);
+		MV::TransformMatrix result;
+		for (size_t x = 0; x < 4; ++x) {
+			for (size_t y = 0; y < 4; ++y) {
+				result(x, y) = value(a_random);
+			}
+		}
+		return result;
+	}
+
+	glm::mat4x4 toGlm(const MV::TransformMatrix &a_matrix) {
+		glm::mat4x4 result;
+		for (int x = 0; x < 4; ++x) {
+			for (int y = 0; y < 4; ++y) {
+				result[x][y] = a_matrix(x, y);
+			}
+		}
+		return result;
+	}
+
+	MV::TransformMatrix scalarMultiply(const MV::TransformMatrix &a_lhs, const MV::TransformMatrix &a_rhs) {
+		MV::TransformMatrix result;
+		for (size_t n = 0; n < 4; ++n) {
+			for (size_t p = 0; p < 4; ++p) {
+				float sum = 0.0f;
+				for (size_t m = 0; m < 4; ++m) {
+					sum += a_lhs(m, n) * a_rhs(p, m);
+				}
+				result(p, n) = sum;
+			}
+		}
+		return result;
+	}
+
+	float largestDifference(const MV::TransformMatrix &a_lhs, const MV::TransformMatrix &a_rhs) {
+		float result = 0.0f;
+		for (size_t x = 0; x < 4; ++x) {
+			for (size_t y = 0; y < 4; ++y) {
+				result = std::max(result, std::abs(a_lhs(x, y) - a_rhs(x, y)) / std::max(1.0f, std::abs(a_rhs(x, y))));
+			}
+		}
+		return result;
+	}
+
+	void report(const std::string &a_name, double a_seconds, size_t a_operations, float a_error = -1.0f) {
+		std::cout << std::left << std::setw(24) << ("[" + a_name + "]") << std::right << std::fixed << std::setprecision(3)
+			<< " total: " << std::setw(9) << a_seconds * 1000.0 << "ms"
+			<< " ns/op: " << std::setw(8) << (a_seconds * 1000000000.0) / static_cast<double>(std::max<size_t>(a_operations, 1));
+		if (a_error >= 0.0f) {
+			std::cout << " max error: " << std::scientific << std::setprecision(2) << a_error;
+		}
+		std::cout << "\n";
+	}
+
+	template <typename F>
+	double time(const F &a_function) {
+		MV::Stopwatch timer;
+		timer.start();
+		a_function();
+		return timer.stop();
+	}
+
+	Options parseOptions(int argc, char *argv[]) {
+		Options options;
+		for (int i = 1; i + 1 < argc; i += 2) {
+			std::string flag = argv[i];
+			if (flag == "-iterations") {
+				options.iterations = std::max(1, std::atoi(argv[i + 1]));
+			} else if (flag == "-points") {
+				options.points = static_cast<size_t>(std::max(1, std::atoi(argv[i + 1])));
+			} else if (flag == "-seed") {
+				options.seed = static_cast<uint32_t>(std::atoi(argv[i + 1]));
+			} else {
+				std::cerr << "Unknown argument: " << flag << "\n";
+			}
+		}
+		return options;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	auto options = parseOptions(argc, argv);
+	std::mt19937 random(options.seed);
+
+#if MV_MATRIX_SSE
+	std::cout << "TransformMatrix path: SSE\n";
+#elif MV_MATRIX_NEON
+	std::cout << "TransformMatrix path: NEON\n";
+#else
+	std::cout << "TransformMatrix path: scalar\n";
+#endif
+	std::cout << "iterations: " << options.iterations << " points: " << options.points << " seed: " << options.seed << "\n\n";
+
+	//multiply, chained against a fixed right hand side the way a world transform accumulates.
+	const auto lhs = randomMatrix(random);
+	const auto rhs = randomMatrix(random) * (1.0f / 10.0f);
+	{
+		auto result = lhs;
+		auto elapsed = time([&]() {
+			for (int i = 0; i < options.iterations; ++i) {
+				result = result * rhs;
+				result(3, 3) = 1.0f;
+			}
+		});
+		sink = sink + result(0, 0);
+		report("MV multiply", elapsed, options.iterations, largestDifference(lhs * rhs, scalarMultiply(lhs, rhs)));
+	}
+	{
+		auto result = lhs;
+		auto elapsed = time([&]() {
+			for (int i = 0; i < options.iterations; ++i) {
+				result = scalarMultiply(result, rhs);
+				result(3, 3) = 1.0f;
+			}
+		});
+		sink = sink + result(0, 0);
+		report("scalar multiply", elapsed, options.iterations);
+	}
+	{
+		auto result = toGlm(lhs);
+		const auto glmRhs = toGlm(rhs);
+		auto elapsed = time([&]() {
+			for (int i = 0; i < options.iterations; ++i) {
+				result = result * glmRhs;
+				result[3][3] = 1.0f;
+			}
+		});
+		sink = sink + result[0][0];
+		report("GLM multiply", elapsed, options.iterations);
+	}
+	std::cout << "\n";
+
+	//inverse, alternating between a matrix and its inverse so the values stay bounded.
+	{
+		auto result = lhs;
+		auto elapsed = time([&]() {
+			for (int i = 0; i < options.iterations; ++i) {
+				result = MV::inverse(result);
+			}
+		});
+		sink = sink + result(0, 0);
+		report("MV inverse", elapsed, options.iterations, largestDifference(lhs * MV::inverse(lhs), MV::TransformMatrix()));
+	}
+	{
+		auto result = toGlm(lhs);
+		auto elapsed = time([&]() {
+			for (int i = 0; i < options.iterations; ++i) {
+				result = glm::inverse(result);
+			}
+		});
+		sink = sink + result[0][0];
+		report("GLM inverse", elapsed, options.iterations);
+	}
+	std::cout << "\n";
+
+	//batched points, the shape Node::worldFromLocal and friends see for vertex and bounds lists.
+	std::uniform_real_distribution<float> coordinate(-1000.0f, 1000.0f);
+	std::vector<MV::Point<>> points(options.points);
+	for (auto&& point : points) {
+		point = MV::Point<>(coordinate(random), coordinate(random), coordinate(random));
+	}
+	const int pointPasses = std::max(1, static_cast<int>(static_cast<size_t>(options.iterations) / points.size()));
+	const size_t pointOperations = static_cast<size_t>(pointPasses) * points.size();
+	std::vector<std::array<MV::PointPrecision, 4>> batched(points.size());
+	{
+		auto elapsed = time([&]() {
+			for (int pass = 0; pass < pointPasses; ++pass) {
+				MV::fullMatrixPointMultiply(lhs, points.data(), batched.data(), points.size());
+				sink = sink + batched[pass % batched.size()][3];
+			}
+		});
+		float error = 0.0f;
+		for (size_t i = 0; i < points.size(); ++i) {
+			auto single = MV::fullMatrixPointMultiply(lhs, points[i]);
+			for (size_t component = 0; component < 4; ++component) {
+				error = std::max(error, std::abs(batched[i][component] - single[component]) / std::max(1.0f, std::abs(single[component])));
+			}
+		}
+		report("MV batched points", elapsed, pointOperations, error);
+	}
+	{
+		auto elapsed = time([&]() {
+			for (int pass = 0; pass < pointPasses; ++pass) {
+				for (size_t i = 0; i < points.size(); ++i) {
+					batched[i] = MV::fullMatrixPointMultiply(lhs, points[i]);
+				}
+				sink = sink + batched[pass % batched.size()][3];
+			}
+		});
+		report("MV single points", elapsed, pointOperations);
+	}
+	{
+		const auto glmLhs = toGlm(lhs);
+		std::vector<glm::vec4> glmResults(points.size());
+		auto elapsed = time([&]() {
+			for (int pass = 0; pass < pointPasses; ++pass) {
+				for (size_t i = 0; i < points.size(); ++i) {
+					glmResults[i] = glmLhs * glm::vec4(points[i].x, points[i].y, points[i].z, 1.0f);
+				}
+				sink = sink + glmResults[pass % glmResults.size()][3];
+			}
+		});
+		report("GLM points", elapsed, pointOperations);
+	}
+
+	return 0;
+}
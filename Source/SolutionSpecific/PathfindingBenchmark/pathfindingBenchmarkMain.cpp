@@ -0,0 +1,308 @@
+//Note: BINDSTONE_SERVER is actually a project-wide define, but we put it manually in here for VS Intellisense to work.
+#ifndef BINDSTONE_SERVER
+#define BINDSTONE_SERVER
+#endif
+#include "Game/managers.h"
+#include "Game/Instance/gameInstance.h"
+#include "MV/ArtificialIntelligence/pathfinding.h"
+#include "MV/ArtificialIntelligence/pathScenario.h"
+#include "MV/Render/Scene/path.h"
+#include "MV/Serialization/serialize.h"
+#include "MV/Utility/stopwatch.h"
+#include "MV/Utility/scopeGuard.hpp"
+
+#include <SDL.h>
+
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+
+//Usage:
+//	PathfindingBenchmark [scenario.json] [-iterations N]
+//	PathfindingBenchmark -generate seed scenario.json
+//Without a scenario a seeded match-like scenario is generated in memory so runs are comparable.
+//BindstoneGameServer -recordPaths directory records real matches in the same format.
+
+namespace {
+	std::atomic<size_t> totalAllocations{ 0 };
+}
+
+void* operator new(size_t a_size) {
+	++totalAllocations;
+	if (void* result = std::malloc(a_size ? a_size : 1)) {
+		return result;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* a_memory) noexcept {
+	std::free(a_memory);
+}
+
+void operator delete(void* a_memory, size_t) noexcept {
+	std::free(a_memory);
+}
+
+class Samples {
+public:
+	Samples(const std::string &a_name) : name(a_name) {}
+
+	void add(double a_seconds, size_t a_allocations, int64_t a_nodes = 0) {
+		seconds.push_back(a_seconds);
+		allocations += a_allocations;
+		nodes += a_nodes;
+	}
+
+	double total() const {
+		double result = 0.0;
+		for (auto&& sample : seconds) {
+			result += sample;
+		}
+		return result;
+	}
+
+	double percentile(double a_percent) const {
+		if (seconds.empty()) {
+			return 0.0;
+		}
+		auto sorted = seconds;
+		std::sort(sorted.begin(), sorted.end());
+		auto index = static_cast<size_t>(a_percent * static_cast<double>(sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	void report(std::ostream &a_stream) const {
+		auto count = static_cast<double>(std::max<size_t>(seconds.size(), 1));
+		a_stream << std::left << std::setw(18) << ("[" + name + "]") << std::right << std::fixed << std::setprecision(3)
+			<< " samples: " << std::setw(7) << seconds.size()
+			<< " per sec: " << std::setw(11) << (total() > 0.0 ? static_cast<double>(seconds.size()) / total() : 0.0)
+			<< " p50: " << std::setw(8) << percentile(.5) * 1000.0 << "ms"
+			<< " p99: " << std::setw(8) << percentile(.99) * 1000.0 << "ms"
+			<< " nodes/sample: " << std::setw(9) << static_cast<double>(nodes) / count
+			<< " allocs/sample: " << std::setw(9) << static_cast<double>(allocations) / count << "\n";
+	}
+
+private:
+	std::string name;
+	std::vector<double> seconds;
+	size_t allocations = 0;
+	int64_t nodes = 0;
+};
+
+template <typename F>
+void measure(Samples &a_samples, const F &a_function) {
+	MV::Stopwatch timer;
+	auto allocationsBefore = totalAllocations.load();
+	timer.start();
+	int64_t nodes = a_function();
+	auto elapsed = timer.stop();
+	a_samples.add(elapsed, totalAllocations.load() - allocationsBefore, nodes);
+}
+
+MV::Point<int> gridFromNode(const std::shared_ptr<MV::Scene::PathMap> &a_pathMap, const std::shared_ptr<MV::Scene::Node> &a_node) {
+	return MV::cast<int>(a_pathMap->gridFromLocal(a_pathMap->owner()->localFromWorld(a_node->worldFromLocal(MV::Point<>()))));
+}
+
+MV::Point<int> openCellNear(const std::shared_ptr<MV::Map> &a_map, const MV::Point<int> &a_position, int a_size, std::mt19937 &a_random) {
+	std::uniform_int_distribution<int> offset(-6, 6);
+	for (int attempt = 0; attempt < 32; ++attempt) {
+		auto candidate = a_position + MV::Point<int>(offset(a_random), offset(a_random));
+		if (a_map->clearedForSize(candidate, a_size)) {
+			return candidate;
+		}
+	}
+	return a_position;
+}
+
+//Creatures stream from both wells toward the other while buildings go up and come down mid-map.
+MV::PathScenario generateScenario(const std::shared_ptr<MV::Scene::Node> &a_world, const std::shared_ptr<MV::Scene::PathMap> &a_pathMap, uint32_t a_seed) {
+	MV::PathScenario scenario;
+	std::mt19937 random(a_seed);
+	auto map = a_pathMap->grid();
+	auto leftWell = gridFromNode(a_pathMap, a_world->get("leftGoal"));
+	auto rightWell = gridFromNode(a_pathMap, a_world->get("rightGoal"));
+	auto gridSize = map->size();
+	std::uniform_int_distribution<int> blockX(gridSize.width / 4, gridSize.width * 3 / 4);
+	std::uniform_int_distribution<int> blockY(0, gridSize.height - 3);
+
+	const int creatureSize = 3;
+	for (int tick = 0; tick < scenario.ticks; tick += 15) {
+		bool fromLeft = (tick / 15) % 2 == 0;
+		MV::PathScenarioEvent spawn;
+		spawn.tick = tick;
+		spawn.type = MV::PathScenarioEvent::SPAWN;
+		spawn.size = creatureSize;
+		spawn.position = openCellNear(map, fromLeft ? leftWell : rightWell, creatureSize, random);
+		spawn.goal = fromLeft ? rightWell : leftWell;
+		scenario.events.push_back(spawn);
+
+		if (tick % 120 == 0) {
+			MV::PathScenarioEvent block;
+			block.tick = tick;
+			block.type = MV::PathScenarioEvent::BLOCK;
+			block.size = 3;
+			block.position = { blockX(random), blockY(random) };
+			scenario.events.push_back(block);
+
+			auto unblock = block;
+			unblock.tick = tick + 600;
+			unblock.type = MV::PathScenarioEvent::UNBLOCK;
+			if (unblock.tick < scenario.ticks) {
+				scenario.events.push_back(unblock);
+			}
+		}
+	}
+	std::stable_sort(scenario.events.begin(), scenario.events.end(), [](const MV::PathScenarioEvent &a_lhs, const MV::PathScenarioEvent &a_rhs) {
+		return a_lhs.tick < a_rhs.tick;
+	});
+	return scenario;
+}
+
+void forEachCell(const std::shared_ptr<MV::Map> &a_map, const MV::PathScenarioEvent &a_event, const std::function<void(MV::MapNode&)> &a_action) {
+	for (int x = a_event.position.x; x < a_event.position.x + a_event.size; ++x) {
+		for (int y = a_event.position.y; y < a_event.position.y + a_event.size; ++y) {
+			if (a_map->inBounds({ x, y })) {
+				a_action(a_map->get({ x, y }));
+			}
+		}
+	}
+}
+
+//Isolated searches between every spawn and its goal on the unoccupied map.
+void benchmarkSearches(const std::shared_ptr<MV::Map> &a_map, const MV::PathScenario &a_scenario, int a_iterations, std::ostream &a_stream) {
+	Samples searches("Path::calculate");
+	for (int i = 0; i < a_iterations; ++i) {
+		for (auto&& event : a_scenario.events) {
+			if (event.type == MV::PathScenarioEvent::SPAWN) {
+				measure(searches, [&]() {
+					MV::Path path(a_map, event.position, event.goal, 0.0f, event.size);
+					path.path();
+					return path.nodesSearched();
+				});
+			}
+		}
+	}
+	searches.report(a_stream);
+}
+
+//Static blocks ripple clearance updates out to neighbouring cells.
+void benchmarkClearance(const std::shared_ptr<MV::Map> &a_map, const MV::PathScenario &a_scenario, int a_iterations, std::ostream &a_stream) {
+	Samples blocks("Clearance block");
+	Samples unblocks("Clearance unblock");
+	a_map->initializeCells();
+	for (int i = 0; i < a_iterations; ++i) {
+		for (auto&& event : a_scenario.events) {
+			if (event.type == MV::PathScenarioEvent::BLOCK) {
+				measure(blocks, [&]() {
+					forEachCell(a_map, event, [](MV::MapNode &a_node) { a_node.staticBlock(); });
+					return int64_t(0);
+				});
+				measure(unblocks, [&]() {
+					forEachCell(a_map, event, [](MV::MapNode &a_node) { a_node.staticUnblock(); });
+					return int64_t(0);
+				});
+			}
+		}
+	}
+	blocks.report(a_stream);
+	unblocks.report(a_stream);
+}
+
+//Full replay with the game's path settings, agents interact with each other and the changing map.
+void benchmarkReplay(const std::shared_ptr<MV::Scene::PathMap> &a_pathMap, const MV::PathScenario &a_scenario, std::ostream &a_stream) {
+	a_pathMap->pathBudget(GameInstance::PathSearchBudget)->pathCacheSize(GameInstance::PathCacheSize);
+	auto map = a_pathMap->grid();
+	Samples requestUpdates("Path requests");
+	Samples agentUpdates("Agent updates");
+	std::vector<std::shared_ptr<MV::NavigationAgent>> agents;
+	size_t arrived = 0;
+	auto nextEvent = a_scenario.events.begin();
+	for (int tick = 0; tick < a_scenario.ticks; ++tick) {
+		for (; nextEvent != a_scenario.events.end() && nextEvent->tick <= tick; ++nextEvent) {
+			if (nextEvent->type == MV::PathScenarioEvent::SPAWN) {
+				auto agent = MV::NavigationAgent::make(map, nextEvent->position, nextEvent->size)->steering(true);
+				agent->onArrive.connect("benchmark", [&](std::shared_ptr<MV::NavigationAgent>) { ++arrived; });
+				agent->goal(nextEvent->goal);
+				agents.push_back(agent);
+			} else if (nextEvent->type == MV::PathScenarioEvent::BLOCK) {
+				forEachCell(map, *nextEvent, [](MV::MapNode &a_node) { a_node.staticBlock(); });
+			} else if (map->inBounds(nextEvent->position) && map->get(nextEvent->position).staticallyBlocked()) {
+				forEachCell(map, *nextEvent, [](MV::MapNode &a_node) { a_node.staticUnblock(); });
+			}
+		}
+		measure(requestUpdates, [&]() {
+			map->requests().update();
+			return int64_t(0);
+		});
+		for (auto&& agent : agents) {
+			measure(agentUpdates, [&]() {
+				agent->update(a_scenario.timeStep);
+				return int64_t(0);
+			});
+		}
+		agents.erase(std::remove_if(agents.begin(), agents.end(), [](const std::shared_ptr<MV::NavigationAgent> &a_agent) {
+			return !a_agent->pathfinding();
+		}), agents.end());
+	}
+	requestUpdates.report(a_stream);
+	agentUpdates.report(a_stream);
+	auto& cacheStats = map->pathCache().statistics();
+	a_stream << "Replay: " << arrived << " arrived, " << agents.size() << " still travelling after " << a_scenario.ticks << " ticks. "
+		<< "Path cache hits: " << cacheStats.hits << " splices: " << cacheStats.splices << " misses: " << cacheStats.misses << "\n";
+}
+
+int main(int argc, char *argv[]) {
+	std::vector<std::string> arguments(argv + 1, argv + argc);
+	std::string scenarioFile;
+	std::string generateFile;
+	uint32_t seed = 1;
+	int iterations = 5;
+	for (size_t i = 0; i < arguments.size(); ++i) {
+		if (arguments[i] == "-iterations" && i + 1 < arguments.size()) {
+			iterations = std::max(std::stoi(arguments[++i]), 1);
+		} else if (arguments[i] == "-generate" && i + 2 < arguments.size()) {
+			seed = static_cast<uint32_t>(std::stoul(arguments[++i]));
+			generateFile = arguments[++i];
+		} else {
+			scenarioFile = arguments[i];
+		}
+	}
+
+	Managers managers({ "", "" });
+	managers.renderer.makeHeadless().window().windowedMode().allowUserResize(false);
+	if (!managers.renderer.initialize(MV::Size<int>(960, 640), MV::Size<>(960, 640))) {
+		return 1;
+	}
+	SCOPE_EXIT{ SDL_Quit(); };
+
+	MV::PathScenario scenario;
+	if (!scenarioFile.empty()) {
+		scenario = MV::fromJson<MV::PathScenario>(MV::fileContents(scenarioFile, true));
+	}
+
+	auto root = MV::Scene::Node::make(managers.renderer);
+	auto world = root->make(scenario.scene, managers.services);
+	auto pathMap = world->get("PathMap")->component<MV::Scene::PathMap>();
+	auto pristineMap = pathMap->grid()->snapshot();
+
+	if (scenarioFile.empty()) {
+		scenario = generateScenario(world, pathMap.self(), seed);
+		if (!generateFile.empty()) {
+			MV::writeToFile(generateFile, MV::toJson(scenario));
+			std::cout << "Wrote scenario [" << generateFile << "] with " << scenario.events.size() << " events.\n";
+			return 0;
+		}
+	}
+
+	std::cout << "Scene: " << scenario.scene << " grid: " << pathMap->gridSize().width << "x" << pathMap->gridSize().height
+		<< " events: " << scenario.events.size() << " iterations: " << iterations << "\n";
+	benchmarkSearches(pristineMap, scenario, iterations, std::cout);
+	benchmarkClearance(pristineMap->snapshot(), scenario, iterations, std::cout);
+	benchmarkReplay(pathMap.self(), scenario, std::cout);
+	return 0;
+}
@@ -0,0 +1,122 @@
+//Note: BINDSTONE_SERVER is actually a project-wide define, but we put it manually in here for VS Intellisense to work.
+#ifndef BINDSTONE_SERVER
+#define BINDSTONE_SERVER
+#endif
+#include "Game/managers.h"
+#include "MV/Physics/package.h"
+#include "MV/Serialization/serialize.h"
+#include "MV/Utility/stopwatch.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+//Usage:
+//	SceneConverter -input <directory> -output <directory>
+//Converts every JSON .scene and .prefab under -input to a scene archive at the same relative path under -output.
+//Converted files keep their names, Node::load tells the formats apart by their contents. Files that are already archives
+//are copied across unchanged. Each archive is loaded back and compared against the JSON, a type that doesn't round trip
+//is removed from -output and fails the build.
+
+namespace {
+	struct Options {
+		std::string input = "Assets";
+		std::string output;
+	};
+
+	Options parseOptions(int argc, char *argv[]) {
+		Options options;
+		for (int i = 1; i + 1 < argc; i += 2) {
+			std::string flag = argv[i];
+			if (flag == "-input") {
+				options.input = argv[i + 1];
+			} else if (flag == "-output") {
+				options.output = argv[i + 1];
+			} else {
+				std::cerr << "Unknown argument: " << flag << "\n";
+			}
+		}
+		return options;
+	}
+
+	bool isSceneFile(const boost::filesystem::path &a_path) {
+		auto extension = a_path.extension().string();
+		return extension == ".scene" || extension == ".prefab";
+	}
+
+	template <typename F>
+	double time(const F &a_function) {
+		MV::Stopwatch timer;
+		timer.start();
+		a_function();
+		return timer.stop();
+	}
+
+	//returns false if the file couldn't be converted.
+	bool convert(Managers &a_managers, const boost::filesystem::path &a_source, const boost::filesystem::path &a_destination) {
+		auto json = MV::fileContents(a_source.string());
+		if (MV::isSceneArchive(json.data(), json.size())) {
+			//still belongs in the converted tree, so it ships with the rest.
+			std::cerr << "Already converted, copying: " << a_source.string() << "\n";
+			return a_source == a_destination || MV::writeToFile(a_destination.string(), json);
+		}
+
+		std::shared_ptr<MV::Scene::Node> node;
+		auto jsonSeconds = time([&]() { node = MV::Scene::Node::load(a_source.string(), a_managers.services, false); });
+		auto archive = MV::toSceneArchive(node);
+
+		if (!MV::writeToFile(a_destination.string(), archive)) {
+			return false;
+		}
+
+		//through the same mapped path the game uses.
+		std::shared_ptr<MV::Scene::Node> reloaded;
+		auto archiveSeconds = time([&]() { reloaded = MV::Scene::Node::loadBinary(a_destination.string(), a_managers.services, false); });
+		if (MV::toJson(reloaded) != MV::toJson(node)) {
+			std::cerr << "Round trip mismatch: " << a_source.string() << "\n";
+			boost::filesystem::remove(a_destination);
+			return false;
+		}
+		std::cout << std::left << std::setw(64) << a_source.string() << std::right << std::fixed << std::setprecision(2)
+			<< " json: " << std::setw(8) << json.size() / 1024.0 << "KB " << std::setw(7) << jsonSeconds * 1000.0 << "ms"
+			<< " archive: " << std::setw(8) << archive.size() / 1024.0 << "KB " << std::setw(7) << archiveSeconds * 1000.0 << "ms\n";
+		return true;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	auto options = parseOptions(argc, argv);
+	if (options.output.empty()) {
+		std::cerr << "Usage: SceneConverter -input <directory> -output <directory>\n";
+		return 1;
+	}
+	auto input = boost::filesystem::absolute(options.input);
+	auto output = boost::filesystem::absolute(options.output);
+	if (!boost::filesystem::is_directory(input)) {
+		std::cerr << "Input directory not found: " << input.string() << "\n";
+		return 1;
+	}
+
+	Managers managers({ "", "" });
+	MV::initializeSpineBindings();
+
+	int failures = 0;
+	for (auto&& entry : boost::filesystem::recursive_directory_iterator(input)) {
+		if (!boost::filesystem::is_regular_file(entry.path()) || !isSceneFile(entry.path())) {
+			continue;
+		}
+		auto destination = output / boost::filesystem::relative(entry.path(), input);
+		try {
+			if (!convert(managers, entry.path(), destination)) {
+				++failures;
+			}
+		} catch (std::exception &e) {
+			std::cerr << "Failed to convert " << entry.path().string() << ": " << e.what() << "\n";
+			++failures;
+		}
+	}
+	return failures == 0 ? 0 : 1;
+}